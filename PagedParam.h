@@ -137,6 +137,11 @@ class PagedParam
       return cur_val_;
     }
 
+    uint8_t Page()
+    {
+      return page_;
+    }
+
   private:
     bool locked_, midi_locked_, changed_;
     float thresh_, init_val_, cur_val_, min_, max_, range_;
@@ -0,0 +1,169 @@
+#pragma once
+#ifndef DSY_CPU_GOVERNOR_H
+#define DSY_CPU_GOVERNOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#ifdef __cplusplus
+
+// Callback load (0 to 1) that steps quality down, and that the load has to stay under to step back up
+#define GOV_HIGH	0.85f
+#define GOV_LOW		0.6f
+// Seconds after a step down before the next, about as long as a smoothed load takes to show what the step saved
+#define GOV_SETTLE	0.25f
+// Seconds the load has to stay under the low threshold before each step back up
+#define GOV_RECOVER	2.0f
+#define GOV_MAX_RUNGS	8
+// Steps kept for the main loop to log, a power of 2
+#define GOV_LOG_SIZE	16
+
+namespace daisysp
+{
+// What each rung of the ladder gives up, see modal_engine::SetGovernor
+typedef enum {
+  GOV_PRECISION = 0,	// low modes back in plain float
+  GOV_MODES,		// half of each voice's modes
+  GOV_CONTROL,		// half the modulation control rate
+  GOV_VOICES,		// one voice
+  GOV_LAST
+} gov_rung;
+
+typedef struct {
+  uint32_t block;	// blocks since Reset
+  float load;		// the load that made the step
+  uint8_t level;	// rungs taken after the step
+  uint8_t rung;		// the rung stepped onto or back off
+  bool down;		// true for a step down in quality
+} gov_event;
+
+/*
+ * cpu_governor
+ *
+ * Walks a ladder of quality reductions by the audio callback's load, once per block.
+ * Above the high threshold it takes the next rung, waits GOV_SETTLE for the load to follow,
+ * and takes another if it is still too high. Only after the load has stayed under the low
+ * threshold for GOV_RECOVER does it give a rung back, the last taken first, so a patch that
+ * only just fits doesn't flap between two levels.
+ *
+ * The ladder is any sequence of gov_rungs, a rung can appear more than once.
+ * The governor only decides the level, its owner applies it, see Taken.
+ * Steps are also queued for the main loop, see Pop.
+ */
+class cpu_governor
+{
+  public:
+    // cr is the rate Update is called at, blocks per second
+    void Init(float cr)
+    {
+      static const uint8_t ladder[] = {GOV_PRECISION, GOV_MODES, GOV_CONTROL, GOV_VOICES, GOV_VOICES};
+      settle_blocks_ = (int)(GOV_SETTLE * cr);
+      recover_blocks_ = (int)(GOV_RECOVER * cr);
+      SetLadder(ladder, sizeof(ladder));
+      SetThresholds(GOV_HIGH, GOV_LOW);
+      Reset();
+    }
+
+    // Rungs in the order they are taken, at most GOV_MAX_RUNGS. Starts again from full quality
+    void SetLadder(const uint8_t *rungs, int n)
+    {
+      n_rungs_ = n < GOV_MAX_RUNGS ? n : GOV_MAX_RUNGS;
+      for (int i = 0; i < n_rungs_; i++) {
+	ladder_[i] = rungs[i] < GOV_LAST ? rungs[i] : (uint8_t)GOV_PRECISION;
+      }
+      Reset();
+    }
+
+    void SetThresholds(float high, float low)
+    {
+      high_ = high;
+      low_ = low < high ? low : high;
+    }
+
+    void Reset()
+    {
+      level_ = 0;
+      block_ = 0;
+      settle_ = recover_ = 0;
+      read_ = write_.load(std::memory_order_relaxed);
+    }
+
+    /*
+     * The last block's load, as a fraction of the time the block lasts.
+     * True if the level has changed
+     */
+    bool Update(float load)
+    {
+      block_++;
+      if (settle_ > 0) settle_--;
+      if (load > high_) {
+	recover_ = 0;
+	if (settle_ > 0 || level_ == n_rungs_) return false;
+	Step(true, load);
+	settle_ = settle_blocks_;
+	return true;
+      }
+      if (load >= low_ || level_ == 0) {
+	recover_ = 0;
+	return false;
+      }
+      if (++recover_ < recover_blocks_) return false;
+      recover_ = 0;
+      Step(false, load);
+      return true;
+    }
+
+    // Rungs taken
+    int Level() const { return level_; }
+    int Rungs() const { return n_rungs_; }
+
+    // How many times rung is taken at the current level
+    int Taken(int rung) const
+    {
+      int count = 0;
+      for (int i = 0; i < level_; i++) {
+	count += ladder_[i] == rung;
+      }
+      return count;
+    }
+
+    // Main loop side. The oldest step not yet read, false if there are none
+    bool Pop(gov_event &e)
+    {
+      uint32_t write = write_.load(std::memory_order_acquire);
+      if (read_ == write) return false;
+      // Steps overwritten before they were read are lost
+      if (write - read_ > GOV_LOG_SIZE) read_ = write - GOV_LOG_SIZE;
+      e = log_[read_ & (GOV_LOG_SIZE - 1)];
+      read_++;
+      return true;
+    }
+
+  private:
+    void Step(bool down, float load)
+    {
+      if (!down) level_--;
+      gov_event &e = log_[write_.load(std::memory_order_relaxed) & (GOV_LOG_SIZE - 1)];
+      e.block = block_;
+      e.load = load;
+      e.rung = ladder_[level_];
+      e.down = down;
+      if (down) level_++;
+      e.level = level_;
+      write_.fetch_add(1, std::memory_order_release);
+    }
+
+    uint8_t ladder_[GOV_MAX_RUNGS];
+    int n_rungs_ = 0, level_ = 0;
+    float high_ = GOV_HIGH, low_ = GOV_LOW;
+    int settle_blocks_ = 0, recover_blocks_ = 0;
+    int settle_ = 0, recover_ = 0;
+    uint32_t block_ = 0;
+
+    gov_event log_[GOV_LOG_SIZE];
+    std::atomic<uint32_t> write_{0};
+    uint32_t read_ = 0;
+};
+} // namespace daisysp
+#endif
+#endif
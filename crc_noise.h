@@ -3,12 +3,18 @@
 namespace daisysp
 {
 
+  /*
+   * On the Seed the STM32 CRC peripheral does the work.
+   * Host builds use a software CRC with the same polynomial, init value and bit order
+   * so the sequence for a given seed matches the hardware.
+   */
   class crc_noise
   {
     public:
       crc_noise() {}
       ~crc_noise() {}
 
+#ifdef __arm__
       void Init()
       {
   	__HAL_RCC_CRC_CLK_ENABLE();
@@ -23,10 +29,33 @@ namespace daisysp
 	CRC->DR = seed_;
       }
 
+      // Start from a known seed for repeatable output
+      void Init(uint32_t seed)
+      {
+  	__HAL_RCC_CRC_CLK_ENABLE();
+
+	seed_ = seed;
+	CRC->POL = NOISE_POLY;
+	CRC->CR |= CRC_CR_RESET;
+	CRC->DR = seed_;
+      }
+#else
+      void Init(uint32_t seed = 1)
+      {
+	seed_ = seed;
+	crc_ = 0xFFFFFFFF;
+	Crc(seed_);
+      }
+#endif
+
       float Process(uint8_t i)
       {
+#ifdef __arm__
 	CRC->DR = i;
 	rand_ = CRC->DR;
+#else
+	rand_ = Crc(i);
+#endif
 
 	// take the lower 16 bits and convert to a float
 	frand_ = (2.0 * ((float(rand_ & 0x0000FFFF) / 65535.0f) - 0.5));
@@ -35,8 +64,12 @@ namespace daisysp
 
       float Process()
       {
+#ifdef __arm__
 	CRC->DR = (uint32_t)frand_;
 	rand_ = CRC->DR;
+#else
+	rand_ = Crc((uint32_t)frand_);
+#endif
 
 	// take the lower 16 bits and convert to a float
 	frand_ = (2.0 * ((float(rand_ & 0x0000FFFF) / 65535.0f) - 0.5));
@@ -45,7 +78,21 @@ namespace daisysp
 
     private:
       uint32_t rand_, seed_;
-      float    frand_;
+      float    frand_ = 0;
+#ifdef __arm__
       RNG_HandleTypeDef hrng;
+#else
+      uint32_t crc_;
+
+      // MSB first, 32 bit input word - matches the CRC unit's reset configuration
+      uint32_t Crc(uint32_t data)
+      {
+	crc_ ^= data;
+	for (int b = 0; b < 32; b++) {
+	  crc_ = (crc_ & 0x80000000) ? (crc_ << 1) ^ NOISE_POLY : (crc_ << 1);
+	}
+	return crc_;
+      }
+#endif
   };
 }
@@ -0,0 +1,65 @@
+#pragma once
+#ifndef DSY_DENORMAL_H
+#define DSY_DENORMAL_H
+
+#include <stdint.h>
+#include <string.h>
+#if defined(__SSE__)
+#include <xmmintrin.h>
+#endif
+#ifdef __cplusplus
+
+// Tiny offset that keeps decaying resonator state out of the subnormal range, well below audibility
+#define DENORMAL_OFFSET 1e-20f
+
+namespace daisysp
+{
+/*
+ * denormal_guard
+ *
+ * Flushes subnormal floats to zero for as long as it is in scope, then restores the old mode.
+ * x86: MXCSR FTZ and DAZ. ARM: FPSCR FZ.
+ * The mode is per thread (per exception context on the M7), so the guard belongs in the
+ * function running the audio, not in setup code.
+ */
+class denormal_guard
+{
+  public:
+    denormal_guard()
+    {
+#if defined(__SSE__)
+      saved_ = _mm_getcsr();
+      _mm_setcsr(saved_ | 0x8040); // FTZ | DAZ
+#elif defined(__arm__) && defined(__ARM_FP)
+      asm volatile("vmrs %0, fpscr" : "=r"(saved_));
+      uint32_t fpscr = saved_ | (1 << 24); // FZ
+      asm volatile("vmsr fpscr, %0" : : "r"(fpscr));
+#endif
+    }
+
+    ~denormal_guard()
+    {
+#if defined(__SSE__)
+      _mm_setcsr(saved_);
+#elif defined(__arm__) && defined(__ARM_FP)
+      asm volatile("vmsr fpscr, %0" : : "r"(saved_));
+#endif
+    }
+
+    denormal_guard(const denormal_guard &) = delete;
+    denormal_guard &operator=(const denormal_guard &) = delete;
+
+  private:
+    uint32_t saved_ = 0;
+};
+
+// By bit pattern so it still answers correctly with DAZ set
+inline bool is_subnormal(float x)
+{
+  uint32_t u;
+  memcpy(&u, &x, sizeof(u));
+  return (u & 0x7f800000) == 0 && (u & 0x007fffff) != 0;
+}
+} // namespace daisysp
+#endif
+#endif
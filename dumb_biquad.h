@@ -44,7 +44,7 @@ class dumb_biquad
     {
       b[0] = b0;
       b[1] = b1;
-      b[3] = b2;
+      b[2] = b2;
     }
 
   protected:
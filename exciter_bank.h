@@ -0,0 +1,192 @@
+#pragma once
+#ifndef DSY_EXCITER_BANK_H
+#define DSY_EXCITER_BANK_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include "arm_math.h"
+#ifdef __cplusplus
+
+// "MXB1" little endian
+#define EXC_MAGIC	0x3142584d
+#define EXC_MAX		64
+// Interpolator phases per sample and taps per phase
+#define EXC_PHASES	32
+#define EXC_TAPS	4
+#define EXC_PHASE_BITS	5
+// Slowest and fastest a transient is played, relative to its own rate
+#define EXC_RATE_MIN	0.125f
+#define EXC_RATE_MAX	4.0f
+
+namespace daisysp
+{
+/*
+ * Bank layout, as tools/wav_to_exciters.py writes it, all little endian:
+ *   exciter_header
+ *   count exciter_entrys
+ *   int16 samples, offsets count from here
+ */
+typedef struct {
+  uint32_t magic;
+  uint32_t count;
+  float fs;		// rate the transients were recorded at
+  uint32_t reserved;
+} exciter_header;
+
+typedef struct {
+  uint32_t offset, length;	// in samples
+  float root;		// pitch the transient has as recorded, 0 if it isn't pitched
+  float gain;		// scales the int16 samples, the tool normalises every transient to unit energy
+} exciter_entry;
+
+/*
+ * exciter_bank
+ *
+ * Short recorded transients (strikes, bow and breath onsets) for the SAMPLE mode.
+ * The bank only points into memory laid out as above: flash, QSPI, SDRAM or a mapped file,
+ * nothing is copied and nothing is allocated.
+ */
+class exciter_bank
+{
+  public:
+    // False, and an empty bank, if blob isn't a whole bank
+    bool Attach(const void *blob, size_t size)
+    {
+      count_ = 0;
+      if (size < sizeof(exciter_header)) return false;
+      const exciter_header *h = (const exciter_header *)blob;
+      if (h->magic != EXC_MAGIC || h->count == 0 || h->count > EXC_MAX || !(h->fs > 0)) return false;
+      size_t head = sizeof(exciter_header) + h->count * sizeof(exciter_entry);
+      if (size < head) return false;
+      const exciter_entry *e = (const exciter_entry *)(h + 1);
+      size_t samples = (size - head) / sizeof(int16_t);
+      for (uint32_t i = 0; i < h->count; i++) {
+	if (e[i].offset > samples || e[i].length > samples - e[i].offset) return false;
+      }
+      fs_ = h->fs;
+      entries_ = e;
+      data_ = (const int16_t *)((const uint8_t *)blob + head);
+      count_ = h->count;
+      return true;
+    }
+
+    int Count() const { return count_; }
+    float Rate() const { return fs_; }
+    const exciter_entry &Entry(int i) const { return entries_[i]; }
+    const int16_t *Samples(int i) const { return data_ + entries_[i].offset; }
+
+  private:
+    const exciter_entry *entries_ = nullptr;
+    const int16_t *data_ = nullptr;
+    int count_ = 0;
+    float fs_ = 48000;
+};
+
+/*
+ * Windowed sinc interpolation taps, EXC_TAPS for each of EXC_PHASES fractional positions,
+ * shared by every voice's exciter_voice. Each phase sums to 1
+ */
+class exciter_kernel
+{
+  static_assert((1 << EXC_PHASE_BITS) == EXC_PHASES, "EXC_PHASE_BITS must match EXC_PHASES");
+
+  public:
+    void Init()
+    {
+      for (int p = 0; p < EXC_PHASES; p++) {
+	float frac = (float)p / EXC_PHASES;
+	float sum = 0;
+	for (int k = 0; k < EXC_TAPS; k++) {
+	  // Taps sit at -1 .. 2 around the sample before the read position
+	  float x = (k - (EXC_TAPS / 2 - 1)) - frac;
+	  float sinc = x == 0 ? 1 : sinf(PI * x) / (PI * x);
+	  float w = 0.5f + 0.5f * cosf(PI * x / (EXC_TAPS / 2));
+	  taps[p][k] = sinc * w;
+	  sum += taps[p][k];
+	}
+	for (int k = 0; k < EXC_TAPS; k++) {
+	  taps[p][k] /= sum;
+	}
+      }
+    }
+
+    float taps[EXC_PHASES][EXC_TAPS];
+};
+
+/*
+ * exciter_voice
+ *
+ * One voice's playhead through a transient, resampled by a 32.32 fixed point step
+ * through the polyphase exciter_kernel. There's no anti-aliasing when a transient is
+ * sped up beyond the kernel's own roll off, the voice's input filter follows it
+ */
+class exciter_voice
+{
+  public:
+    void Stop()
+    {
+      samples_ = nullptr;
+      len_ = 0;
+    }
+
+    bool Playing() const { return samples_ != nullptr; }
+
+    /*
+     * Start transient i of bank for a note at fc Hz, at output rate fs.
+     * Pitched transients are moved from their root to fc, within EXC_RATE_MIN .. EXC_RATE_MAX
+     */
+    void Start(const exciter_bank &bank, int i, float fc, float fs)
+    {
+      const exciter_entry &e = bank.Entry(i);
+      float pitch = e.root > 0 && fc > 0 ? fc / e.root : 1;
+      pitch = CLAMP(pitch, EXC_RATE_MIN, EXC_RATE_MAX);
+      double step = (double)pitch * bank.Rate() / fs;
+      step_ = (uint64_t)(step * 4294967296.0);
+      pos_ = 0;
+      samples_ = bank.Samples(i);
+      len_ = e.length;
+      gain_ = e.gain;
+    }
+
+    // n samples of excitation into out, zeros once the transient has ended
+    void Process(const exciter_kernel &kernel, float *out, size_t n)
+    {
+      size_t i = 0;
+      for (; i < n && samples_; i++) {
+	int32_t idx = (int32_t)(pos_ >> 32);
+	const float *t = kernel.taps[(uint32_t)pos_ >> (32 - EXC_PHASE_BITS)];
+	int32_t first = idx - (EXC_TAPS / 2 - 1);
+	float acc = 0;
+	if (first >= 0 && first + EXC_TAPS <= (int32_t)len_) {
+	  const int16_t *s = samples_ + first;
+	  for (int k = 0; k < EXC_TAPS; k++) {
+	    acc += t[k] * s[k];
+	  }
+	} else {
+	  // Either end, taps off the transient read silence
+	  for (int k = 0; k < EXC_TAPS; k++) {
+	    int32_t j = first + k;
+	    if (j >= 0 && j < (int32_t)len_) acc += t[k] * samples_[j];
+	  }
+	}
+	out[i] = acc * gain_;
+	pos_ += step_;
+	if (first >= (int32_t)len_) {
+	  Stop();
+	}
+      }
+      for (; i < n; i++) {
+	out[i] = 0;
+      }
+    }
+
+  private:
+    const int16_t *samples_ = nullptr;
+    uint32_t len_ = 0;
+    uint64_t pos_ = 0, step_ = 0;
+    float gain_ = 0;
+};
+} // namespace daisysp
+#endif
+#endif
@@ -0,0 +1,208 @@
+#pragma once
+#ifndef DSY_EXCITER_BLOB_H
+#define DSY_EXCITER_BLOB_H
+
+#include "exciter_bank.h"
+
+#ifdef __cplusplus
+
+// Where the bank is placed, define before including to move it
+#ifndef EXCITER_MEM_SECTION
+#define EXCITER_MEM_SECTION
+#endif
+
+/*
+ * Generated by tools/wav_to_exciters.py - don't edit
+ * 3 transients at 48000 Hz:
+ *   0 strike, 480 samples, unpitched
+ *   1 bow, 960 samples, 220 Hz
+ *   2 breath, 1440 samples, unpitched
+ */
+
+// An exciter bank, attach with exciter_bank::Attach(exciter_blob, sizeof(exciter_blob))
+const uint32_t exciter_blob[1456] EXCITER_MEM_SECTION = {
+  0x3142584d, 0x00000003, 0x473b8000, 0x00000000, 0x00000000, 0x000001e0, 0x00000000, 0x36c8ef9e,
+  0x000001e0, 0x000003c0, 0x435c0000, 0x361c3274, 0x000005a0, 0x000005a0, 0x00000000, 0x36417314,
+  0x280e8001, 0x7e9f95a6, 0xf980e492, 0x57592698, 0x7ae7cd07, 0x2a66e1fc, 0xdfff1ff5, 0x2500f1b5,
+  0x5e80cd7c, 0x567ed1b8, 0x48fa4816, 0x53a59a6c, 0xdd21b84a, 0x1b7522d5, 0xaf562c04, 0xd99be2b9,
+  0x2d23c750, 0xe5982ada, 0xf04a42eb, 0x4e104e39, 0x6f21be9b, 0xf392bc76, 0x9afe4eab, 0x477647a5,
+  0xaac6c0ca, 0xcb3dddf7, 0x108dae92, 0x487e6497, 0xb73dd429, 0xc656f6d1, 0x52b64a00, 0xc7d31ecf,
+  0x52ff1d74, 0x506f02e6, 0x1c5d1cb0, 0x0c6a4c8b, 0x4839043b, 0xcfabbf24, 0xebedbec6, 0xd2672e9b,
+  0xe7644451, 0x2c563e3d, 0xca1736ba, 0x0265ca3c, 0xe2c93201, 0xdee8106c, 0x36122285, 0x0120bef0,
+  0xe2ade4fa, 0x035a26fb, 0xeaaeebad, 0xf43c24fa, 0x328efaf9, 0x324c1085, 0x1726e555, 0xdf2d20d5,
+  0xe4dae546, 0x14b723b4, 0xf01b2704, 0x252ff39d, 0xd2ccf3bc, 0x014f314a, 0x0c2e2e46, 0xe0ccd360,
+  0x20131461, 0x1c35dc60, 0xdd772358, 0x0bd9ef27, 0x1b682946, 0x0407183e, 0x03ab0319, 0xec4be6ea,
+  0xe2391b3f, 0x1723f6d3, 0x0243e52e, 0xf81ff2a0, 0xf7e4e833, 0x01ce1985, 0xfa0ce3c2, 0x1c52ed3e,
+  0x1c18fde6, 0xf867076d, 0x0116f211, 0xfddf0be3, 0xfa72eead, 0xf0421249, 0x10b7113e, 0xe5dd1900,
+  0xebb50b77, 0xeb5bf582, 0x12260cc4, 0x179b06fd, 0xe769eff1, 0x0afaf6e0, 0xea32f454, 0xf5daed8a,
+  0x02aa08a1, 0x0be80fb6, 0x0cd909d1, 0xf7480b09, 0x118d05bf, 0xeaa30af4, 0x042cf088, 0xf8350d90,
+  0x0a8df4e0, 0x010812bf, 0x03c208a1, 0xee85058a, 0x08aff545, 0x12020ad5, 0xf8cdf3e2, 0x078d0bf5,
+  0xfdf80155, 0x0ca00ca1, 0xf3a60ff5, 0x082ff438, 0xf7a40b69, 0xf12cf885, 0xf602fe03, 0xfdf0fe5b,
+  0x0de6043a, 0x029b0053, 0xf6cff34f, 0xf4d80a11, 0xfb2e0176, 0x05a6fe78, 0xf367faab, 0xfb2efb6c,
+  0xf5d7f52c, 0x079d0075, 0x021a02fd, 0x0391fcd1, 0x09ecfa42, 0xfd7bf55e, 0x0554fccc, 0x064efa9c,
+  0x05b2fee5, 0xf685fa0f, 0x03890079, 0xfed707db, 0xffe5fcab, 0xf6b3f9a9, 0xf8700939, 0xf9a9f96b,
+  0xfc0cf8c8, 0xfc76fb5b, 0xfbe9fcf3, 0x0386fbc6, 0xfd09fd3f, 0x03a004b5, 0x0677faca, 0x03d5fab4,
+  0x050603fa, 0xf90c0191, 0xfe77fbe5, 0x00070595, 0xfd27fc7e, 0xfc53066a, 0x0392fe3e, 0x0556f9f4,
+  0x0647fe5f, 0x04090011, 0x03e0fa1a, 0xfce904dc, 0x05c2ff20, 0x042504b2, 0xfc67fb1e, 0x04fbffe8,
+  0xffe40548, 0x02ce0227, 0xfe070505, 0x0122ffa4, 0x01f4fff0, 0xfd5d025b, 0x02900232, 0x03a00458,
+  0xff03fff2, 0xfce90123, 0xfbb3029e, 0x0394028f, 0x03f30013, 0xff04ffb2, 0xfc96fca7, 0x01f3003d,
+  0x008901fc, 0x029d02ec, 0xfe0300db, 0xfc83004f, 0x01e2ff6e, 0x02e902e3, 0x02af020b, 0x002f00f5,
+  0xff41020e, 0x02540064, 0x02400044, 0xfeeb0113, 0xff45016e, 0xfed500c9, 0xfe9e0041, 0xff5f0298,
+  0xff22021c, 0xfd830183, 0xfef80004, 0x0174fe9c, 0xfd9e01cd, 0xfea801db, 0x0259ff8f, 0x01fdfffe,
+  0xffdf022f, 0xfeb6016b, 0x01ecfe22, 0xfff201e8, 0x0196ffcf, 0xfed3fe66, 0xfecfff7f, 0xffa500d1,
+  0xffaa01d1, 0xfee50136, 0x0123fe8d, 0xfe49ff53, 0x011200e9, 0x000200a3, 0x01470058, 0xfea0003a,
+  0xff9bfff6, 0x00cafed2, 0xffde00a7, 0xff830137, 0x017200e6, 0xff78008f, 0x0030012d, 0xff85001c,
+  0x00ec0156, 0xff5e00e1, 0x008c002a, 0xfed3006f, 0x00c5ff9d, 0xff1aff9f, 0xffaf00dd, 0xffe8008d,
+  0xffd30000, 0xff29ffa6, 0xfef5ff4d, 0xfe6afe58, 0xfd9afdfd, 0xfd84fd90, 0xfcdffdb2, 0xfd2cfe25,
+  0xfd0dfc8a, 0xfc9dfd5b, 0xfd82fc82, 0xfb07fcea, 0xfa2cfb92, 0xfa70fb2f, 0xfa6bfaf8, 0xfd17fb11,
+  0xfb1afb76, 0xfa73fccc, 0xfbdcf8fb, 0xf94dfb39, 0xf92ff9b0, 0xfbf2fb79, 0xfc90f8f5, 0xf79afc96,
+  0xf9b2fc0d, 0xfbfbf858, 0xf796fc0b, 0xfafff73f, 0xfb72f75f, 0xfdf6f64d, 0xfcd8f7ec, 0xf977fae8,
+  0xf652fc58, 0xfe4df73d, 0xf782f8f8, 0xfe36fa90, 0xfe3ffd47, 0xfd03fddf, 0xffe9f79a, 0xfbc9fcaf,
+  0xffbdfa4e, 0x0097f61f, 0xf6cafa65, 0xff86f8d9, 0xf7ea01a6, 0xfa59faea, 0xf9290159, 0xfb6afa55,
+  0x0199f928, 0xfffaffec, 0x01c4fe83, 0xf9dcf9cc, 0x06330506, 0xf9c3fd62, 0xfccd056c, 0xfe9806f9,
+  0x04df0559, 0xfa2502c5, 0x055e0076, 0xff2b07c9, 0x0aabfe59, 0xfe25fc63, 0x0abb034b, 0xfc660af1,
+  0x07be0c81, 0x09f50772, 0x07fa0489, 0x0b8f0a3e, 0x00bd072d, 0x04b5031c, 0x05fe0d4f, 0x10070e08,
+  0x06f213aa, 0x07c106b4, 0x04a203d5, 0x06b116ce, 0x068403b4, 0x09640bdb, 0x0ac01301, 0x0e770fc8,
+  0x1b740ff2, 0x1110149c, 0x10520fc7, 0x13981733, 0x11ef100a, 0x198f11ee, 0x13331f25, 0x19ad1b3a,
+  0x19781e84, 0x21ce1c82, 0x1740185e, 0x15d41b2d, 0x21181dac, 0x2a4123bd, 0x169a19e0, 0x2c1d1fb5,
+  0x28631e06, 0x2a862616, 0x300a2703, 0x302030af, 0x1f722a9d, 0x1f1e2d07, 0x29c929ff, 0x33cc257e,
+  0x2e372fdd, 0x318f30bc, 0x2cb4350d, 0x2bb136a0, 0x3eee2566, 0xc0b6d6c9, 0xd078d818, 0xdd99c2d8,
+  0xd3c5d117, 0xde8bdcf5, 0xdf67d1f3, 0xdc76c726, 0xcc84d68d, 0xc7b2cb89, 0xd29fe1f3, 0xdff5db1d,
+  0xd803e256, 0xcca5d328, 0xd5efca9d, 0xdf47d4ce, 0xcc7cd685, 0xd875e027, 0xcecde7f1, 0xe1eccd5a,
+  0xd60fe254, 0xd31fd749, 0xd13bdf71, 0xe6e8ec00, 0xdc5cd2a6, 0xdeebe8ac, 0xea67e823, 0xda7bf250,
+  0xdad4edf8, 0xf54cd410, 0xe62bda03, 0xe330e7bd, 0xe81ff61a, 0xe6cbdc00, 0xddebf60e, 0xf211ea94,
+  0xd9f8f806, 0xe6f0f40f, 0xf328dab6, 0xf48ef326, 0xf186e2c5, 0xe5d2dc88, 0xf392ffb5, 0xf8d4ddb7,
+  0xe5c50140, 0x028af403, 0xe511f07b, 0xf335f78c, 0x0201ee61, 0xe794068b, 0xfc79e47d, 0x0834f6dc,
+  0xfcab0633, 0x03adf900, 0x0fe8ef89, 0x0fdbfd01, 0x0d75fc5b, 0x0d80fdc8, 0xf5d7ef86, 0x0d05efb9,
+  0xfc5b1a53, 0x0c2b0fe2, 0xfb5e12b2, 0x1da5f8d0, 0x1c25fdc9, 0x1a6e0760, 0x0df825d1, 0x0e99204d,
+  0x101afb04, 0x033fff8a, 0x145225f7, 0x1eea19c8, 0x2e9d19cd, 0x12f30440, 0x0ab521f9, 0x124a05a4,
+  0x354a2258, 0x28b4194b, 0x35522215, 0x0f15275f, 0x3f5c248c, 0x2b49406f, 0x43103eb2, 0x15492916,
+  0x189929a6, 0x3d063a73, 0x2344255f, 0x276d3285, 0x3c7c275f, 0x3af34b59, 0x32ae3d1b, 0x4a5a395a,
+  0x447332b0, 0x35f250c5, 0x42e944ae, 0x51a7498e, 0x42953a76, 0x2c942ba0, 0x4eb953e8, 0x66c76659,
+  0x624d6733, 0x4bc869bd, 0x54e53a7c, 0x3a9236e1, 0x4cde5973, 0x511a4393, 0x6fbf69ca, 0x73644796,
+  0x4d0d580f, 0x788352f1, 0xa4c88106, 0x862e9182, 0x89f0a7b4, 0x855ba470, 0xad2297b5, 0xaa14c0f6,
+  0x902f8ffc, 0xae8990bd, 0x9df78e21, 0xa9d7b6ca, 0xbefda149, 0x931e90a4, 0x9ba4c716, 0x98dda521,
+  0xca9f99df, 0xb209b5de, 0xb930b72b, 0xb72cd27a, 0xa246b1da, 0x9f03bf19, 0xa709c0ee, 0xa5d2bde2,
+  0xd5dab0bf, 0xd179a35a, 0xa4d8a748, 0xe4beb076, 0xc663dae7, 0xd2d7de8c, 0xe099b3d9, 0xcc60d580,
+  0xd3d9cf9a, 0xc05ac959, 0xcd2beb41, 0xf53cc2a9, 0xf1bdc9fe, 0xdfc2cf84, 0xc0adf603, 0xe809e850,
+  0xd2f9f435, 0xd11fcbb0, 0xc6a6fe72, 0xc849d2fe, 0xd615f58e, 0xda17d739, 0xdaaace08, 0xda9bf83f,
+  0xd7cd1014, 0xf5d8d935, 0x105deae8, 0xd677f64e, 0xef50f8cd, 0x0fe3eaf7, 0x0cbfed61, 0xec43eec2,
+  0xf0edfb11, 0xee830211, 0x21a80c60, 0x0f021352, 0x0acaefe8, 0x231f0797, 0x1d751c73, 0xfa101693,
+  0x00c02a9e, 0x08b1f2a3, 0x2d58f899, 0x29892a80, 0x08bc07e7, 0x31d81c17, 0x27813716, 0x2b213112,
+  0x3d1d0aca, 0x1f9d3aaa, 0x43c2283e, 0x214c353b, 0x1bad1d1c, 0x3ad32f54, 0x20b13011, 0x31603ef7,
+  0x2e213471, 0x15843dc6, 0x53b73119, 0x4c1540bf, 0x18ce2dc3, 0x4d5431f4, 0x4db654c3, 0x3d8d46f2,
+  0x59aa3427, 0x23494345, 0x55505743, 0x534a27de, 0x50b85876, 0x360a6618, 0x62795454, 0x55fc5112,
+  0x3005345d, 0x3e6864e5, 0x4e293b97, 0x3a6654b1, 0x6bea6bd2, 0x57ef3ef9, 0x68cb4ec9, 0x665f4a0d,
+  0x7fff5106, 0x483959c0, 0x7893660c, 0x592e4a49, 0x52d0674b, 0x68a57a49, 0x6adb624a, 0x9cc5832a,
+  0x8f1ea27c, 0x926da6f0, 0xb7d4a9c1, 0xbd349dfb, 0x912f94b0, 0xb6abc037, 0x8ccba840, 0xbf9cb033,
+  0x93b78db3, 0xc430adee, 0xac28bcd9, 0x9e4aa52d, 0xb2b3ad44, 0xb2ddc83c, 0xb65ac409, 0xbc94af8b,
+  0x9723ce18, 0xb382b6fa, 0xb7a6c3f0, 0xcacbbfb8, 0xaa45cb0e, 0xa2f6c228, 0xc1bfcde4, 0xe47da8a4,
+  0xd359a6fb, 0xe885d801, 0xd927c88e, 0xc790e364, 0xbf93c937, 0xf0c8b3e1, 0xd84fc847, 0xdbfde97e,
+  0xe76ceb81, 0xe779e475, 0xf72df2a2, 0xede1fa73, 0xe76de79d, 0xd8acc8c7, 0xf909daf0, 0xc7fae9c0,
+  0xe66fda0d, 0xdd4ee1d7, 0xe370ca21, 0xf4f2defd, 0xdaaf041d, 0xf8dee269, 0xd77003ee, 0xd5b4f546,
+  0xfd5702ac, 0x0f680fe8, 0xfde214b3, 0x06c21639, 0xeaf3f46e, 0x14dee85c, 0x054e0292, 0x1462f7f9,
+  0x1324e750, 0xf9d721d4, 0x0072ed48, 0x0354f81a, 0x2cff1b75, 0x07d1f3fa, 0x319c17bc, 0x118c05a5,
+  0x2b9d1adf, 0xfe26093c, 0x0ec60dd5, 0x0d65188d, 0x342b23f7, 0x13f81153, 0x04a42484, 0x390b1eee,
+  0x321f3260, 0x44ff27e6, 0x44da21b0, 0x3bf63bbd, 0x16331d78, 0x3b661096, 0x213129f5, 0x2fdc4f07,
+  0x47f03af0, 0x4eb630cc, 0x1a8a4fa4, 0x29261ef9, 0x2bd43d6c, 0x21c2527f, 0x5af45959, 0x5c7059bc,
+  0x58d02b26, 0x619f4bc3, 0x571756d3, 0x395a6973, 0x38ba4050, 0x359b3a7e, 0x370f41e5, 0x48ed6a42,
+  0x63324321, 0x375e75f0, 0x63a076fc, 0x553d6ce9, 0x71365298, 0x51147a18, 0x702764db, 0x4ac373bf,
+  0x772c461a, 0x73755f42, 0x58135aaf, 0x6f6853ce, 0xb2758fe5, 0x9801b026, 0xb81d8f14, 0xb91286bb,
+  0xaf69b2cb, 0x8a79bdfa, 0x95aab5ea, 0x8b4b8eae, 0x9081ab08, 0x9bb786c3, 0xb4cca100, 0xaad0c660,
+  0xc604b786, 0xbd36c0a3, 0xa4b3ab14, 0x9b92a328, 0xab389b0b, 0xa75fa70d, 0xa8b2cd56, 0xa0a2a807,
+  0xcf10d605, 0xd008c0b5, 0xa10fb321, 0xa5a0ce9b, 0xe3d9c84f, 0xe625debe, 0xc596b2d7, 0xd9eaaf19,
+  0xc343dcba, 0xe759e3ae, 0xbe32de00, 0xca45f0c2, 0xedecd0a4, 0xdaf6f501, 0xcce7b929, 0xc5eac14b,
+  0xe44ae24b, 0xc70bdd07, 0xf560dddc, 0xea1ec836, 0xd4b5da35, 0xebea01c9, 0xf5e0d6ba, 0xe5330344,
+  0xffe00000, 0xff26ff95, 0xfec5fee4, 0xfe83ff0f, 0xfeb2fe49, 0xfd8afdcc, 0xfec8fe89, 0xff230019,
+  0xff91fd7d, 0xffd400d3, 0xfebafdf5, 0x01cfff6e, 0x0139026f, 0xfd2b001e, 0xffd1fe36, 0x0398012c,
+  0xfff9ff81, 0xfccb008b, 0x0248fe67, 0x028b057c, 0xff50013b, 0xf97cfc83, 0xf9c7fb78, 0xf726f782,
+  0xf7f5f54c, 0xf729f8b6, 0xfa2bf36a, 0xfcaaf94f, 0x013dfcc0, 0x0722024b, 0x0e8b0b50, 0x0ac00b38,
+  0x09bc0f46, 0x028501f2, 0x0bfe078e, 0x05c50f99, 0x0a200816, 0x01de06f3, 0x0492fbbb, 0xfa88fb5e,
+  0x062e043a, 0xfca2074e, 0xfa46ff32, 0xfdbcf567, 0xf026f5d3, 0xff3af8a2, 0x0165098b, 0x03af013d,
+  0x09c20c50, 0x0a620cf2, 0x05000bbe, 0xfd0ff9f7, 0xf8eef8cf, 0xfd0cfaa3, 0xfec6fe7c, 0xebd1f485,
+  0xf9fef6cd, 0xfdf3fc67, 0x033afdaa, 0x0ee908b8, 0x013b0ca8, 0xfee9ffa9, 0xf473fa37, 0xe02de940,
+  0xf792f45e, 0xf4e0f8d2, 0x0901fabf, 0xfe350c51, 0x0321fd09, 0x008000aa, 0x09dd0ca0, 0xf64b0252,
+  0xfd6a04fe, 0xeb47f8bd, 0xed23ebc0, 0xfb01f55a, 0x0dc7feee, 0xecb6fc31, 0xee92e22d, 0xfe19f4cd,
+  0xef82f5fd, 0xf57ff7cc, 0xfdad0695, 0xe1d9f00f, 0xe86ad9d1, 0xeea7f068, 0xf19fef58, 0xe915e343,
+  0xf19deaec, 0xe811e0db, 0xd6a5def3, 0xde11ed37, 0xf07fe905, 0xe961e852, 0xea98e80f, 0xf870dcdc,
+  0xfb74fe8b, 0xf485e94c, 0xf375e381, 0x15300b40, 0x046e0e29, 0x02aa09e0, 0xf318fd7d, 0x05cc0b51,
+  0xff42f331, 0xf4d9ffdf, 0x08a2ed6c, 0xf525f9a0, 0x20f40c71, 0x2778264b, 0x246e1ae1, 0x0d672859,
+  0x1fc51d28, 0x09200e33, 0x0d8913dd, 0xfdba0b9d, 0xe4f1f5fc, 0xf63ff7ae, 0x18950fba, 0x052613ad,
+  0x04fe1df9, 0xf586019a, 0x14a2fa85, 0x093829fa, 0x08c3f604, 0x1bc60107, 0x017dfd01, 0x0e0d0bfe,
+  0xffa7074f, 0x10eb0430, 0x0aa61bc7, 0x005ff0eb, 0xe446ffc7, 0xdd69df85, 0xf1e7f0d8, 0xe5a0f114,
+  0xfd89d976, 0x07c6102a, 0x0cd1fd61, 0x115913b3, 0xf1e0f8cc, 0xcca2de08, 0x02b6dd5c, 0x1e470c3b,
+  0x1484f94c, 0x1c992384, 0xf3740b24, 0x10c9edb7, 0xfa520801, 0xe1e6e4a6, 0x0794fbdb, 0x0b7cf60a,
+  0x025dfc14, 0xede9f5a9, 0xddf4eeef, 0x0b03ed62, 0xf854efb7, 0xeb4cfec4, 0x06b6fb90, 0xfce80f7a,
+  0x0b70e8ae, 0x134f2165, 0x2a7b2daa, 0x309d2dd3, 0x137c2269, 0x05da1026, 0xf71bea1f, 0x0ab2f8bf,
+  0x37ee2778, 0x4ba24aa4, 0x40545c66, 0x4f8a4045, 0x4e2a5fff, 0x2e9247f2, 0x198d314e, 0x1ae7fa22,
+  0x2284256d, 0xf8230c68, 0x108e1390, 0x1168283b, 0x1c893030, 0x44343b98, 0x16473a26, 0x11b533b5,
+  0x0dca0b7c, 0x0e40fa8c, 0x430229ed, 0x0653212f, 0xf4d0df43, 0xd5afd129, 0xf8d7d590, 0x01051291,
+  0x1124196d, 0x1b8231e0, 0x12b9369e, 0x4b4933e8, 0x04912be9, 0x13dd012e, 0x0c0537f7, 0x36931958,
+  0x1fbe4c7a, 0xdaacf746, 0xdbf6e1a1, 0xde8dc87e, 0xbc3bd169, 0xf4c0edc1, 0xea640a30, 0xcdb0dd35,
+  0xf803ca00, 0xd92ef844, 0xe4d3ef3b, 0xfa8f11c4, 0x104402d1, 0xd179faf1, 0x09f6dbf1, 0xf988f0be,
+  0x20ce1a43, 0x062f38d8, 0x227df527, 0x5fe144f7, 0x7ea8754d, 0x48eb5248, 0x0bee45ce, 0x25ed1a1b,
+  0x596142e4, 0x52f3577e, 0x22a94dba, 0x08a1fd96, 0x1966277f, 0x031deb1f, 0xedb3ef3c, 0xf96cc8e4,
+  0x0706eef9, 0xd7e50208, 0xff67f88b, 0xf717ff09, 0x1470ebb2, 0x0aa33dda, 0xf737f8aa, 0xed96eb0b,
+  0xe4dbfb0c, 0xd48be8d3, 0xd834b2ce, 0xc65cc41a, 0xfba7dcc1, 0xe78fd56f, 0xcbcddba8, 0x0121e1bb,
+  0xff94e228, 0x16162c16, 0xf821197b, 0x1e311e4f, 0x28582fae, 0x179a2d01, 0xfce8372e, 0x2064efe9,
+  0x114eff0d, 0x563935bd, 0x21572c94, 0xe9a9126b, 0x044cecdc, 0x2a0b3296, 0x2c5e4304, 0x64dd4ae9,
+  0x0c9b3446, 0xde5001b8, 0xa8cfb95b, 0x02becfc6, 0xbd60e7c6, 0xe000eb43, 0xfe6e10a1, 0xdad4e28d,
+  0xdd27dd61, 0xf93ceea0, 0xfba1e825, 0xe999d644, 0xd003e43d, 0xc81dd3bc, 0xd1a9e03a, 0xf8a3c6a6,
+  0xf239fab8, 0xb662df52, 0xd188ce39, 0xf20adeec, 0xf60cfe70, 0xf066e554, 0xd0edd087, 0x0457deee,
+  0xbfbeec7c, 0x8fdfa456, 0x013fd7bc, 0xeac121c0, 0xe1a8c063, 0xfae3c7ef, 0xd2c5d06a, 0xe523abdd,
+  0xe9ade007, 0x31861758, 0xf1bf2a14, 0xf493dd47, 0x3daf0d82, 0x0c812c7e, 0x0ff7e7b2, 0xf64116c1,
+  0xaa4cd49f, 0xd08f8d1e, 0xfa4dc493, 0x328501d8, 0x26b84197, 0x34bb4d93, 0x05342501, 0xc37ed575,
+  0x1544ee74, 0x23b204b2, 0xede1215b, 0xf6b9bd5b, 0xfe662401, 0x2f5d07f2, 0x4df7360a, 0x3dcd10e6,
+  0x297031ea, 0xf3d01add, 0xf0c82682, 0x214e0adc, 0x1d981814, 0x26672e0b, 0x0b431b17, 0x4ce338b8,
+  0x6bd6628d, 0x1ccc3239, 0xe2970c45, 0xd452d525, 0x0d1e07a5, 0x315b1cb7, 0xe5b2f840, 0xfb17c9ce,
+  0xbbc3e0e4, 0xb2cbc85c, 0x944c9918, 0x87fe9b42, 0xf291b505, 0x0864cb61, 0x23632464, 0x0b4a4526,
+  0xdc6ffa2a, 0xeba5cb93, 0x060c07eb, 0x0853e5d0, 0x2b951b74, 0x1e21373e, 0x313e1f4c, 0xdee60d5b,
+  0xd9caea6c, 0x10a6d427, 0x2b29fdeb, 0x35f24868, 0x229e569b, 0x4d45495f, 0x28f53684, 0x48544e7a,
+  0x10c512ba, 0x057c2d1d, 0x22d724b0, 0xfb1d1053, 0xfdbbef4d, 0x102415eb, 0xe343f8d3, 0x1097e850,
+  0x0563420d, 0xcff5eac2, 0xc5afae79, 0xc759a140, 0x347906bb, 0x356137e8, 0x2ede1f42, 0x6b0a54aa,
+  0x577e2f70, 0x76cb5969, 0x62d943d8, 0x1d171c76, 0xe54d1721, 0xe4e5154c, 0x30c01b0f, 0x428218c6,
+  0x2598590c, 0xf576f825, 0xf9fe0c11, 0xe89f059d, 0x40651411, 0x227f35ef, 0x132d280d, 0x0a120cd2,
+  0xf82cec19, 0xb895e504, 0xee2bd8de, 0x3b2d2529, 0x539f47c3, 0x58414651, 0x24f94b7b, 0x088f4a33,
+  0xc274e961, 0x9561b95f, 0xd2019a2e, 0x8ea9af1c, 0xdb559ef0, 0xd915bcad, 0xf283f12d, 0xf7f8cd69,
+  0xbe9feca3, 0xd3f2ab9a, 0x9892b060, 0xc04981b3, 0xf49cc0d4, 0xeb2def6c, 0xdf7fbd16, 0xa30ecaa9,
+  0x843e985f, 0xecffc3ac, 0x0472f0c1, 0xe9bf1afc, 0x12c608d7, 0xf4772917, 0xdf521243, 0x0c98dcf1,
+  0xdfefef4a, 0xd2a5ba94, 0xbc89e26d, 0xce46aa8a, 0xe20dc7a0, 0xcce0ee32, 0xa4efa4e8, 0x8b308c35,
+  0xb035a6fb, 0xb044a6e6, 0xfea7d731, 0xd256f6db, 0x07bfe5ec, 0xf72a33e4, 0xe07fdec0, 0x0be30d87,
+  0xbc12e024, 0x80019c4f, 0x01c4c59e, 0x2106fa1f, 0x2255259a, 0x2bde30e4, 0xff5801ed, 0x241b25a1,
+  0x56264a35, 0x1d9240de, 0x00f81f11, 0x25640ed6, 0x1d8bee84, 0x174f3ece, 0x2e4a2f87, 0x2c554484,
+  0x0efc288a, 0xd8a8f4ed, 0xdcaaec12, 0x189b0ec3, 0xe37ce82e, 0xcf38c4d5, 0xc1aacd6d, 0xd113fbba,
+  0xc980aae3, 0xd1cbc589, 0x00c1d664, 0x17f9f5f8, 0xe558ed38, 0xdbe80af1, 0xebde0e79, 0xcb8cf537,
+  0xaaa3bc25, 0xcc71bef5, 0x051cdd7e, 0x29a71ee3, 0x35f916b7, 0xff081829, 0xfbedd500, 0x0c2ae5af,
+  0x35d50a4a, 0x349f50a5, 0x3df2549c, 0x186e0f0c, 0x02aa2501, 0xd729fd6b, 0xa109c1c4, 0xb091a3fc,
+  0xbe39c3c4, 0x0e43ecfe, 0xe4fe133b, 0xe241ecf8, 0xdbb4f3bb, 0xcbcdc7f6, 0xc34ce328, 0xe7a7f7bd,
+  0xe4eb1089, 0x262f117d, 0xfb7ef9be, 0xf986f691, 0x01d6dd30, 0xdfd2ebae, 0x166ae9ac, 0xf875248e,
+  0xe39cd4e9, 0xac65c5bb, 0xe409ab67, 0xf32dc19b, 0x1785fa71, 0x1ba0fb70, 0xd3ffef75, 0x246f0427,
+  0x14671b86, 0x09f52f05, 0x251c04b6, 0xf99712fb, 0x1bbb0d87, 0xe75dfcdf, 0xdcf5e8ba, 0xd119f75f,
+  0xfa9302b5, 0xdcb2e876, 0xefa7ce19, 0xdc0ad434, 0xf321e2ef, 0xe374d99a, 0xd68cfdab, 0xdc30fedf,
+  0x0e0aed70, 0x11eb092b, 0x1a6cf9e1, 0x16070b1b, 0xdcb2ff6d, 0xff84fbbc, 0xf308d9c2, 0x0d771855,
+  0x09052560, 0x244701a2, 0x0017f87e, 0x071f00cb, 0x0e07e4a4, 0x0d84f742, 0x132dfd11, 0xf851f60b,
+  0xcf0dee7e, 0xcd36e6fc, 0xa66cb573, 0xca2cca2b, 0xb6fabcf2, 0xbb90cd5d, 0xd6f5e2de, 0xee58d250,
+  0xf03a04b7, 0xfffaeb5f, 0x20400c9f, 0x08ad3136, 0xfd52ff1d, 0x07d6fb0f, 0xe96cef89, 0xebdfdb28,
+  0xdbafee6f, 0xe2baca58, 0xba88d0b7, 0xdef6e0fb, 0xd9f5e25c, 0xe119e8fd, 0xdb38de21, 0xf2c0f008,
+  0x0fe8fd1f, 0xec3308aa, 0xfb9208dc, 0x040bddcb, 0xfab00239, 0x06a611ba, 0xdf77f38d, 0xfac1edf2,
+  0x0c90193f, 0xf9801c0c, 0x18f5fd9f, 0x2046161b, 0x0ab02dee, 0x018a1faa, 0x1711fff8, 0x23d11bc8,
+  0x0b182532, 0xea8e06a5, 0x071a06f0, 0x09eef250, 0x13ba14b8, 0x0f7e1a63, 0x0bef0490, 0x05bef401,
+  0xfc69043f, 0xe478ef12, 0x0955ff51, 0xe91afa4b, 0xd913ebe7, 0xe982f4fb, 0xf3e3d388, 0xedaaf1ef,
+  0xe392ec1a, 0xd485d411, 0xdf4acdea, 0xc2f2ce76, 0xf9b6e3ed, 0x05be0b0e, 0xfb26f295, 0xdd73f1a7,
+  0xd7d1d79e, 0xf46bd31a, 0x04b7e7ea, 0x047d094d, 0xf012ed8f, 0x0a98035a, 0x02a8f38c, 0xdc0aef0f,
+  0x0352f0cf, 0x25c8160f, 0xf9bd0b89, 0xed6b0067, 0xf0f1e14e, 0xe257ece6, 0xdd3cdd57, 0xc7b5ce91,
+  0xc78ec75c, 0xeb91ccea, 0xeefe0369, 0x032bfb16, 0xf746f252, 0x0cdcfa94, 0x07420b58, 0xfbb50b9f,
+  0x0be2091a, 0xfa380556, 0x05cbfe21, 0xf425fbdf, 0xf6a10952, 0xfa9eea42, 0x08a7f59a, 0xf9bc0ca9,
+  0x0e1a021b, 0x057e13c3, 0x094df9e1, 0x214015bf, 0x156a0a98, 0x164d1e40, 0xfbd608f7, 0x019ffc6f,
+  0x088a0598, 0xfcc4009f, 0xe7d8f3ca, 0xe1a1e988, 0xf0c0ee5a, 0x0e3f0161, 0xf9140663, 0x06d90756,
+  0x156e12c4, 0x02f10a4e, 0x03d10642, 0x0f62072a, 0x1051082b, 0x0a3a1929, 0xefbbfad4, 0xedf3f375,
+  0xfc22fc0d, 0x0bd7ff45, 0x01390835, 0xfbc6068d, 0xfd82f870, 0xfc7a0048, 0x03070546, 0xfe12057b,
+  0x0312fbd6, 0x0e670d10, 0x05c803f8, 0x0783fe8c, 0x0c530422, 0x080b029c, 0x07780a21, 0x00180719,
+  0xf69ff934, 0xf766f89b, 0xf642f2cf, 0x00b3004a, 0xfe86019e, 0xfe09f9c5, 0xf8d50058, 0x00bffc93,
+  0x018f00f3, 0x024cffdf, 0xfd13fbbc, 0x00adfe76, 0x0970063a, 0x00720817, 0x02b6fd39, 0xfee3fd0b,
+  0xff99fc60, 0x031c03bc, 0x0330034c, 0x026d02d5, 0xfceefec6, 0xfcf1fe34, 0xfe7dfbb2, 0xfd6f0198,
+  0x037400d4, 0x033a0100, 0x05be04e0, 0x016f0496, 0xfdcbfee1, 0xff83fc3d, 0xfc63fd56, 0xfff8fed4,
+  0xfe3afea2, 0xfe57fec5, 0xff41ffec, 0xfff4ff2f, 0xff8fff38, 0x002bff70, 0xffa1ffd7, 0xffedffe1
+};
+#endif
+#endif
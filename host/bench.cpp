@@ -0,0 +1,1207 @@
+/*
+ * Microbenchmarks for the ModalResonators DSP blocks
+ *
+ * Writes one CSV row per measurement to stdout:
+ *   name,fs,block,modes,voices,unit,ns,per_sec
+ * unit is "sample" for per-sample processing and "call" for control rate updates.
+ * Every measurement is the best of several repetitions.
+ *
+ * Compare two runs with tools/bench_compare.py
+ *
+ *   bench [--quick] [--reps n] [--filter substring]
+ *   bench --mem	prints resonator bytes per mode and per bank instead
+ *   bench --precision	prints how far float and reson_precision modes stray from a double reference,
+ *			and fails if any mode reson_precision takes over strays past PREC_REPORT_*
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <chrono>
+#include <vector>
+
+#include "daisysp.h"
+#include "dumb_biquad.h"
+#include "modal_note.h"
+#include "reson_bank_cmsis.h"
+#include "modal_inharm.h"
+#include "modal_chord.h"
+#include "modal_ola.h"
+#include "modal_reverb.h"
+#include "reverb_room.h"
+#include "ir_cache.h"
+#include "tuning.h"
+#include "exciter_bank.h"
+#include "exciter_blob.h"
+#include "crc_noise.h"
+#include "tri_lfo.h"
+#include "PagedParam.h"
+#include "param_store.h"
+#include "waveshaper.h"
+#include "denormal.h"
+
+using namespace daisysp;
+
+// Amount of audio rendered per repetition, in seconds
+#define BENCH_SECONDS	0.5f
+// Number of control rate calls per repetition
+#define BENCH_CALLS	20000
+// Matches the firmware voice
+#define NUM_HARM_PARTIALS 4
+
+static int   reps = 5;
+static bool  quick = false;
+static const char *filter = NULL;
+static volatile float sink;
+
+static const float sample_rates[] = {48000, 96000, 192000};
+static const int   block_sizes[]  = {1, 2, 4, 8, 16, 32, 48, 64, 128, 256, 512};
+static const int   voice_counts[] = {1, 5, 8, 16};
+#define BENCH_MAX_VOICES 16
+
+// Keep the compiler from discarding updates to objects that are never read back
+static inline void Escape(void *p)
+{
+  asm volatile("" : : "g"(p) : "memory");
+}
+
+static bool Selected(const char *name)
+{
+  return filter == NULL || strstr(name, filter) != NULL;
+}
+
+static void Report(const char *name, float fs, int block, int modes, int voices, const char *unit, double ns)
+{
+  printf("%s,%.0f,%d,%d,%d,%s,%.3f,%.1f\n", name, fs, block, modes, voices, unit, ns, 1e9 / ns);
+  fflush(stdout);
+}
+
+/*
+ * Run f(n) reps times and return the best time in ns per item
+ * f is expected to process n items
+ */
+template <typename F>
+static double Time(F f, size_t n)
+{
+  double best = 1e30;
+  for (int r = 0; r < reps; r++) {
+    auto t0 = std::chrono::steady_clock::now();
+    f(n);
+    auto t1 = std::chrono::steady_clock::now();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+    if (ns < best) best = ns;
+  }
+  return best;
+}
+
+// Low level noise to keep the resonators ringing without running into denormals
+static std::vector<float> MakeExcitation(size_t n)
+{
+  std::vector<float> x(n);
+  crc_noise noise;
+  noise.Init(1);
+  for (size_t i = 0; i < n; i++) {
+    x[i] = 0.01f * noise.Process();
+  }
+  return x;
+}
+
+static void BenchBiquad(float fs)
+{
+  size_t n = fs * BENCH_SECONDS;
+  std::vector<float> x = MakeExcitation(n);
+
+  if (Selected("dumb_biquad.Process")) {
+    reson_hot h;
+    iir_reson r;
+    r.attach(&h);
+    r.init(fs, 440, 0.9999, 1);
+    dumb_biquad bq;
+    bq.set_a(h.a[0], h.a[1]);
+    bq.set_b(h.b0, 0, -h.b0);
+    Report("dumb_biquad.Process", fs, 1, 1, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += bq.Process(x[i]);
+      sink = acc;
+    }, n));
+  }
+
+  if (Selected("reson_hot.Process")) {
+    reson_hot h;
+    iir_reson r;
+    r.attach(&h);
+    r.init(fs, 440, 0.9999, 1);
+    reson_input hist;
+    Report("reson_hot.Process", fs, 1, 1, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += reson_process(h, hist.Process(x[i]));
+      sink = acc;
+    }, n));
+  }
+
+  if (Selected("iir_1p_lp.Process")) {
+    iir_1p_lp lp;
+    lp.init(fs, 1000);
+    Report("iir_1p_lp.Process", fs, 1, 1, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += lp.Process(x[i]);
+      sink = acc;
+    }, n));
+  }
+}
+
+/*
+ * One voice's worth of modes on the same input:
+ * a generic 5 multiply biquad per mode against the shared x[n] - x[n-2] kernel,
+ * and the CMSIS-DSP DF1 bank a block at a time (the portable copy of it on the host)
+ */
+template <int M>
+static void BenchKernel(float fs)
+{
+  size_t n = fs * BENCH_SECONDS;
+  std::vector<float> x = MakeExcitation(n);
+
+  reson_hot h[M];
+  iir_reson r[M];
+  dumb_biquad bq[M];
+  for (int m = 0; m < M; m++) {
+    r[m].attach(&h[m]);
+    r[m].init(fs, 110 * (m + 1), 0.9999, 1);
+    bq[m].set_a(h[m].a[0], h[m].a[1]);
+    bq[m].set_b(h[m].b0, 0, -h[m].b0);
+  }
+
+  if (Selected("kernel.dumb_biquad")) {
+    Report("kernel.dumb_biquad", fs, 1, M, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) {
+	for (int m = 0; m < M; m++) acc += bq[m].Process(x[i]);
+      }
+      sink = acc;
+    }, n));
+  }
+
+  if (Selected("kernel.reson_shared")) {
+    reson_input hist;
+    Report("kernel.reson_shared", fs, 1, M, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) {
+	float d = hist.Process(x[i]);
+	for (int m = 0; m < M; m++) acc += reson_process(h[m], d);
+      }
+      sink = acc;
+    }, n));
+  }
+
+  if (Selected("kernel.cmsis_df1")) {
+    const int block = 48;
+    static reson_bank_cmsis<M> bank;
+    bank.Reset();
+    float out[block];
+    size_t nb = n - n % block;
+    Report("kernel.cmsis_df1", fs, block, M, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t b = 0; b < n; b += block) {
+	for (int i = 0; i < block; i++) out[i] = 0;
+	bank.AddBlock(h, &x[b], out, block, 1);
+	acc += out[block - 1];
+      }
+      sink = acc;
+    }, nb));
+  }
+}
+
+static void BenchCoefs(float fs)
+{
+  reson_hot h;
+  iir_reson r;
+  r.attach(&h);
+  r.init(fs, 440, 0.9999, 1);
+
+  if (Selected("iir_reson.update_fc")) {
+    Report("iir_reson.update_fc", fs, 1, 1, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	r.update_fc(100 + (i & 1023));
+	Escape(&r);
+      }
+    }, BENCH_CALLS));
+  }
+  if (Selected("iir_reson.update_r")) {
+    Report("iir_reson.update_r", fs, 1, 1, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	r.update_r(0.999f + (i & 1023) * 1e-7f);
+	Escape(&r);
+      }
+    }, BENCH_CALLS));
+  }
+  if (Selected("iir_reson.update_g")) {
+    Report("iir_reson.update_g", fs, 1, 1, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	r.update_g(0.5f + (i & 1023) * 1e-3f);
+	Escape(&r);
+      }
+    }, BENCH_CALLS));
+  }
+  if (Selected("iir_1p_lp.update_fc")) {
+    iir_1p_lp lp;
+    lp.init(fs, 1000);
+    Report("iir_1p_lp.update_fc", fs, 1, 1, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	lp.update_fc(100 + (i & 1023));
+	Escape(&lp);
+      }
+    }, BENCH_CALLS));
+  }
+}
+
+template <int M>
+static void BenchModalNote(float fs)
+{
+  const int modes = M;
+  char name[64];
+  size_t n = fs * BENCH_SECONDS;
+  std::vector<float> x = MakeExcitation(n);
+
+  modal_note<M> note;
+  note.init(fs, 45, 0.9999);
+
+  if (Selected("modal_note.Process")) {
+    Report("modal_note.Process", fs, 1, modes, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += note.Process(x[i]);
+      sink = acc;
+    }, n));
+  }
+  // Mid and side buses, the modes spread across the outputs
+  if (Selected("modal_note.stereo")) {
+    note.set_pan(0.2f, 0.5f);
+    Report("modal_note.stereo", fs, 1, modes, 1, "sample", Time([&](size_t n) {
+      float acc = 0, side = 0;
+      for (size_t i = 0; i < n; i++) {
+	float s;
+	acc += note.Process(x[i], s);
+	side += s;
+      }
+      sink = acc + side;
+    }, n));
+  }
+
+  // Alternate between two values so the early outs never trigger
+  struct { const char *name; void (*f)(modal_note<M> &, size_t); } updates[] = {
+    {"fc",        [](modal_note<M> &m, size_t i) { m.update_fc((i & 1) ? 45 : 46); }},
+    {"r",         [](modal_note<M> &m, size_t i) { m.update_r((i & 1) ? 0.9999 : 0.9998); }},
+    {"g",         [](modal_note<M> &m, size_t i) { m.update_g((i & 1) ? 1 : 2); }},
+    {"stiffness", [](modal_note<M> &m, size_t i) { m.update_stiffness((i & 1) ? 0.0001 : 0.0002); }},
+    {"beta",      [](modal_note<M> &m, size_t i) { m.update_beta((i & 1) ? 2 : 3); }},
+    {"mgf",       [](modal_note<M> &m, size_t i) { m.update_mgf((i & 1) ? 0 : 1); }},
+    {"ifc",       [](modal_note<M> &m, size_t i) { m.update_ifc((i & 1) ? 220 : 440); }},
+  };
+  for (auto &u : updates) {
+    snprintf(name, sizeof(name), "modal_note.update_%s", u.name);
+    if (!Selected(name)) continue;
+    Report(name, fs, 1, modes, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	u.f(note, i);
+	Escape(&note);
+      }
+    }, BENCH_CALLS / modes));
+  }
+}
+
+static void BenchModalInharm(float fs)
+{
+  size_t n = fs * BENCH_SECONDS;
+  std::vector<float> x = MakeExcitation(n);
+
+  modal_inharm<NUM_INHARM_PARTIALS> inharm;
+  inharm.init(fs, 220, &inharm_presets[0]);
+
+  if (Selected("modal_inharm.Process")) {
+    Report("modal_inharm.Process", fs, 1, NUM_INHARM_PARTIALS, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += inharm.Process(x[i]);
+      sink = acc;
+    }, n));
+  }
+  if (Selected("modal_inharm.stereo")) {
+    inharm.set_pan(0.2f, 0.5f);
+    Report("modal_inharm.stereo", fs, 1, NUM_INHARM_PARTIALS, 1, "sample", Time([&](size_t n) {
+      float acc = 0, side = 0;
+      for (size_t i = 0; i < n; i++) {
+	float s;
+	acc += inharm.Process(x[i], s);
+	side += s;
+      }
+      sink = acc + side;
+    }, n));
+  }
+  if (Selected("modal_inharm.load_preset")) {
+    Report("modal_inharm.load_preset", fs, 1, NUM_INHARM_PARTIALS, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	inharm.load_preset(&inharm_presets[i % NUM_INHARM_PRESETS]);
+	Escape(&inharm);
+      }
+    }, BENCH_CALLS));
+  }
+  if (Selected("modal_inharm.update_fc")) {
+    Report("modal_inharm.update_fc", fs, 1, NUM_INHARM_PARTIALS, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	inharm.update_fc((i & 1) ? 220 : 221);
+	Escape(&inharm);
+      }
+    }, BENCH_CALLS));
+  }
+  if (Selected("modal_inharm.modulate_r")) {
+    Report("modal_inharm.modulate_r", fs, 1, NUM_INHARM_PARTIALS, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	inharm.modulate_r((i & 1) ? 0.1 : 0.2);
+	Escape(&inharm);
+      }
+    }, BENCH_CALLS));
+  }
+  if (Selected("modal_inharm.modulate_g")) {
+    Report("modal_inharm.modulate_g", fs, 1, NUM_INHARM_PARTIALS, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	inharm.modulate_g((i & 1) ? 0.1 : 0.2);
+	Escape(&inharm);
+      }
+    }, BENCH_CALLS));
+  }
+}
+
+static void BenchControl(float fs)
+{
+  size_t n = fs * BENCH_SECONDS;
+
+  if (Selected("tri_lfo.Process")) {
+    tri_lfo lfo;
+    lfo.Init(fs);
+    lfo.SetRange(1);
+    lfo.SetDepth(1);
+    lfo.SetFreq(3);
+    Report("tri_lfo.Process", fs, 1, 1, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) {
+	lfo.Process();
+	acc += lfo.GetOutput();
+      }
+      sink = acc;
+    }, n));
+  }
+
+  if (Selected("crc_noise.Process")) {
+    crc_noise noise;
+    noise.Init(1);
+    Report("crc_noise.Process", fs, 1, 1, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += noise.Process();
+      sink = acc;
+    }, n));
+  }
+
+  PagedParam p;
+  p.Init(1, 0.5, 0, 1, 0.05);
+  if (Selected("PagedParam.Process")) {
+    Report("PagedParam.Process", fs, 1, 1, 1, "call", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += p.Process((i & 127) / 127.0f, 1);
+      sink = acc;
+    }, BENCH_CALLS));
+  }
+  if (Selected("PagedParam.MidiCCIn")) {
+    Report("PagedParam.MidiCCIn", fs, 1, 1, 1, "call", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += p.MidiCCIn(i & 127);
+      sink = acc;
+    }, BENCH_CALLS));
+  }
+
+  // A CC or pot move as the engine now takes it, and the audio side's look once per block
+  static param_store store;
+  float defaults[NUM_PARAMS] = {};
+  store.Init(defaults);
+  if (Selected("param_store.Set")) {
+    Report("param_store.Set", fs, 1, 1, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) store.Set((param_id)(i % NUM_PARAMS), (i & 127) / 127.0f);
+    }, BENCH_CALLS));
+  }
+  if (Selected("param_store.Take")) {
+    Report("param_store.Take", fs, 1, 1, 1, "call", Time([&](size_t n) {
+      uint32_t acc = 0;
+      for (size_t i = 0; i < n; i++) {
+	store.Set(PARAM_STIFF, 0.5f);
+	acc += store.Take();
+      }
+      sink = acc;
+    }, BENCH_CALLS));
+  }
+
+  static const char *ws_names[] = {"waveshape.NONE", "waveshape.EXP_DIST", "waveshape.TANH", "waveshape.ARCTAN"};
+  std::vector<float> x = MakeExcitation(n);
+  for (int m = NONE; m < LAST_OUTPUT; m++) {
+    if (!Selected(ws_names[m])) continue;
+    Report(ws_names[m], fs, 1, 1, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += waveshape(x[i] * 100, (ui_output_mode)m);
+      sink = acc;
+    }, n));
+  }
+}
+
+/*
+ * CPU over a whole ringing tail
+ * One 32 mode voice is pinged and left to decay, each window is timed separately.
+ * A radius of DECAY_R reaches the subnormal range a few seconds in.
+ * Rows are decay.<policy>.<window start in seconds>, the block column holds the subnormal
+ * filter states seen at the end of the window.
+ *   denormals - FPU default mode
+ *   ftz       - denormal_guard in scope (what modal_engine::Process does)
+ *   offset    - DENORMAL_OFFSET added to the input, FPU default mode
+ */
+#define DECAY_R		0.9995f
+#define DECAY_SECONDS	8.0f
+#define DECAY_WINDOW	0.5f
+
+static void BenchDecay(float fs)
+{
+  static const char *policies[] = {"denormals", "ftz", "offset"};
+  char name[64];
+  size_t window = fs * DECAY_WINDOW;
+  std::vector<float> in(window, 0.0f);
+
+  for (int p = 0; p < 3; p++) {
+    snprintf(name, sizeof(name), "decay.%s", policies[p]);
+    if (!Selected(name)) continue;
+
+    modal_note<32> note;
+    note.init(fs, 110, DECAY_R);
+    note.update_stiffness(0.0001);
+    if (p == 2) note.set_denormal_offset(DENORMAL_OFFSET);
+    in[0] = 1;
+
+    for (float t = 0; t < DECAY_SECONDS; t += DECAY_WINDOW) {
+      double ns;
+      {
+	denormal_guard *ftz = p == 1 ? new denormal_guard : NULL;
+	float acc = 0;
+	auto t0 = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < window; i++) acc += note.Process(in[i]);
+	auto t1 = std::chrono::steady_clock::now();
+	delete ftz;
+	sink = acc;
+	ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / window;
+      }
+      in[0] = 0;
+      snprintf(name, sizeof(name), "decay.%s.%04.1f", policies[p], t);
+      Report(name, fs, note.count_subnormal(), 32, 1, "sample", ns);
+    }
+  }
+}
+
+/*
+ * Large voices with only the most audible modes running
+ * A stiff string with a falling gain slope, so the high modes matter least
+ */
+template <int M>
+static void BenchCull(float fs)
+{
+  static const int budgets[] = {M, 32, 16, 8};
+  char name[64];
+  size_t n = fs * BENCH_SECONDS;
+  std::vector<float> x = MakeExcitation(n);
+
+  for (int k : budgets) {
+    if (k > M || (k == M && M == 32)) continue;
+    snprintf(name, sizeof(name), "cull.modal_note.k%d", k);
+    if (!Selected(name)) continue;
+    modal_note<M> note;
+    note.init(fs, 55, 0.9999);
+    note.update_stiffness(0.0002);
+    note.update_mgf(1);
+    note.set_mode_budget(k);
+    // Let the fades settle before timing
+    for (size_t i = 0; i < 2 * CULL_FADE_SAMPLES; i++) note.Process(x[i]);
+    Report(name, fs, 1, M, 1, "sample", Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += note.Process(x[i]);
+      sink = acc;
+    }, n));
+  }
+}
+
+/*
+ * Bass voices with every mode at full rate against the multirate tiers
+ * Rows are multirate.<off|on>.<fundamental>
+ * The tiers cost a fixed few ns per sample, they pay off once there are a few dozen low modes
+ */
+template <int M>
+static void BenchMultirate(float fs)
+{
+  static const float fundamentals[] = {45, 110, 440};
+  char name[64];
+  size_t n = fs * BENCH_SECONDS;
+  std::vector<float> x = MakeExcitation(n);
+
+  for (float f : fundamentals) {
+    for (int on = 0; on < 2; on++) {
+      snprintf(name, sizeof(name), "multirate.%s.%.0f", on ? "on" : "off", f);
+      if (!Selected(name)) continue;
+      modal_note<M> note;
+      note.init(fs, f, 0.9999);
+      note.set_multirate(on);
+      Report(name, fs, 1, M, 1, "sample", Time([&](size_t n) {
+	float acc = 0;
+	for (size_t i = 0; i < n; i++) acc += note.Process(x[i]);
+	sink = acc;
+      }, n));
+    }
+  }
+}
+
+/*
+ * Low voices with long decays in plain float against reson_precision
+ * Rows are precision.<off|on>.<fundamental>, the modes column is how many modes needed more than float
+ */
+template <int M>
+static void BenchPrecision(float fs)
+{
+  static const float fundamentals[] = {20, 55, 440};
+  char name[64];
+  size_t n = fs * BENCH_SECONDS;
+  std::vector<float> x = MakeExcitation(n);
+
+  for (float f : fundamentals) {
+    for (int on = 0; on < 2; on++) {
+      snprintf(name, sizeof(name), "precision.%s.%.0f", on ? "on" : "off", f);
+      if (!Selected(name)) continue;
+      modal_note<M> note;
+      note.init(fs, f, 0.99999);
+      note.set_precision(on);
+      note.Process(0);
+      int modes = M;
+      if (on) {
+	modes = note.precision_count(reson_precision<M>::EF) + note.precision_count(reson_precision<M>::DOUBLE);
+      }
+      Report(name, fs, 1, modes, 1, "sample", Time([&](size_t n) {
+	float acc = 0;
+	for (size_t i = 0; i < n; i++) acc += note.Process(x[i]);
+	sink = acc;
+      }, n));
+    }
+  }
+}
+
+/*
+ * The same dense inharmonic mode set through a resonator per mode (modal_inharm)
+ * and through the frequency domain voice (modal_ola), both driven by noise the whole time
+ * so modal_ola pays for its input FFT every hop.
+ * Rows are ola.<resonators|fft>, then ola.crossover: the modes column is the smallest
+ * count measured where modal_ola is faster, ns is its time there. Nothing is printed if it never wins.
+ */
+#define OLA_BENCH_MAX 2048
+
+static float ola_modes[OLA_BENCH_MAX], ola_res[OLA_BENCH_MAX], ola_gains[OLA_BENCH_MAX];
+static int ola_crossover;
+static double ola_crossover_ns;
+
+template <int M>
+static void BenchOla(float fs)
+{
+  size_t n = fs * BENCH_SECONDS;
+  std::vector<float> x = MakeExcitation(n);
+  // Spread over the audible band with a little irregularity, as a plate or a room would be
+  for (int i = 0; i < M; i++) {
+    ola_modes[i] = -(40 + (fs * 0.4f - 40) * i / M + 3 * sinf(i * 1.7f));
+    ola_res[i] = 0.9995f;
+    ola_gains[i] = 1;
+  }
+  mode_set set = {M, ola_modes, ola_res, ola_gains};
+  double ns[2] = {0, 0};
+
+  if (Selected("ola.resonators") || Selected("ola.crossover")) {
+    // Static, large voices don't belong on the stack and gnu++14 new ignores alignas
+    static modal_inharm<M> v;
+    v.init(fs, 1, set);
+    ns[0] = Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += v.Process(x[i]);
+      sink = acc;
+    }, n);
+    if (Selected("ola.resonators")) Report("ola.resonators", fs, 1, M, 1, "sample", ns[0]);
+  }
+  if (Selected("ola.fft") || Selected("ola.crossover")) {
+    static modal_ola<M> v;
+    v.init(fs, 1, set);
+    ns[1] = Time([&](size_t n) {
+      float acc = 0;
+      for (size_t i = 0; i < n; i++) acc += v.Process(x[i]);
+      sink = acc;
+    }, n);
+    if (Selected("ola.fft")) Report("ola.fft", fs, 1, M, 1, "sample", ns[1]);
+  }
+  if (ola_crossover == 0 && ns[1] > 0 && ns[1] < ns[0]) {
+    ola_crossover = M;
+    ola_crossover_ns = ns[1];
+  }
+}
+
+static void BenchOlaCrossover(float fs)
+{
+  ola_crossover = 0;
+  BenchOla<4>(fs);
+  BenchOla<8>(fs);
+  BenchOla<16>(fs);
+  BenchOla<32>(fs);
+  BenchOla<64>(fs);
+  BenchOla<128>(fs);
+  BenchOla<256>(fs);
+  if (!quick) {
+    BenchOla<512>(fs);
+    BenchOla<1024>(fs);
+    BenchOla<OLA_BENCH_MAX>(fs);
+  }
+  if (ola_crossover && Selected("ola.crossover")) {
+    Report("ola.crossover", fs, OLA_HOP, ola_crossover, 1, "sample", ola_crossover_ns);
+  }
+}
+
+/*
+ * The reverb send on the fitted room, a block at a time as AudioCallback runs it,
+ * against the same modes as two mono banks each advancing its own states
+ */
+static void BenchReverb(float fs)
+{
+  const int block = 48;
+  size_t n = fs * BENCH_SECONDS;
+  n -= n % block;
+  std::vector<float> x = MakeExcitation(n);
+  std::vector<float> l(n), r(n);
+
+  if (Selected("reverb.stereo")) {
+    static modal_reverb rv;
+    rv.Init(fs, reverb_room);
+    rv.SetSend(1);
+    Report("reverb.stereo", fs, block, rv.num_modes(), 1, "sample", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) l[i] = r[i] = x[i];
+      for (size_t b = 0; b < n; b += block) {
+	rv.Process(&l[b], &r[b], block);
+      }
+      sink = l[n - 1] + r[n - 1];
+    }, n));
+  }
+  if (Selected("reverb.two_mono")) {
+    static modal_ola<REVERB_MAX_MODES> v[2];
+    mode_set left = {reverb_room.num_modes, reverb_room.modes, reverb_room.res, reverb_room.gains_l};
+    mode_set right = {reverb_room.num_modes, reverb_room.modes, reverb_room.res, reverb_room.gains_r};
+    v[0].init(fs, 1, left);
+    v[1].init(fs, 1, right);
+    Report("reverb.two_mono", fs, block, v[0].num_modes(), 1, "sample", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) l[i] = r[i] = 0;
+      for (size_t b = 0; b < n; b += block) {
+	v[0].AddFilteredBlock(&x[b], &l[b], block);
+	v[1].AddFilteredBlock(&x[b], &r[b], block);
+      }
+      sink = l[n - 1] + r[n - 1];
+    }, n));
+  }
+}
+
+/*
+ * A pinged inharmonic voice run live against the same ping played back from an ir_cache,
+ * both over the length of the cached response.
+ * Rows are ircache.<live|cached|render>, render is what Service costs the main loop per sample
+ */
+#define IRC_BENCH_R 0.999f
+
+static void BenchIrCache(float fs)
+{
+  const int block = 48;
+  static modal_inharm<NUM_INHARM_PARTIALS> v;
+  v.init(fs, 220, &inharm_presets[0]);
+  // Short enough to fit the cache
+  float res[NUM_INHARM_PARTIALS];
+  for (int i = 0; i < NUM_INHARM_PARTIALS; i++) res[i] = IRC_BENCH_R;
+  v.update_r(res);
+
+  static ir_cache irc;
+  ir_key key;
+  float ref = v.save_coefs(key);
+  double render_ns = Time([&](size_t) {
+    irc.Init();
+    irc.Find(key);
+    while (irc.Service()) {}
+  }, 1);
+  int s = irc.Find(key);
+  if (s < 0) return;
+  size_t n = irc.Length(s);
+  n -= n % block;
+  const float *ir = irc.Samples(s);
+  std::vector<float> x(n, 0.0f), y(n);
+  x[0] = 1;
+
+  if (Selected("ircache.live")) {
+    Report("ircache.live", fs, block, NUM_INHARM_PARTIALS, 1, "sample", Time([&](size_t n) {
+      v.clear();
+      for (size_t i = 0; i < n; i++) y[i] = 0;
+      for (size_t b = 0; b < n; b += block) {
+	v.AddBlock(&x[b], &y[b], block);
+      }
+      sink = y[n - 1];
+    }, n));
+  }
+  if (Selected("ircache.cached")) {
+    Report("ircache.cached", fs, block, NUM_INHARM_PARTIALS, 1, "sample", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) y[i] = 0;
+      for (size_t b = 0; b < n; b += block) {
+	for (size_t i = b; i < b + block; i++) {
+	  y[i] += ref * ir[i];
+	}
+      }
+      sink = y[n - 1];
+    }, n));
+  }
+  if (Selected("ircache.render")) {
+    Report("ircache.render", fs, block, NUM_INHARM_PARTIALS, 1, "sample", render_ns / irc.Length(s));
+  }
+  irc.Release(s);
+}
+
+/*
+ * Note-on pitch changes worked out in place against ones copied from a pitch_table,
+ * notes walking up and down the keyboard. Rows are noteon.<voice>.<update_fc|table>,
+ * and noteon.<voice>.service, what filling one note of the table costs the main loop
+ */
+template <typename V, int M>
+static void BenchNoteOn(float fs, const char *voice, V &v, pitch_table<M> &table)
+{
+  char name[64];
+  float freqs[TUNING_NOTES];
+  for (int n = 0; n < TUNING_NOTES; n++) freqs[n] = mtof(n);
+  // Stay below the notes where modes alias, both paths agree there but do less work
+  auto note = [](size_t i) { return 24 + (int)(i % 48); };
+
+  snprintf(name, sizeof(name), "noteon.%s.update_fc", voice);
+  if (Selected(name)) {
+    Report(name, fs, 1, M, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	v.update_fc(freqs[note(i)]);
+	Escape(&v);
+      }
+    }, BENCH_CALLS));
+  }
+
+  snprintf(name, sizeof(name), "noteon.%s.service", voice);
+  double ns = Time([&](size_t) {
+    table.Init();
+    while (table.Service(v, freqs)) {}
+  }, 1);
+  if (Selected(name)) Report(name, fs, 1, M, 1, "call", ns / TUNING_NOTES);
+
+  snprintf(name, sizeof(name), "noteon.%s.table", voice);
+  if (Selected(name)) {
+    Report(name, fs, 1, M, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	table.Load(v, note(i), freqs[note(i)]);
+	Escape(&v);
+      }
+    }, BENCH_CALLS));
+  }
+}
+
+/*
+ * One voice's expression update, the way a dense MPE stream drives it. Rows are
+ *   expression.<voice>.update_fc  bend by working every mode out again from the fundamental
+ *   expression.<voice>.bend       bend by scaling the modes' frequencies
+ *   expression.<voice>.press      pressure, pole radii only
+ */
+template <typename V>
+static void BenchExpressionVoice(float fs, const char *voice, V &v, float fc, int modes)
+{
+  char name[64];
+  // A slow wobble of up to two semitones, a new value every call
+  auto ratio = [](size_t i) { return powf(2, (float)(i % 200) / 1200); };
+
+  snprintf(name, sizeof(name), "expression.%s.update_fc", voice);
+  if (Selected(name)) {
+    Report(name, fs, 1, modes, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	v.update_fc(fc * ratio(i));
+	Escape(&v);
+      }
+    }, BENCH_CALLS));
+  }
+  v.update_fc(fc);
+
+  snprintf(name, sizeof(name), "expression.%s.bend", voice);
+  if (Selected(name)) {
+    Report(name, fs, 1, modes, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	v.bend(ratio(i));
+	Escape(&v);
+      }
+    }, BENCH_CALLS));
+  }
+  v.bend(1);
+
+  snprintf(name, sizeof(name), "expression.%s.press", voice);
+  if (Selected(name)) {
+    Report(name, fs, 1, modes, 1, "call", Time([&](size_t n) {
+      for (size_t i = 0; i < n; i++) {
+	v.press((i % 128) / 127.0f);
+	Escape(&v);
+      }
+    }, BENCH_CALLS));
+  }
+}
+
+static void BenchExpression(float fs)
+{
+  static modal_note<NUM_HARM_PARTIALS> note;
+  note.init(fs, 110, 0.9999);
+  note.update_stiffness(0.001);
+  BenchExpressionVoice(fs, "modal_note", note, 110, NUM_HARM_PARTIALS);
+
+  static modal_inharm<NUM_INHARM_PARTIALS> inharm;
+  inharm.init(fs, 110, &inharm_presets[0]);
+  BenchExpressionVoice(fs, "modal_inharm", inharm, 110, NUM_INHARM_PARTIALS);
+}
+
+/*
+ * The demo bank's pitched transient played at half, the same and twice its rate,
+ * restarted whenever it ends, a block at a time the way the engine runs it
+ */
+static void BenchExciter(float fs)
+{
+  const int block = 48;
+  static exciter_bank bank;
+  static exciter_kernel kernel;
+  static exciter_voice voice;
+  bank.Attach(exciter_blob, sizeof(exciter_blob));
+  kernel.Init();
+  int bow = 1;
+  float root = bank.Entry(bow).root;
+  float out[block];
+  char name[64];
+  for (float pitch : {0.5f, 1.0f, 2.0f}) {
+    snprintf(name, sizeof(name), "exciter.sample.x%g", pitch);
+    if (!Selected(name)) continue;
+    size_t n = fs * BENCH_SECONDS;
+    Report(name, fs, block, 0, 1, "sample", Time([&](size_t n) {
+      for (size_t done = 0; done < n; done += block) {
+	if (!voice.Playing()) voice.Start(bank, bow, root * pitch, fs);
+	voice.Process(kernel, out, block);
+	Escape(out);
+      }
+    }, n));
+  }
+}
+
+static void BenchPitch(float fs)
+{
+  static modal_note<NUM_HARM_PARTIALS> note;
+  static pitch_table<NUM_HARM_PARTIALS> note_table;
+  note.init(fs, 45, 0.9999);
+  note.update_stiffness(0.001);
+  BenchNoteOn(fs, "modal_note", note, note_table);
+
+  static modal_inharm<NUM_INHARM_PARTIALS> inharm;
+  static pitch_table<NUM_INHARM_PARTIALS> inharm_table;
+  inharm.init(fs, 220, &inharm_presets[0]);
+  BenchNoteOn(fs, "modal_inharm", inharm, inharm_table);
+}
+
+/*
+ * A K note chord of M mode voices, block at a time the way the engine runs it:
+ * chord.notes is K modal_notes, chord.modal_chord one shared excitation bank,
+ * chord.wide a single modal_note with as many modes, what a chord should come close to
+ */
+template <int M, int K>
+static void BenchChord(float fs)
+{
+  const int block = 48;
+  size_t n = fs * BENCH_SECONDS;
+  n -= n % block;
+  std::vector<float> x = MakeExcitation(n);
+  std::vector<float> out(block);
+  const float fcs[4] = {110, 138.6f, 164.8f, 207.7f};
+
+  if (Selected("chord.notes")) {
+    modal_note<M> notes[K];
+    for (int k = 0; k < K; k++) {
+      notes[k].init(fs, fcs[k % 4], 0.9999);
+    }
+    Report("chord.notes", fs, block, M * K, K, "sample", Time([&](size_t n) {
+      for (size_t b = 0; b < n; b += block) {
+	for (int k = 0; k < K; k++) {
+	  notes[k].AddBlock(&x[b], out.data(), block);
+	}
+      }
+      sink = out[0];
+    }, n));
+  }
+
+  if (Selected("chord.modal_chord")) {
+    modal_chord<M, K> chord;
+    chord.init(fs, fcs[0], 0.9999);
+    float fc[K];
+    for (int k = 0; k < K; k++) fc[k] = fcs[k % 4];
+    chord.set_chord(fc, K);
+    Report("chord.modal_chord", fs, block, M * K, 1, "sample", Time([&](size_t n) {
+      for (size_t b = 0; b < n; b += block) {
+	chord.AddBlock(&x[b], out.data(), block);
+      }
+      sink = out[0];
+    }, n));
+  }
+
+  if (Selected("chord.wide")) {
+    modal_note<M * K> wide;
+    wide.init(fs, fcs[0], 0.9999);
+    Report("chord.wide", fs, block, M * K, 1, "sample", Time([&](size_t n) {
+      for (size_t b = 0; b < n; b += block) {
+	wide.AddBlock(&x[b], out.data(), block);
+      }
+      sink = out[0];
+    }, n));
+  }
+}
+
+/*
+ * A bank of voices run the way AudioCallback runs them:
+ * control rate work once per block then every voice per sample
+ */
+template <int M>
+static void BenchBank(float fs, int block, int voices)
+{
+  const int modes = M;
+  if (!Selected("bank.modal_note")) return;
+
+  size_t n = fs * BENCH_SECONDS;
+  n -= n % block;
+  std::vector<float> x = MakeExcitation(n);
+  modal_note<M> notes[BENCH_MAX_VOICES];
+  for (int v = 0; v < voices; v++) {
+    notes[v].init(fs, 45 * (v + 1), 0.9999);
+  }
+  tri_lfo lfo;
+  lfo.Init(fs / block);
+
+  Report("bank.modal_note", fs, block, modes, voices, "sample", Time([&](size_t n) {
+    float acc = 0;
+    for (size_t b = 0; b < n; b += block) {
+      lfo.Process();
+      for (int i = 0; i < block; i++) {
+	float out = 0;
+	for (int v = 0; v < voices; v++) {
+	  out += notes[v].Process(x[b + i]) / voices;
+	}
+	acc += out;
+      }
+    }
+    sink = acc;
+  }, n));
+}
+
+/*
+ * Bytes per mode for the layout the resonators had when every iir_reson was a dumb_biquad
+ * carrying its own cold parameters, against the split hot/cold layout
+ */
+#define OLD_RESON_BYTES (sizeof(dumb_biquad) + 6 * sizeof(float))
+
+static void MemReport()
+{
+  size_t hot = sizeof(reson_hot);
+  size_t cold = sizeof(iir_reson);
+  printf("layout,hot_bytes,cold_bytes,total_bytes\n");
+  printf("old.per_mode,%zu,%zu,%zu\n", (size_t)OLD_RESON_BYTES, (size_t)0, (size_t)OLD_RESON_BYTES);
+  printf("new.per_mode,%zu,%zu,%zu\n", hot, cold, hot + cold);
+  for (int voices : voice_counts) {
+    for (int modes : {NUM_HARM_PARTIALS, NUM_INHARM_PARTIALS, 32}) {
+      printf("old.bank.v%d.m%d,%zu,%zu,%zu\n", voices, modes,
+	  voices * modes * (size_t)OLD_RESON_BYTES, (size_t)0, voices * modes * (size_t)OLD_RESON_BYTES);
+      printf("new.bank.v%d.m%d,%zu,%zu,%zu\n", voices, modes,
+	  voices * modes * hot, voices * modes * cold, voices * modes * (hot + cold));
+    }
+  }
+  printf("new.bank.v64.m32,%zu,%zu,%zu\n", 64 * 32 * hot, 64 * 32 * cold, 64 * 32 * (hot + cold));
+}
+
+// Samples of impulse response the precision report fits
+#define PREC_REPORT_SECONDS 4
+// What the README promises for the modes reson_precision runs: pitch error in cents and SNR in dB
+#define PREC_REPORT_CENTS 0.02
+#define PREC_REPORT_SNR_DB 80
+
+/*
+ * The pole a free response runs on, from a least squares fit of y[n] = c1 y[n-1] + c2 y[n-2].
+ * Returns false if the response died out
+ */
+static bool FitPole(const std::vector<double> &y, double fs, double &fc, double &r)
+{
+  long double s11 = 0, s12 = 0, s22 = 0, s01 = 0, s02 = 0;
+  for (size_t n = 2; n < y.size(); n++) {
+    long double y0 = y[n], y1 = y[n - 1], y2 = y[n - 2];
+    s11 += y1 * y1;
+    s12 += y1 * y2;
+    s22 += y2 * y2;
+    s01 += y0 * y1;
+    s02 += y0 * y2;
+  }
+  long double det = s11 * s22 - s12 * s12;
+  if (det <= 0) return false;
+  long double c1 = (s01 * s22 - s02 * s12) / det;
+  long double c2 = (s02 * s11 - s01 * s12) / det;
+  if (c2 >= 0) return false;
+  long double rr = sqrtl(-c2);
+  long double c = c1 / (2 * rr);
+  if (c > 1) c = 1;
+  fc = acosl(c) * fs / (2 * M_PI);
+  r = rr;
+  return true;
+}
+
+// Pitch error in cents, decay time error in percent and SNR in dB of y against the double reference
+static void PrecisionErrors(const std::vector<double> &y, const std::vector<double> &ref, double fs,
+			    double fc, double r, double &cents, double &decay, double &snr)
+{
+  double sig = 0, err = 0;
+  for (size_t n = 0; n < y.size(); n++) {
+    sig += ref[n] * ref[n];
+    err += (y[n] - ref[n]) * (y[n] - ref[n]);
+  }
+  snr = err > 0 ? 10 * log10(sig / err) : INFINITY;
+  double fit_fc, fit_r;
+  if (!FitPole(y, fs, fit_fc, fit_r) || fit_fc <= 0) {
+    cents = decay = NAN;
+    return;
+  }
+  cents = 1200 * log2(fit_fc / fc);
+  decay = 100 * (log(r) / log(fit_r) - 1);
+}
+
+/*
+ * One mode's impulse response three ways: the plain float loop, reson_precision and a double
+ * recursion on the exact pole, for a grid of frequencies and pole radii at 48kHz.
+ * Returns how many EF and DOUBLE modes miss PREC_REPORT_CENTS or PREC_REPORT_SNR_DB
+ */
+static int PrecisionReport()
+{
+  int failed = 0;
+  static const float fcs[] = {10, 20, 40, 80, 160, 320, 640, 1280, 5000};
+  static const float rs[] = {0.999f, 0.9999f, 0.99999f};
+  static const char *classes[] = {"none", "float", "ef", "double"};
+  const float fs = 48000;
+  size_t n = fs * PREC_REPORT_SECONDS;
+
+  printf("fc,r,class,float_cents,float_decay_pct,float_snr_db,prec_cents,prec_decay_pct,prec_snr_db\n");
+  for (float r : rs) {
+    for (float fc : fcs) {
+      reson_hot plain_hot, prec_hot;
+      iir_reson plain, mode;
+      plain.attach(&plain_hot);
+      mode.attach(&prec_hot);
+      plain.init(fs, fc, r, 1);
+      mode.init(fs, fc, r, 1);
+      reson_precision<1> prec;
+      prec.Init(fs);
+      prec.SetEnabled(true);
+      prec.Update(&mode, &prec_hot, 1);
+
+      double wc = 2 * PREC_PI_D * mode.fc() / fs;
+      double a0 = -2 * (double)mode.r() * cos(wc), a1 = (double)mode.r() * mode.r();
+      double y1 = 0, y2 = 0;
+      std::vector<double> ref(n), yf(n), yp(n);
+      for (size_t i = 0; i < n; i++) {
+	float d = i == 0 ? 1 : 0;
+	double y = prec_hot.b0 * d - a0 * y1 - a1 * y2;
+	y2 = y1;
+	y1 = y;
+	ref[i] = y;
+	yf[i] = reson_process(plain_hot, d);
+	yp[i] = prec.Process(&prec_hot, d, 1);
+      }
+      double fcents, fdecay, fsnr, pcents, pdecay, psnr;
+      PrecisionErrors(yf, ref, fs, mode.fc(), mode.r(), fcents, fdecay, fsnr);
+      PrecisionErrors(yp, ref, fs, mode.fc(), mode.r(), pcents, pdecay, psnr);
+      int cls = reson_precision<1>::Classify(fs, mode.fc(), mode.r());
+      printf("%g,%g,%s,%.4f,%.4f,%.1f,%.4f,%.4f,%.1f\n", fc, r, classes[cls],
+	  fcents, fdecay, fsnr, pcents, pdecay, psnr);
+      // Float modes run the plain loop, the bounds are for the ones reson_precision takes over.
+      // NaN cents (a response that died) fails too
+      if (cls != reson_precision<1>::FLOAT && !(fabs(pcents) <= PREC_REPORT_CENTS && psnr >= PREC_REPORT_SNR_DB)) {
+	fprintf(stderr, "FAIL  %g Hz r %g: %.4f cents, %.1f dB SNR\n", fc, r, pcents, psnr);
+	failed++;
+      }
+    }
+  }
+  return failed;
+}
+
+int main(int argc, char **argv)
+{
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--quick")) {
+      quick = true;
+      reps = 3;
+    } else if (!strcmp(argv[i], "--reps") && i + 1 < argc) {
+      reps = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (!strcmp(argv[i], "--mem")) {
+      MemReport();
+      return 0;
+    } else if (!strcmp(argv[i], "--precision")) {
+      return PrecisionReport() > 0;
+    } else {
+      fprintf(stderr, "usage: %s [--quick] [--reps n] [--filter substring] [--mem] [--precision]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  printf("name,fs,block,modes,voices,unit,ns,per_sec\n");
+
+  for (float fs : sample_rates) {
+    BenchBiquad(fs);
+    BenchKernel<NUM_HARM_PARTIALS>(fs);
+    BenchKernel<32>(fs);
+    BenchCoefs(fs);
+    BenchModalInharm(fs);
+    BenchDecay(fs);
+    BenchCull<64>(fs);
+    if (!quick) BenchCull<128>(fs);
+    BenchMultirate<NUM_HARM_PARTIALS>(fs);
+    BenchMultirate<32>(fs);
+    if (!quick) BenchMultirate<128>(fs);
+    BenchPrecision<NUM_HARM_PARTIALS>(fs);
+    BenchPrecision<32>(fs);
+    BenchOlaCrossover(fs);
+    BenchReverb(fs);
+    BenchIrCache(fs);
+    BenchPitch(fs);
+    BenchExpression(fs);
+    BenchExciter(fs);
+    BenchChord<NUM_HARM_PARTIALS, CHORD_MAX_TONES>(fs);
+    BenchControl(fs);
+    // Voices are sized at compile time
+    BenchModalNote<4>(fs);
+    BenchModalNote<8>(fs);
+    BenchModalNote<16>(fs);
+    if (!quick) {
+      BenchModalNote<32>(fs);
+      BenchModalNote<64>(fs);
+      BenchModalNote<128>(fs);
+    }
+    for (int voices : voice_counts) {
+      for (int block : block_sizes) {
+	if (quick && block != 1 && block != 48) continue;
+	BenchBank<NUM_HARM_PARTIALS>(fs, block, voices);
+	if (!quick) BenchBank<32>(fs, block, voices);
+      }
+    }
+    if (quick) break;
+  }
+
+  return 0;
+}
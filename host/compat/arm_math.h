@@ -0,0 +1,211 @@
+#pragma once
+#ifndef DSY_HOST_ARM_MATH_H
+#define DSY_HOST_ARM_MATH_H
+
+/*
+ * Host stand-in for CMSIS-DSP's arm_math.h
+ * The DSP headers lean on it for PI, the C math library,
+ * with MODAL_CMSIS_BIQUAD the DF1 biquad cascade, and the real FFT modal_ola runs on.
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+typedef float float32_t;
+
+/*
+ * Portable copy of arm_biquad_cascade_df1_f32 from CMSIS-DSP's generic C path
+ * Same state and coefficient layout and the same order of operations,
+ * so it matches the library bit for bit as long as neither side contracts into FMAs.
+ *
+ * Coefficients per stage: b0, b1, b2, a1, a2 with the a terms negated (added, not subtracted)
+ * State per stage: x[n-1], x[n-2], y[n-1], y[n-2]
+ */
+typedef struct
+{
+  uint32_t numStages;
+  float32_t *pState;
+  const float32_t *pCoeffs;
+} arm_biquad_casd_df1_inst_f32;
+
+static inline void arm_biquad_cascade_df1_init_f32(arm_biquad_casd_df1_inst_f32 *S, uint8_t numStages,
+						   const float32_t *pCoeffs, float32_t *pState)
+{
+  S->numStages = numStages;
+  S->pCoeffs = pCoeffs;
+  for (uint32_t i = 0; i < 4u * numStages; i++) {
+    pState[i] = 0.0f;
+  }
+  S->pState = pState;
+}
+
+static inline void arm_biquad_cascade_df1_f32(const arm_biquad_casd_df1_inst_f32 *S, const float32_t *pSrc,
+					      float32_t *pDst, uint32_t blockSize)
+{
+  const float32_t *pIn = pSrc;
+  float32_t *pOut = pDst;
+  float32_t *pState = S->pState;
+  const float32_t *pCoeffs = S->pCoeffs;
+  uint32_t stage = S->numStages;
+
+  do {
+    float32_t b0 = *pCoeffs++;
+    float32_t b1 = *pCoeffs++;
+    float32_t b2 = *pCoeffs++;
+    float32_t a1 = *pCoeffs++;
+    float32_t a2 = *pCoeffs++;
+
+    float32_t Xn1 = pState[0];
+    float32_t Xn2 = pState[1];
+    float32_t Yn1 = pState[2];
+    float32_t Yn2 = pState[3];
+
+    for (uint32_t sample = 0; sample < blockSize; sample++) {
+      float32_t Xn = *pIn++;
+      float32_t acc = (b0 * Xn) + (b1 * Xn1) + (b2 * Xn2) + (a1 * Yn1) + (a2 * Yn2);
+      *pOut++ = acc;
+      Xn2 = Xn1;
+      Xn1 = Xn;
+      Yn2 = Yn1;
+      Yn1 = acc;
+    }
+
+    *pState++ = Xn1;
+    *pState++ = Xn2;
+    *pState++ = Yn1;
+    *pState++ = Yn2;
+
+    // Later stages work in place on the output
+    pIn = pDst;
+    pOut = pDst;
+  } while (--stage > 0u);
+}
+
+typedef enum
+{
+  ARM_MATH_SUCCESS = 0,
+  ARM_MATH_ARGUMENT_ERROR = -1
+} arm_status;
+
+/*
+ * Portable stand-in for arm_rfft_fast_f32, same packing and scaling but not the same arithmetic
+ * An N point real FFT done as an N/2 point complex radix-2 FFT and a split step.
+ * Packing: p[0] = X[0], p[1] = X[N/2] (both real), then re, im of X[1] .. X[N/2 - 1].
+ * The inverse takes that packing and returns the real signal scaled by 1/N overall, as CMSIS does.
+ * CMSIS uses the input as scratch, this one leaves it alone, callers shouldn't rely on either.
+ */
+#define COMPAT_RFFT_MAX 4096
+
+typedef struct
+{
+  uint16_t fftLenRFFT;
+  float32_t twiddle[COMPAT_RFFT_MAX];	// cos, sin of 2 pi k / N for k < N / 2
+} arm_rfft_fast_instance_f32;
+
+static inline arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen)
+{
+  if (fftLen < 32 || fftLen > COMPAT_RFFT_MAX || (fftLen & (fftLen - 1))) {
+    return ARM_MATH_ARGUMENT_ERROR;
+  }
+  S->fftLenRFFT = fftLen;
+  for (uint32_t k = 0; k < fftLen / 2u; k++) {
+    double w = 2 * 3.14159265358979323846 * k / fftLen;
+    S->twiddle[2 * k] = (float32_t)cos(w);
+    S->twiddle[2 * k + 1] = (float32_t)sin(w);
+  }
+  return ARM_MATH_SUCCESS;
+}
+
+// In place complex FFT of m = N / 2 interleaved points, inverse is unscaled
+static inline void compat_cfft_f32(const arm_rfft_fast_instance_f32 *S, float32_t *z, uint32_t m, int inverse)
+{
+  for (uint32_t i = 1, j = 0; i < m; i++) {
+    uint32_t bit = m >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) {
+      float32_t t;
+      t = z[2 * i]; z[2 * i] = z[2 * j]; z[2 * j] = t;
+      t = z[2 * i + 1]; z[2 * i + 1] = z[2 * j + 1]; z[2 * j + 1] = t;
+    }
+  }
+  float32_t sign = inverse ? 1.0f : -1.0f;
+  for (uint32_t len = 2; len <= m; len <<= 1) {
+    // The table is for N = 2m points
+    uint32_t stride = 2 * m / len;
+    for (uint32_t i = 0; i < m; i += len) {
+      for (uint32_t k = 0; k < len / 2; k++) {
+	float32_t wr = S->twiddle[2 * k * stride];
+	float32_t wi = sign * S->twiddle[2 * k * stride + 1];
+	float32_t *a = &z[2 * (i + k)];
+	float32_t *b = &z[2 * (i + k + len / 2)];
+	float32_t tr = b[0] * wr - b[1] * wi;
+	float32_t ti = b[0] * wi + b[1] * wr;
+	b[0] = a[0] - tr;
+	b[1] = a[1] - ti;
+	a[0] += tr;
+	a[1] += ti;
+      }
+    }
+  }
+}
+
+static inline void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut,
+				     uint8_t ifftFlag)
+{
+  uint32_t n = S->fftLenRFFT;
+  uint32_t m = n / 2;
+  const float32_t *tw = S->twiddle;
+
+  if (!ifftFlag) {
+    // Even samples as real, odd as imaginary
+    for (uint32_t i = 0; i < n; i++) pOut[i] = p[i];
+    compat_cfft_f32(S, pOut, m, 0);
+
+    float32_t z0r = pOut[0], z0i = pOut[1];
+    pOut[0] = z0r + z0i;
+    pOut[1] = z0r - z0i;
+    for (uint32_t k = 1; k <= m / 2; k++) {
+      float32_t *a = &pOut[2 * k];
+      float32_t *b = &pOut[2 * (m - k)];
+      // Even and odd halves' spectra at k
+      float32_t er = 0.5f * (a[0] + b[0]), ei = 0.5f * (a[1] - b[1]);
+      float32_t or_ = 0.5f * (a[1] + b[1]), oi = -0.5f * (a[0] - b[0]);
+      float32_t wr = tw[2 * k], wi = -tw[2 * k + 1];
+      float32_t tr = or_ * wr - oi * wi, ti = or_ * wi + oi * wr;
+      // X[k] = E + W^k O, X[m - k] = conj(E - W^k O)
+      a[0] = er + tr;
+      a[1] = ei + ti;
+      b[0] = er - tr;
+      b[1] = -(ei - ti);
+    }
+  } else {
+    float32_t x0 = p[0], xm = p[1];
+    pOut[0] = 0.5f * (x0 + xm);
+    pOut[1] = 0.5f * (x0 - xm);
+    for (uint32_t k = 1; k <= m / 2; k++) {
+      const float32_t *a = &p[2 * k];
+      const float32_t *b = &p[2 * (m - k)];
+      float32_t er = 0.5f * (a[0] + b[0]), ei = 0.5f * (a[1] - b[1]);
+      float32_t dr = 0.5f * (a[0] - b[0]), di = 0.5f * (a[1] + b[1]);
+      float32_t wr = tw[2 * k], wi = tw[2 * k + 1];
+      // O = (X[k] - conj X[m - k]) / 2 * W^-k, Z = E + jO
+      float32_t or_ = dr * wr - di * wi, oi = dr * wi + di * wr;
+      float32_t *za = &pOut[2 * k];
+      float32_t *zb = &pOut[2 * (m - k)];
+      za[0] = er - oi;
+      za[1] = ei + or_;
+      // At m - k, E and O are conjugated
+      zb[0] = er + oi;
+      zb[1] = -ei + or_;
+    }
+    compat_cfft_f32(S, pOut, m, 1);
+    for (uint32_t i = 0; i < n; i++) pOut[i] *= 1.0f / m;
+  }
+}
+
+#endif
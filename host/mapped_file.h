@@ -0,0 +1,66 @@
+#pragma once
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <stddef.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/*
+ * A whole file mapped read only, for handing banks to the engine without reading them in.
+ * Pages are faulted in as they are first read, touch them before rendering against a deadline
+ */
+class mapped_file
+{
+  public:
+    mapped_file() {}
+    ~mapped_file() { Close(); }
+    mapped_file(const mapped_file &) = delete;
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    bool Open(const char *path)
+    {
+      Close();
+      int fd = open(path, O_RDONLY);
+      if (fd < 0) return false;
+      struct stat st;
+      if (fstat(fd, &st) < 0 || st.st_size == 0) {
+	close(fd);
+	return false;
+      }
+      void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      // The mapping outlives the descriptor
+      close(fd);
+      if (p == MAP_FAILED) return false;
+      data_ = p;
+      size_ = st.st_size;
+      return true;
+    }
+
+    void Close()
+    {
+      if (data_) munmap(data_, size_);
+      data_ = nullptr;
+      size_ = 0;
+    }
+
+    // Read every page once so the audio side never waits on the disk
+    void Prefault()
+    {
+      volatile const unsigned char *p = (const unsigned char *)data_;
+      long page = sysconf(_SC_PAGESIZE);
+      for (size_t i = 0; i < size_; i += page) {
+	(void)p[i];
+      }
+    }
+
+    const void *Data() const { return data_; }
+    size_t Size() const { return size_; }
+
+  private:
+    void *data_ = nullptr;
+    size_t size_ = 0;
+};
+#endif
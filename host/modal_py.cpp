@@ -0,0 +1,286 @@
+/*
+ * Python bindings for modal_engine, the voices and the inharmonic preset bank,
+ * for sweeps and analysis at native speed.
+ *
+ *   make -C host python		(needs pybind11 and NumPy)
+ *   make -C host python-check	(builds it and runs modal_py_smoke.py)
+ *   PYTHONPATH=host python3 -c "import modal"
+ *
+ * Audio is float32 NumPy arrays, one dimensional and C contiguous, read and written where
+ * they are. Anything else is refused rather than copied, rows of a (2, n) array are fine.
+ * The GIL is released while rendering so engines in separate threads render in parallel,
+ * an instance itself is only for one thread at a time.
+ *
+ *   eng = modal.Engine(48000, 48)
+ *   eng.stiffness = 0.003
+ *   eng.note_on(60, 100)
+ *   out = np.zeros((2, 48), np.float32)
+ *   eng.process(np.zeros(48, np.float32), out[0], out[1])
+ *
+ * Parameters set as attributes take effect at the next block, as a pot move does.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include <pybind11/pybind11.h>
+#include <pybind11/numpy.h>
+
+#include "modal_engine.h"
+
+namespace py = pybind11;
+using namespace daisysp;
+
+typedef py::array_t<float, py::array::c_style> f32_array;
+// For tables rather than audio, converted from whatever the caller has
+typedef py::array_t<float, py::array::c_style | py::array::forcecast> f32_values;
+typedef modal_note<NUM_HARM_PARTIALS> py_note;
+typedef modal_inharm<NUM_INHARM_PARTIALS> py_inharm;
+
+// Checked before the GIL is let go, the pointers stay good while the caller holds the arrays
+static const float *In(const f32_array &a, const char *name)
+{
+  if (a.ndim() != 1) throw py::value_error(std::string(name) + " must be one dimensional");
+  return a.data();
+}
+
+static float *Out(f32_array &a, const char *name, size_t size)
+{
+  if (a.ndim() != 1 || (size_t)a.size() != size) {
+    throw py::value_error(std::string(name) + " must be one dimensional and as long as the input");
+  }
+  return a.mutable_data();
+}
+
+/*
+ * The engine, with the exciter bank it plays from.
+ * bank_owner keeps the bank's memory alive, Attach only points into it
+ */
+struct py_engine
+{
+  modal_engine e;
+  exciter_bank bank;
+  py::object bank_owner;
+};
+
+// Parameters settable as attributes, in their own units, see modal_engine::SetParam
+typedef struct {
+  const char *name;
+  param_id id;
+} py_param;
+
+static const py_param params[] = {
+  // A level for harmonic voices and a modulation amount for inharmonic ones, as on the pot
+  {"gain",	      PARAM_G},
+  {"stiffness",	      PARAM_STIFF},
+  {"beta",	      PARAM_BETA},
+  {"mgf",	      PARAM_MGF},
+  {"ifc",	      PARAM_IFC},
+  {"res",	      PARAM_RES},
+  {"attack",	      PARAM_AT},
+  {"decay",	      PARAM_DT},
+  {"lfo_ifc_rate",    PARAM_LFO_IFC_RATE},
+  {"lfo_ifc_depth",   PARAM_LFO_IFC_DEPTH},
+  {"lfo_stiff_rate",  PARAM_LFO_STIFF_RATE},
+  {"lfo_stiff_depth", PARAM_LFO_STIFF_DEPTH},
+  {"lfo_beta_rate",   PARAM_LFO_BETA_RATE},
+  {"lfo_beta_depth",  PARAM_LFO_BETA_DEPTH},
+};
+
+static void EngineProcess(py_engine &self, const f32_array &in, f32_array &out_l, f32_array &out_r)
+{
+  const float *src = In(in, "in");
+  size_t size = in.size();
+  float *l = Out(out_l, "out_l", size);
+  float *r = Out(out_r, "out_r", size);
+  py::gil_scoped_release unlocked;
+  self.e.Process(src, l, r, size);
+}
+
+static void EngineSetMode(py_engine &self, ui_mode mode)
+{
+  if (mode < PING || mode >= LAST_MODE) throw py::value_error("no such mode");
+  while (self.e.Mode() != mode) {
+    self.e.NextMode();
+  }
+}
+
+static void EngineSetExciters(py_engine &self, py::buffer blob)
+{
+  py::buffer_info info = blob.request();
+  if (!self.bank.Attach(info.ptr, info.size * info.itemsize)) {
+    throw py::value_error("not an exciter bank, see tools/wav_to_exciters.py --bin");
+  }
+  self.bank_owner = blob;
+  self.e.SetExciters(&self.bank);
+}
+
+// The voices' block versions add into their output, these write it
+template <typename V>
+static void VoiceProcess(V &self, const f32_array &in, f32_array &out)
+{
+  const float *src = In(in, "in");
+  size_t size = in.size();
+  float *dst = Out(out, "out", size);
+  py::gil_scoped_release unlocked;
+  memset(dst, 0, size * sizeof(float));
+  self.AddBlock(src, dst, size);
+}
+
+// (fc, r, peak) of the modes that sound
+template <typename V, int N>
+static py::tuple VoiceResonances(const V &self)
+{
+  float fc[N], r[N], peak[N];
+  int n = self.resonances(fc, r, peak);
+  return py::make_tuple(f32_array(n, fc), f32_array(n, r), f32_array(n, peak));
+}
+
+static inharm_preset &Preset(int i)
+{
+  if (i < 0 || i >= NUM_INHARM_PRESETS) throw py::index_error("no such preset");
+  return inharm_presets[i];
+}
+
+/*
+ * Presets are copied in and out. The bank is shared by every engine and voice,
+ * an edit is heard from each one's next load_preset
+ */
+static py::dict GetPreset(int i)
+{
+  const inharm_preset &p = Preset(i);
+  py::dict d;
+  d["modes"] = f32_array(p.num_modes, p.modes);
+  d["res"] = f32_array(p.num_modes, p.res);
+  d["gains"] = f32_array(p.num_modes, p.gains);
+  return d;
+}
+
+static void SetPreset(int i, const f32_values &modes, const f32_values &res, const f32_values &gains)
+{
+  inharm_preset &p = Preset(i);
+  py::ssize_t n = modes.size();
+  if (n < 1 || n > NUM_INHARM_PARTIALS || res.size() != n || gains.size() != n) {
+    throw py::value_error("modes, res and gains must be the same length, 1 to " + std::to_string(NUM_INHARM_PARTIALS));
+  }
+  p.num_modes = n;
+  for (py::ssize_t k = 0; k < n; k++) {
+    p.modes[k] = modes.data()[k];
+    p.res[k] = res.data()[k];
+    p.gains[k] = gains.data()[k];
+  }
+}
+
+PYBIND11_MODULE(modal, m)
+{
+  m.doc() = "ModalResonators engine, voices and inharmonic presets";
+  m.attr("NUM_NOTES") = NUM_NOTES;
+  m.attr("NUM_HARM_PARTIALS") = NUM_HARM_PARTIALS;
+  m.attr("NUM_INHARM_PARTIALS") = NUM_INHARM_PARTIALS;
+  m.attr("NUM_PRESETS") = NUM_INHARM_PRESETS;
+
+  py::enum_<ui_mode>(m, "Mode")
+    .value("PING", PING)
+    .value("NOISE_ENV", NOISE_ENV)
+    .value("EXT", EXT)
+    .value("EXT_ENV", EXT_ENV)
+    .value("INHARM", INHARM)
+    .value("INHARM_NOISE", INHARM_NOISE)
+    .value("SAMPLE", SAMPLE);
+
+  py::enum_<ui_output_mode>(m, "Output")
+    .value("NONE", NONE)
+    .value("EXP_DIST", EXP_DIST)
+    .value("TANH", TANH)
+    .value("ARCTAN", ARCTAN);
+
+  py::class_<py_engine> engine(m, "Engine");
+  engine
+    // block is how many samples each process call is meant to take, the control rate follows from it
+    .def(py::init([](float sr, int block) {
+	if (!(sr > 0) || block < 1) throw py::value_error("sample rate and block must be positive");
+	py_engine *self = new py_engine;
+	self->e.Init(sr, sr / block);
+	return self;
+      }), py::arg("sample_rate") = 48000.0f, py::arg("block") = 48)
+    .def("process", &EngineProcess, py::arg("in").noconvert(), py::arg("out_l").noconvert(), py::arg("out_r").noconvert(),
+	 "Render one block of in into out_l and out_r, all float32 and the same length")
+    .def("seed_noise", [](py_engine &self, uint32_t seed) { self.e.SeedNoise(seed); })
+    .def("note_on", [](py_engine &self, uint8_t note, uint8_t velocity, int channel) { self.e.NoteOn(note, velocity, channel); },
+	 py::arg("note"), py::arg("velocity"), py::arg("channel") = 0)
+    .def("control_change", [](py_engine &self, uint8_t cc, uint8_t value, int channel) { self.e.ControlChange(cc, value, channel); },
+	 py::arg("cc"), py::arg("value"), py::arg("channel") = 0)
+    .def("pitch_bend", [](py_engine &self, int16_t value, int channel) { self.e.PitchBend(value, channel); },
+	 py::arg("value"), py::arg("channel") = 0)
+    .def("channel_pressure", [](py_engine &self, uint8_t value, int channel) { self.e.ChannelPressure(value, channel); },
+	 py::arg("value"), py::arg("channel") = 0)
+    .def("poly_pressure", [](py_engine &self, uint8_t note, uint8_t value, int channel) { self.e.PolyPressure(note, value, channel); },
+	 py::arg("note"), py::arg("value"), py::arg("channel") = 0)
+    .def_property("mode", [](py_engine &self) { return self.e.Mode(); }, &EngineSetMode)
+    .def_property("preset", [](py_engine &self) { return self.e.Preset(); },
+	[](py_engine &self, int i) { Preset(i); self.e.LoadPreset(i); })
+    .def("set_output_mode", [](py_engine &self, ui_output_mode mode) { self.e.SetOutputMode(mode); })
+    .def("set_width", [](py_engine &self, float width) { self.e.SetWidth(width); })
+    .def("set_spread", [](py_engine &self, float voices, float modes) { self.e.SetSpread(voices, modes); })
+    .def("set_chord", [](py_engine &self, int shape) { self.e.SetChord(shape); })
+    .def("set_sympathetic", [](py_engine &self, float amount) { self.e.SetSympathetic(amount); })
+    .def("set_mpe", [](py_engine &self, int members) { self.e.SetMpe(members); })
+    .def("set_precision", [](py_engine &self, bool on) { self.e.SetPrecision(on); })
+    .def("set_multirate", [](py_engine &self, bool on) { self.e.SetMultirate(on); })
+    .def("set_mode_budget", [](py_engine &self, int total) { self.e.SetModeBudget(total); })
+    .def("set_exciters", &EngineSetExciters, "Play SAMPLE mode from a bank made by tools/wav_to_exciters.py --bin, bytes or any buffer")
+    .def("set_exciter", [](py_engine &self, int i) { self.e.SetExciter(i); })
+    .def("live_voices", [](py_engine &self) { return self.e.LiveVoices(); });
+
+  for (const py_param &p : params) {
+    const py_param *pp = &p;
+    engine.def_property(p.name,
+	[pp](py_engine &self) { return self.e.Param(pp->id); },
+	[pp](py_engine &self, float val) { self.e.SetParam(pp->id, val); });
+  }
+
+  py::class_<py_note>(m, "Note", "One harmonic voice, modal_note")
+    .def(py::init([](float fs, float fc, float r) {
+	py_note *self = new py_note;
+	self->init(fs, fc, r);
+	return self;
+      }), py::arg("fs") = 48000.0f, py::arg("fc") = 45.0f, py::arg("r") = 0.9999f)
+    .def("process", &VoiceProcess<py_note>, py::arg("in").noconvert(), py::arg("out").noconvert())
+    .def("resonances", &VoiceResonances<py_note, NUM_HARM_PARTIALS>)
+    .def("update_fc", &py_note::update_fc)
+    .def("update_r", &py_note::update_r)
+    .def("update_g", &py_note::update_g)
+    .def("update_stiffness", &py_note::update_stiffness)
+    .def("update_beta", &py_note::update_beta)
+    .def("update_mgf", &py_note::update_mgf)
+    .def("update_ifc", &py_note::update_ifc)
+    .def("bend", &py_note::bend)
+    .def("press", &py_note::press)
+    .def("set_mode_budget", &py_note::set_mode_budget)
+    .def("set_precision", &py_note::set_precision)
+    .def("clear", &py_note::clear);
+
+  py::class_<py_inharm>(m, "Inharm", "One inharmonic voice, modal_inharm")
+    .def(py::init([](float fs, float fc, int preset) {
+	inharm_preset &p = Preset(preset);
+	py_inharm *self = new py_inharm;
+	self->init(fs, fc, &p);
+	return self;
+      }), py::arg("fs") = 48000.0f, py::arg("fc") = 45.0f, py::arg("preset") = 0)
+    .def("process", &VoiceProcess<py_inharm>, py::arg("in").noconvert(), py::arg("out").noconvert())
+    .def("resonances", &VoiceResonances<py_inharm, NUM_INHARM_PARTIALS>)
+    .def("load_preset", [](py_inharm &self, int i) { self.load_preset(&Preset(i)); })
+    .def("update_fc", &py_inharm::update_fc)
+    .def("modulate_r", &py_inharm::modulate_r)
+    .def("modulate_g", &py_inharm::modulate_g)
+    .def("update_ifc", &py_inharm::update_ifc)
+    .def("bend", &py_inharm::bend)
+    .def("press", &py_inharm::press)
+    .def("set_mode_budget", &py_inharm::set_mode_budget)
+    .def("set_precision", &py_inharm::set_precision)
+    .def("clear", &py_inharm::clear);
+
+  m.def("preset", &GetPreset, "Preset i as a dict of modes, res and gains");
+  m.def("set_preset", &SetPreset, py::arg("i"), py::arg("modes"), py::arg("res"), py::arg("gains"),
+	"Overwrite preset i, engines and voices pick it up when they next load it");
+}
@@ -0,0 +1,109 @@
+#!/usr/bin/env python3
+"""
+Smoke test for the modal module built from modal_py.cpp.
+
+    make -C host python-check
+    PYTHONPATH=host python3 host/modal_py_smoke.py
+
+Builds an engine and a voice, plays a note through each and checks the output is finite
+and not silent. Then renders two engines from two threads at once and checks they match
+the same engines rendered one after the other. While a thread is inside one long process
+call the main thread has to keep running Python, which it only can if process lets go
+of the GIL.
+Exits non zero on the first failure.
+"""
+
+import sys
+import threading
+import time
+
+import numpy as np
+
+import modal
+
+SR = 48000
+BLOCK = 48
+
+
+def check(ok, what):
+    if not ok:
+        sys.exit("FAIL " + what)
+    print("ok   " + what)
+
+
+def render(eng, blocks, note):
+    """blocks of BLOCK samples from eng after a note_on, left and right one after the other"""
+    eng.note_on(note, 100)
+    silence = np.zeros(BLOCK, np.float32)
+    out = np.zeros((2, blocks * BLOCK), np.float32)
+    for b in range(blocks):
+        s = slice(b * BLOCK, (b + 1) * BLOCK)
+        eng.process(silence, out[0, s], out[1, s])
+    return out
+
+
+def engine():
+    eng = modal.Engine(SR, BLOCK)
+    eng.stiffness = 0.003
+    return eng
+
+
+def main():
+    out = render(engine(), SR // BLOCK, 60)
+    check(np.all(np.isfinite(out)), "engine output is finite")
+    check(np.max(np.abs(out)) > 0, "engine note sounds")
+
+    note = modal.Note(SR, 220.0)
+    ping = np.zeros(SR, np.float32)
+    ping[0] = 1
+    voice = np.zeros(SR, np.float32)
+    note.process(ping, voice)
+    check(np.all(np.isfinite(voice)) and np.max(np.abs(voice)) > 0, "modal_note rings finite")
+
+    # Two engines, each on its own thread, against the same two one after the other
+    blocks = 4 * SR // BLOCK
+    serial = [render(engine(), blocks, n) for n in (48, 55)]
+    results = [None, None]
+
+    def run(k, n):
+        results[k] = render(engine(), blocks, n)
+
+    threads = [threading.Thread(target=run, args=(k, n)) for k, n in enumerate((48, 55))]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+    check(all(np.array_equal(a, b) for a, b in zip(serial, results)), "threaded engines match serial renders")
+
+    # One long process call on a thread. Holding the GIL would stall the main thread for all of it
+    eng = engine()
+    eng.note_on(60, 100)
+    n = 30 * SR
+    silence = np.zeros(n, np.float32)
+    left = np.zeros(n, np.float32)
+    right = np.zeros(n, np.float32)
+    took = []
+
+    def long_block():
+        t0 = time.perf_counter()
+        eng.process(silence, left, right)
+        took.append(time.perf_counter() - t0)
+
+    # Timed from before start, which can itself wait on the thread, to after it has ended
+    t = threading.Thread(target=long_block)
+    last = time.perf_counter()
+    stall = 0
+    t.start()
+    while t.is_alive():
+        now = time.perf_counter()
+        stall = max(stall, now - last)
+        last = now
+    stall = max(stall, time.perf_counter() - last)
+    t.join()
+    check(np.all(np.isfinite(left)), "long block is finite")
+    check(stall < took[0] / 2, "GIL released during process, main thread stalled %.0f ms of %.0f"
+          % (stall * 1e3, took[0] * 1e3))
+
+
+if __name__ == "__main__":
+    main()
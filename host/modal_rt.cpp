@@ -0,0 +1,618 @@
+/*
+ * Run modal_engine live on Linux without a Pod: raw PCM and MIDI bytes in from pipes
+ * or files, raw PCM out, block by block on a real-time thread.
+ *
+ *   modal_rt [--in file|-] [--in-channels n] [--midi file|-] [--out file|-] [--format f32|s16]
+ *            [--sr rate] [--block n] [--seconds s] [--freerun] [--cpu n] [--prio n]
+ *            [--report s] [--timing file] [--no-governor] [--exciters bank]
+ *
+ * PCM is interleaved and native endian, input of any channel count is mixed to the engine's
+ * mono input and output is stereo. Without --in the input is silence, output goes to stdout
+ * unless --out names a file. MIDI is a raw byte stream, as from a serial port or
+ * `amidi -d`, with running status. Messages are applied as the bytes arrive.
+ *
+ * The audio thread does what the firmware's AudioCallback and main loop do to the engine,
+ * with the same settings: it applies the MIDI that has arrived, renders a block, reports
+ * its load to the governor and services the note-on tables. It runs SCHED_FIFO at --prio,
+ * pinned to --cpu if given, with all memory locked, and only talks to the I/O threads
+ * through spsc_rings, so it never waits on a lock, the disk or the allocator.
+ * Without privileges for real-time scheduling or mlock it warns and carries on.
+ *
+ * By default blocks are paced by the clock, one every block / sr seconds. Input that
+ * hasn't arrived in time is an underrun (silence), output with nowhere to go an overrun
+ * (dropped). --freerun renders as fast as input arrives and output is taken instead, for
+ * soak tests and for timing the engine on its own.
+ *
+ * Every --report seconds a line of per-block timing goes to stderr: how late the thread
+ * woke for each block, how long Process took, the load that gives and the xruns.
+ * The run ends with percentiles of both, and --timing writes every block's as CSV.
+ * Stops at the end of the input, after --seconds, or on SIGINT or SIGTERM.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
+#include <signal.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <atomic>
+
+#include "modal_engine.h"
+#include "exciter_blob.h"
+#include "mapped_file.h"
+#include "spsc_ring.h"
+
+using namespace daisysp;
+
+#define RT_MAX_BLOCK	1024
+#define RT_MAX_CHANNELS	16
+// Frames buffered between the I/O threads and the audio thread, about 0.7 s at 48k
+#define RT_RING_FRAMES	(1 << 15)
+#define RT_MIDI_RING	1024
+#define RT_TIMING_RING	(1 << 14)
+// Stack the audio thread touches before it starts, so it never faults a page in
+#define RT_STACK_PREFAULT (256 * 1024)
+// Timing histogram, 1 us buckets
+#define RT_HIST_US	20000
+// How often the I/O threads look again when they have to wait, in us
+#define RT_IO_POLL_US	1000
+// CpuLoadMeter's default smoothing, as the firmware feeds the governor
+#define LOAD_CUTOFF_HZ	1.0f
+// As the firmware listens
+#define MIDI_CHANNEL	0
+
+typedef struct {
+  uint8_t status, data1, data2;
+} midi_msg;
+
+typedef struct {
+  uint32_t block;
+  uint32_t late_ns;		// how long after its deadline the audio thread woke
+  uint32_t process_ns;		// in Process
+} block_timing;
+
+typedef enum {FMT_F32, FMT_S16} pcm_format;
+
+static modal_engine engine;
+static exciter_bank exciters;
+
+static spsc_ring<float, RT_RING_FRAMES> in_ring;
+static spsc_ring<float, RT_RING_FRAMES * 2> out_ring;
+static spsc_ring<midi_msg, RT_MIDI_RING> midi_ring;
+static spsc_ring<block_timing, RT_TIMING_RING> timing_ring;
+
+static float sr = 48000;
+static int block = 48;
+static int in_channels = 1;
+static pcm_format format = FMT_F32;
+static bool freerun = false;
+static bool governed = true;
+static int cpu = -1;
+static int prio = 80;
+static int in_fd = -1, midi_fd = -1, out_fd = 1;
+
+static std::atomic<bool> stop{false};
+static std::atomic<bool> in_done{false};
+static std::atomic<bool> audio_done{false};
+static std::atomic<uint32_t> underruns{0}, overruns{0}, midi_drops{0};
+static uint64_t max_blocks = 0;
+
+static void OnSignal(int)
+{
+  stop.store(true);
+}
+
+static uint64_t Now()
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+// Waits up to RT_IO_POLL_US for fd to have something to read, false on timeout
+static bool Readable(int fd)
+{
+  struct pollfd p = {fd, POLLIN, 0};
+  return poll(&p, 1, RT_IO_POLL_US / 1000) > 0;
+}
+
+/*
+ * Input thread: raw PCM to mono floats. Waits for room rather than dropping,
+ * in paced mode the audio thread's underruns say when it falls behind
+ */
+static void *InputThread(void *)
+{
+  const size_t frame_bytes = in_channels * (format == FMT_F32 ? 4 : 2);
+  static uint8_t raw[RT_MAX_BLOCK * RT_MAX_CHANNELS * 4];
+  static float mono[RT_MAX_BLOCK];
+  size_t have = 0;
+  while (!stop.load()) {
+    if (in_ring.Space() < RT_MAX_BLOCK) {
+      usleep(RT_IO_POLL_US);
+      continue;
+    }
+    if (!Readable(in_fd)) continue;
+    // At most a block of frames at a time, as many as mono holds
+    ssize_t got = read(in_fd, raw + have, RT_MAX_BLOCK * frame_bytes - have);
+    if (got < 0 && errno == EINTR) continue;
+    if (got <= 0) break;
+    have += got;
+    size_t frames = have / frame_bytes;
+    for (size_t f = 0; f < frames; f++) {
+      float sum = 0;
+      for (int c = 0; c < in_channels; c++) {
+	size_t at = f * frame_bytes;
+	if (format == FMT_F32) {
+	  float x;
+	  memcpy(&x, raw + at + c * 4, 4);
+	  sum += x;
+	} else {
+	  int16_t x;
+	  memcpy(&x, raw + at + c * 2, 2);
+	  sum += x * (1.0f / 32768);
+	}
+      }
+      mono[f] = sum / in_channels;
+    }
+    in_ring.Write(mono, frames);
+    // A partial frame waits for the rest
+    memmove(raw, raw + frames * frame_bytes, have - frames * frame_bytes);
+    have -= frames * frame_bytes;
+  }
+  in_done.store(true);
+  return nullptr;
+}
+
+// Bytes in a channel message after its status, 0 for system messages
+static int MidiDataBytes(uint8_t status)
+{
+  switch (status & 0xf0) {
+    case 0x80: case 0x90: case 0xa0: case 0xb0: case 0xe0: return 2;
+    case 0xc0: case 0xd0: return 1;
+    default: return 0;
+  }
+}
+
+/*
+ * MIDI thread: parses the byte stream into channel messages.
+ * System messages are skipped, real-time bytes in the middle of a message don't break it
+ */
+static void *MidiThread(void *)
+{
+  uint8_t bytes[256];
+  uint8_t status = 0;
+  uint8_t data[2];
+  int need = 0, have = 0;
+  while (!stop.load()) {
+    if (!Readable(midi_fd)) continue;
+    ssize_t got = read(midi_fd, bytes, sizeof(bytes));
+    if (got < 0 && errno == EINTR) continue;
+    if (got <= 0) break;
+    for (ssize_t i = 0; i < got; i++) {
+      uint8_t b = bytes[i];
+      if (b >= 0xf8) continue;
+      if (b & 0x80) {
+	// System common messages cancel running status
+	status = b < 0xf0 ? b : 0;
+	need = status ? MidiDataBytes(status) : 0;
+	have = 0;
+	continue;
+      }
+      if (!status || !need) continue;
+      data[have++] = b;
+      if (have < need) continue;
+      have = 0;
+      midi_msg m = {status, data[0], (uint8_t)(need > 1 ? data[1] : 0)};
+      if (!midi_ring.Push(m)) midi_drops++;
+    }
+  }
+  return nullptr;
+}
+
+// As the firmware's HandleMidiMessage
+static void HandleMidiMessage(const midi_msg &m)
+{
+  int channel = m.status & 0x0f;
+  if (channel != MIDI_CHANNEL && !engine.MpeMember(channel)) return;
+  switch (m.status & 0xf0) {
+    case 0x90: engine.NoteOn(m.data1, m.data2, channel); break;
+    case 0xe0: engine.PitchBend((int16_t)(((m.data2 << 7) | m.data1) - 8192), channel); break;
+    case 0xd0: engine.ChannelPressure(m.data1, channel); break;
+    case 0xa0: engine.PolyPressure(m.data1, m.data2, channel); break;
+    case 0xb0: engine.ControlChange(m.data1, m.data2, channel); break;
+    default: break;
+  }
+}
+
+// Output thread: stereo floats to raw PCM, waiting on the reader
+static void *OutputThread(void *)
+{
+  static float frames[RT_MAX_BLOCK * 2];
+  static uint8_t raw[RT_MAX_BLOCK * 2 * 4];
+  for (;;) {
+    size_t n = out_ring.Read(frames, RT_MAX_BLOCK * 2);
+    if (n == 0) {
+      if (audio_done.load() && out_ring.Size() == 0) break;
+      usleep(RT_IO_POLL_US);
+      continue;
+    }
+    size_t bytes;
+    if (format == FMT_F32) {
+      bytes = n * 4;
+      memcpy(raw, frames, bytes);
+    } else {
+      bytes = n * 2;
+      for (size_t i = 0; i < n; i++) {
+	float x = fminf(1.0f, fmaxf(-1.0f, frames[i]));
+	int16_t s = (int16_t)lrintf(x * 32767);
+	memcpy(raw + i * 2, &s, 2);
+      }
+    }
+    for (size_t done = 0; done < bytes;) {
+      ssize_t w = write(out_fd, raw + done, bytes - done);
+      if (w < 0 && errno == EINTR) continue;
+      if (w <= 0) {
+	// The reader went away
+	stop.store(true);
+	return nullptr;
+      }
+      done += w;
+    }
+  }
+  return nullptr;
+}
+
+static void Prefault()
+{
+  volatile unsigned char stack[RT_STACK_PREFAULT];
+  for (size_t i = 0; i < sizeof(stack); i += 4096) {
+    stack[i] = 0;
+  }
+}
+
+static void *AudioThread(void *)
+{
+  Prefault();
+  static float in[RT_MAX_BLOCK], l[RT_MAX_BLOCK], r[RT_MAX_BLOCK], lr[RT_MAX_BLOCK * 2];
+  const uint64_t period = (uint64_t)(1e9 * block / sr);
+  const float load_coef = 1 - expf(-2 * (float)M_PI * LOAD_CUTOFF_HZ * block / sr);
+  float load = -1;
+  uint64_t deadline = Now();
+
+  for (uint32_t b = 0; !stop.load() && (!max_blocks || b < max_blocks); b++) {
+    uint64_t late = 0;
+    if (freerun) {
+      // Wait for a whole block of input, or its end, and room for the output
+      while (!stop.load() && in_fd >= 0 && in_ring.Size() < (size_t)block && !in_done.load()) {
+	usleep(RT_IO_POLL_US / 10);
+      }
+      while (!stop.load() && out_ring.Space() < (size_t)block * 2) {
+	usleep(RT_IO_POLL_US / 10);
+      }
+    } else {
+      deadline += period;
+      struct timespec ts = {(time_t)(deadline / 1000000000ull), (long)(deadline % 1000000000ull)};
+      while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+      uint64_t woke = Now();
+      late = woke > deadline ? woke - deadline : 0;
+    }
+
+    midi_msg m;
+    while (midi_ring.Pop(m)) {
+      HandleMidiMessage(m);
+    }
+
+    size_t got = in_fd >= 0 ? in_ring.Read(in, block) : 0;
+    if (in_fd >= 0 && got < (size_t)block) {
+      if (in_done.load() && in_ring.Size() == 0) break;
+      underruns++;
+    }
+    for (size_t i = got; i < (size_t)block; i++) {
+      in[i] = 0;
+    }
+
+    uint64_t t0 = Now();
+    engine.Process(in, l, r, block);
+    uint64_t dt = Now() - t0;
+
+    float block_load = (float)dt / period;
+    load = load < 0 ? block_load : load + load_coef * (block_load - load);
+    engine.ReportLoad(load);
+
+    for (int i = 0; i < block; i++) {
+      lr[2 * i] = l[i];
+      lr[2 * i + 1] = r[i];
+    }
+    if (out_ring.Write(lr, block * 2) < (size_t)block * 2) overruns++;
+
+    block_timing t = {b, (uint32_t)(late < UINT32_MAX ? late : UINT32_MAX), (uint32_t)(dt < UINT32_MAX ? dt : UINT32_MAX)};
+    timing_ring.Push(t);
+
+    // The main loop's share
+    engine.ServicePitch();
+  }
+  audio_done.store(true);
+  return nullptr;
+}
+
+// Audio thread at SCHED_FIFO prio on cpu, or an ordinary one if that isn't allowed
+static bool StartAudio(pthread_t &thread)
+{
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setstacksize(&attr, RT_STACK_PREFAULT + 256 * 1024);
+  if (cpu >= 0) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    pthread_attr_setaffinity_np(&attr, sizeof(set), &set);
+  }
+  if (prio > 0) {
+    struct sched_param sp = {};
+    sp.sched_priority = prio;
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_FIFO);
+    pthread_attr_setschedparam(&attr, &sp);
+  }
+  int err = pthread_create(&thread, &attr, AudioThread, nullptr);
+  if (err == EPERM && prio > 0) {
+    fprintf(stderr, "modal_rt: no real-time scheduling (%s), running at normal priority\n", strerror(err));
+    pthread_attr_setinheritsched(&attr, PTHREAD_INHERIT_SCHED);
+    err = pthread_create(&thread, &attr, AudioThread, nullptr);
+  }
+  if (err == EINVAL && cpu >= 0) {
+    fprintf(stderr, "modal_rt: no cpu %d\n", cpu);
+  }
+  pthread_attr_destroy(&attr);
+  return err == 0;
+}
+
+/*
+ * Per-block times, summed over each report interval and into histograms for the run
+ */
+class timing_stats
+{
+  public:
+    void Add(const block_timing &t)
+    {
+      Bucket(late_hist_, t.late_ns);
+      Bucket(proc_hist_, t.process_ns);
+      blocks_++;
+      late_sum_ += t.late_ns;
+      proc_sum_ += t.process_ns;
+      late_max_ = late_max_ > t.late_ns ? late_max_ : t.late_ns;
+      proc_max_ = proc_max_ > t.process_ns ? proc_max_ : t.process_ns;
+      if (t.late_ns > late_run_max_) late_run_max_ = t.late_ns;
+      if (t.process_ns > proc_run_max_) proc_run_max_ = t.process_ns;
+      total_++;
+    }
+
+    // One line for the interval, then starts the next
+    void Report(float t, float period_ns)
+    {
+      if (!blocks_) return;
+      fprintf(stderr, "%7.1fs %6u blocks  late avg %6.1f max %7.1f us  process avg %6.1f max %7.1f us"
+		      "  load avg %3.0f%% max %3.0f%%  xruns %u/%u  governor %d\n",
+	      t, blocks_, late_sum_ / blocks_ / 1e3, late_max_ / 1e3, proc_sum_ / blocks_ / 1e3, proc_max_ / 1e3,
+	      proc_sum_ / blocks_ / period_ns * 100, proc_max_ / period_ns * 100,
+	      underruns.load(), overruns.load(), engine.GovernorLevel());
+      blocks_ = 0;
+      late_sum_ = proc_sum_ = 0;
+      late_max_ = proc_max_ = 0;
+    }
+
+    void Summary(float period_ns)
+    {
+      fprintf(stderr, "\n%llu blocks of %d at %g Hz, %.1f us each\n", (unsigned long long)total_, block, sr, period_ns / 1e3);
+      if (!total_) return;
+      Percentiles("late", late_hist_, late_run_max_);
+      Percentiles("process", proc_hist_, proc_run_max_);
+      fprintf(stderr, "underruns %u  overruns %u  MIDI dropped %u\n", underruns.load(), overruns.load(), midi_drops.load());
+    }
+
+  private:
+    static void Bucket(uint32_t *hist, uint32_t ns)
+    {
+      uint32_t us = ns / 1000;
+      hist[us < RT_HIST_US ? us : RT_HIST_US]++;
+    }
+
+    void Percentiles(const char *name, const uint32_t *hist, uint32_t max_ns)
+    {
+      static const double ps[] = {0.5, 0.9, 0.99, 0.999};
+      fprintf(stderr, "%-8s", name);
+      for (double p : ps) {
+	uint64_t want = (uint64_t)ceil(p * total_), seen = 0;
+	int us = 0;
+	for (; us < RT_HIST_US; us++) {
+	  seen += hist[us];
+	  if (seen >= want) break;
+	}
+	fprintf(stderr, "  p%g %s%d us", p * 100, us == RT_HIST_US ? ">" : "<", us == RT_HIST_US ? us : us + 1);
+      }
+      fprintf(stderr, "  max %.1f us\n", max_ns / 1e3);
+    }
+
+    uint32_t blocks_ = 0;
+    double late_sum_ = 0, proc_sum_ = 0;
+    uint32_t late_max_ = 0, proc_max_ = 0;
+    uint32_t late_run_max_ = 0, proc_run_max_ = 0;
+    uint64_t total_ = 0;
+    uint32_t late_hist_[RT_HIST_US + 1] = {};
+    uint32_t proc_hist_[RT_HIST_US + 1] = {};
+};
+
+static timing_stats stats;
+
+static int OpenIn(const char *path)
+{
+  if (!strcmp(path, "-")) return 0;
+  int fd = open(path, O_RDONLY);
+  if (fd < 0) fprintf(stderr, "%s: %s\n", path, strerror(errno));
+  return fd;
+}
+
+int main(int argc, char **argv)
+{
+  const char *in_path = NULL;
+  const char *midi_path = NULL;
+  const char *out_path = NULL;
+  const char *timing_path = NULL;
+  const char *exciter_path = NULL;
+  float seconds = 0;
+  float report = 1;
+  bool usage = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--in") && i + 1 < argc) {
+      in_path = argv[++i];
+    } else if (!strcmp(argv[i], "--in-channels") && i + 1 < argc) {
+      in_channels = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--midi") && i + 1 < argc) {
+      midi_path = argv[++i];
+    } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+      out_path = argv[++i];
+    } else if (!strcmp(argv[i], "--format") && i + 1 < argc) {
+      const char *f = argv[++i];
+      format = !strcmp(f, "s16") ? FMT_S16 : FMT_F32;
+      usage |= strcmp(f, "s16") && strcmp(f, "f32");
+    } else if (!strcmp(argv[i], "--sr") && i + 1 < argc) {
+      sr = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--block") && i + 1 < argc) {
+      block = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--seconds") && i + 1 < argc) {
+      seconds = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--freerun")) {
+      freerun = true;
+    } else if (!strcmp(argv[i], "--cpu") && i + 1 < argc) {
+      cpu = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--prio") && i + 1 < argc) {
+      prio = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--report") && i + 1 < argc) {
+      report = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--timing") && i + 1 < argc) {
+      timing_path = argv[++i];
+    } else if (!strcmp(argv[i], "--no-governor")) {
+      governed = false;
+    } else if (!strcmp(argv[i], "--exciters") && i + 1 < argc) {
+      exciter_path = argv[++i];
+    } else {
+      usage = true;
+    }
+  }
+  if (usage || in_channels < 1 || in_channels > RT_MAX_CHANNELS || block < 1 || block > RT_MAX_BLOCK || !(sr > 0)
+      || (in_path && midi_path && !strcmp(in_path, "-") && !strcmp(midi_path, "-"))) {
+    fprintf(stderr, "usage: %s [--in file|-] [--in-channels n] [--midi file|-] [--out file|-] [--format f32|s16]"
+		    " [--sr rate] [--block n] [--seconds s] [--freerun] [--cpu n] [--prio n]"
+		    " [--report s] [--timing file] [--no-governor] [--exciters bank]\n", argv[0]);
+    return 1;
+  }
+
+  if (in_path && (in_fd = OpenIn(in_path)) < 0) return 1;
+  if (midi_path && (midi_fd = OpenIn(midi_path)) < 0) return 1;
+  if (out_path && strcmp(out_path, "-")) {
+    out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out_fd < 0) {
+      fprintf(stderr, "%s: %s\n", out_path, strerror(errno));
+      return 1;
+    }
+  }
+  FILE *timing = NULL;
+  if (timing_path) {
+    timing = fopen(timing_path, "w");
+    if (!timing) {
+      fprintf(stderr, "%s: %s\n", timing_path, strerror(errno));
+      return 1;
+    }
+    fprintf(timing, "block,late_ns,process_ns\n");
+  }
+
+  mapped_file bank_file;
+  if (exciter_path) {
+    if (!bank_file.Open(exciter_path) || !exciters.Attach(bank_file.Data(), bank_file.Size())) {
+      fprintf(stderr, "%s: not an exciter bank\n", exciter_path);
+      return 1;
+    }
+    bank_file.Prefault();
+  } else {
+    exciters.Attach(exciter_blob, sizeof(exciter_blob));
+  }
+
+  // Set up as the firmware is
+  engine.Init(sr, sr / block);
+  engine.SetWidth(1);
+  engine.SetPrecision(true);
+  engine.SetGovernor(governed);
+  engine.SetExciters(&exciters);
+
+  max_blocks = (uint64_t)(seconds * sr / block);
+
+  struct sigaction sa = {};
+  sa.sa_handler = OnSignal;
+  sigaction(SIGINT, &sa, nullptr);
+  sigaction(SIGTERM, &sa, nullptr);
+  signal(SIGPIPE, SIG_IGN);
+
+  // Everything the audio thread touches is resident from here on
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) < 0) {
+    fprintf(stderr, "modal_rt: mlockall failed (%s), pages may fault in on the audio thread\n", strerror(errno));
+  }
+
+  pthread_t in_thread, midi_thread, out_thread, audio_thread;
+  if (in_fd >= 0) pthread_create(&in_thread, nullptr, InputThread, nullptr);
+  if (midi_fd >= 0) pthread_create(&midi_thread, nullptr, MidiThread, nullptr);
+  pthread_create(&out_thread, nullptr, OutputThread, nullptr);
+  if (freerun && in_fd >= 0) {
+    // Let the input get ahead
+    usleep(10 * RT_IO_POLL_US);
+  }
+  if (!StartAudio(audio_thread)) {
+    fprintf(stderr, "modal_rt: cannot start the audio thread\n");
+    return 1;
+  }
+
+  const float period_ns = 1e9f * block / sr;
+  uint64_t start = Now(), next_report = start + (uint64_t)(report * 1e9);
+  bool finished = false;
+  while (!finished) {
+    finished = audio_done.load();
+    usleep(10 * RT_IO_POLL_US);
+    block_timing t;
+    while (timing_ring.Pop(t)) {
+      stats.Add(t);
+      if (timing) fprintf(timing, "%u,%u,%u\n", t.block, t.late_ns, t.process_ns);
+    }
+    gov_event g;
+    while (engine.GovernorStep(g)) {
+      static const char *rungs[GOV_LAST] = {"precision", "modes", "control rate", "a voice"};
+      fprintf(stderr, "governor %s %s at %.0f%% load, level %d\n",
+	      g.down ? "drops" : "restores", rungs[g.rung], g.load * 100, g.level);
+    }
+    uint64_t now = Now();
+    if (report > 0 && now >= next_report) {
+      stats.Report((now - start) / 1e9f, period_ns);
+      next_report += (uint64_t)(report * 1e9);
+    }
+  }
+
+  stats.Report((Now() - start) / 1e9f, period_ns);
+  pthread_join(audio_thread, nullptr);
+  // The I/O threads see stop within RT_IO_POLL_US, the output thread drains first
+  pthread_join(out_thread, nullptr);
+  stop.store(true);
+  if (in_fd >= 0) pthread_join(in_thread, nullptr);
+  if (midi_fd >= 0) pthread_join(midi_thread, nullptr);
+
+  stats.Summary(period_ns);
+  if (timing) fclose(timing);
+  if (out_fd != 1) close(out_fd);
+  return 0;
+}
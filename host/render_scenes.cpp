@@ -0,0 +1,572 @@
+/*
+ * Render the scripted scenes in scenes.h through modal_engine, time them and
+ * compare the output against golden renders, or against the reference in scenes_ref.csv.
+ *
+ *   render_scenes [--golden dir] [--write-golden] [--ref file] [--write-ref file] [--out dir]
+ *                 [--filter substring] [--rms-tol dB] [--spec-tol dB] [--reps n] [--ir-cache]
+ *                 [--precision] [--governor speed] [--exciters bank]
+ *
+ * Noise is seeded so renders are repeatable. The comparison is deliberately
+ * tolerant - an optimization passes when the overall level and the band
+ * spectrum over time match, even if the samples are not bit identical.
+ * The reference keeps only that: each channel's level and its band spectrum averaged
+ * over REF_SEG_S segments, small enough to commit. With --ref the goldens aren't read.
+ * A change that alters the scenes on purpose writes a new reference with --write-ref.
+ *
+ * Timing rows go to stdout in the same CSV format as bench so runs can be
+ * compared with tools/bench_compare.py. Comparison results go to stderr.
+ * --ir-cache plays pings from an ir_cache, serviced to completion between blocks.
+ * --precision renders with modal_engine::SetPrecision on.
+ * --governor runs the CPU governor on the block times, taken as speed times slower as if on a
+ * target that much slower than the host, and averaged the way libDaisy's CpuLoadMeter does.
+ * Its steps are printed. Its renders depend on the timing so won't match the goldens or each other.
+ * SAMPLE mode plays the demo bank in exciter_blob.h, or with --exciters a bank file
+ * from tools/wav_to_exciters.py --bin, memory-mapped.
+ * Exits with status 1 if any scene fails its comparison.
+ */
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <chrono>
+#include <complex>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "modal_engine.h"
+#include "exciter_blob.h"
+#include "mapped_file.h"
+#include "scenes.h"
+
+using namespace daisysp;
+
+#define SCENE_SR	48000
+#define SCENE_BLOCK	48
+#define SCENE_SEED	0x5EED
+#define RAMP_STEP_S	0.005f
+// CpuLoadMeter's default smoothing
+#define LOAD_CUTOFF_HZ	1.0f
+
+#define SPEC_FRAME	2048
+#define SPEC_HOP	1024
+#define SPEC_BANDS	32
+#define SPEC_FMIN	40.0f
+#define SPEC_FMAX	20000.0f
+#define SPEC_FLOOR_DB	-90.0f
+// Reference spectra are averaged over segments this long
+#define REF_SEG_S	0.5f
+
+static float rms_tol = 0.5f;
+static float spec_tol = 1.5f;
+static int   reps = 3;
+static bool  use_ir_cache = false;
+static bool  use_precision = false;
+static float governor_speed = 0;
+static exciter_bank exciters;
+
+typedef std::vector<float> buffer;
+
+/*
+ * Deterministic external input: short noise bursts with a slow decay
+ */
+static buffer MakeInput(size_t n)
+{
+  buffer x(n);
+  crc_noise noise;
+  noise.Init(SCENE_SEED + 1);
+  size_t period = SCENE_SR / 4;
+  for (size_t i = 0; i < n; i++) {
+    float env = expf(-(float)(i % period) / (0.01f * SCENE_SR));
+    x[i] = 0.3f * env * noise.Process();
+  }
+  return x;
+}
+
+// Expand ramps and bends into individual CC and bend events at RAMP_STEP_S intervals
+static std::vector<scene_event> Expand(const scene_phrase &p)
+{
+  std::vector<scene_event> ev;
+  for (int i = 0; i < SCENE_MAX_EVENTS && p.events[i].op != SC_END; i++) {
+    const scene_event &e = p.events[i];
+    if (e.op != SC_RAMP && e.op != SC_BEND) {
+      ev.push_back(e);
+      continue;
+    }
+    int steps = std::max(1, (int)(e.dur / RAMP_STEP_S));
+    for (int s = 0; s <= steps; s++) {
+      uint8_t v = (uint8_t)roundf(e.b + (e.c - e.b) * (float)s / steps);
+      scene_event step = {e.t + s * RAMP_STEP_S, e.op == SC_RAMP ? (uint8_t)SC_CC : e.op, e.a, v, v};
+      ev.push_back(step);
+    }
+  }
+  std::stable_sort(ev.begin(), ev.end(), [](const scene_event &a, const scene_event &b) { return a.t < b.t; });
+  return ev;
+}
+
+alignas(modal_engine) static unsigned char engine_mem[sizeof(modal_engine)];
+static ir_cache irc;
+
+/*
+ * Events are applied between blocks, the way the main loop feeds the audio callback
+ */
+static void Render(const scene_phrase &p, ui_mode mode, ui_output_mode output, buffer &l, buffer &r)
+{
+  size_t n = (size_t)(p.length * SCENE_SR);
+  n -= n % SCENE_BLOCK;
+  buffer in = MakeInput(n);
+  l.assign(n, 0);
+  r.assign(n, 0);
+
+  // Fresh engine for every scene, constructed in place the way the firmware's static one is
+  modal_engine *engine = new (engine_mem) modal_engine;
+  engine->Init(SCENE_SR, (float)SCENE_SR / SCENE_BLOCK);
+  engine->SeedNoise(SCENE_SEED);
+  for (int m = PING; m < mode; m++) {
+    engine->NextMode();
+  }
+  engine->SetOutputMode(output);
+  engine->SetPrecision(use_precision);
+  engine->SetGovernor(governor_speed > 0);
+  engine->SetExciters(&exciters);
+  if (use_ir_cache) {
+    // Every scene starts with an empty cache
+    irc.Init();
+    engine->SetIrCache(&irc);
+  }
+
+  std::vector<scene_event> ev = Expand(p);
+  size_t next = 0;
+  float load = -1;
+  float load_coef = 1 - expf(-2 * (float)M_PI * LOAD_CUTOFF_HZ * SCENE_BLOCK / SCENE_SR);
+  for (size_t b = 0; b < n; b += SCENE_BLOCK) {
+    float t = (float)b / SCENE_SR;
+    while (next < ev.size() && ev[next].t <= t) {
+      const scene_event &e = ev[next++];
+      switch (e.op) {
+	case SC_NOTE:    engine->NoteOn(e.a, e.b); break;
+	case SC_CC:      engine->ControlChange(e.a, e.b); break;
+	case SC_BUTTON1: engine->NextPreset(); break;
+	case SC_BUTTON2: engine->NextMode(); break;
+	case SC_PARAM:   engine->SetParam((param_id)e.a, e.dur); break;
+	case SC_MULTIRATE: engine->SetMultirate(e.a); break;
+	case SC_BEND:    engine->PitchBend((e.b - 64) * 128); break;
+	default: break;
+      }
+    }
+    if (governor_speed > 0) {
+      auto t0 = std::chrono::steady_clock::now();
+      engine->Process(&in[b], &l[b], &r[b], SCENE_BLOCK);
+      std::chrono::duration<double> dt = std::chrono::steady_clock::now() - t0;
+      float block_load = dt.count() * governor_speed * SCENE_SR / SCENE_BLOCK;
+      load = load < 0 ? block_load : load + load_coef * (block_load - load);
+      engine->ReportLoad(load);
+      gov_event g;
+      while (engine->GovernorStep(g)) {
+	static const char *rungs[GOV_LAST] = {"precision", "modes", "control rate", "a voice"};
+	fprintf(stderr, "  %s %.2fs: governor %s %s at %.0f%% load, level %d\n", p.name, t,
+		g.down ? "drops" : "restores", rungs[g.rung], g.load * 100, g.level);
+      }
+    } else {
+      engine->Process(&in[b], &l[b], &r[b], SCENE_BLOCK);
+    }
+    // The main loop's share, note-on tables are kept up to date before the next event
+    while (engine->ServicePitch()) {}
+    if (use_ir_cache) {
+      while (irc.Service()) {}
+    }
+  }
+  engine->~modal_engine();
+}
+
+/*
+ * 32 bit float stereo WAV
+ */
+static bool WriteWav(const std::string &path, const buffer &l, const buffer &r)
+{
+  FILE *f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  uint32_t n = l.size();
+  uint32_t data_bytes = n * 2 * sizeof(float);
+  uint32_t u32;
+  uint16_t u16;
+  fwrite("RIFF", 1, 4, f);
+  u32 = 36 + data_bytes; fwrite(&u32, 4, 1, f);
+  fwrite("WAVEfmt ", 1, 8, f);
+  u32 = 16; fwrite(&u32, 4, 1, f);
+  u16 = 3; fwrite(&u16, 2, 1, f);  // IEEE float
+  u16 = 2; fwrite(&u16, 2, 1, f);
+  u32 = SCENE_SR; fwrite(&u32, 4, 1, f);
+  u32 = SCENE_SR * 2 * sizeof(float); fwrite(&u32, 4, 1, f);
+  u16 = 2 * sizeof(float); fwrite(&u16, 2, 1, f);
+  u16 = 32; fwrite(&u16, 2, 1, f);
+  fwrite("data", 1, 4, f);
+  fwrite(&data_bytes, 4, 1, f);
+  for (uint32_t i = 0; i < n; i++) {
+    fwrite(&l[i], sizeof(float), 1, f);
+    fwrite(&r[i], sizeof(float), 1, f);
+  }
+  fclose(f);
+  return true;
+}
+
+// Only reads back what WriteWav writes
+static bool ReadWav(const std::string &path, buffer &l, buffer &r)
+{
+  FILE *f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char hdr[44];
+  bool ok = fread(hdr, 1, 44, f) == 44 && !memcmp(hdr, "RIFF", 4) && !memcmp(hdr + 36, "data", 4);
+  uint32_t data_bytes = 0;
+  if (ok) {
+    memcpy(&data_bytes, hdr + 40, 4);
+    uint32_t n = data_bytes / (2 * sizeof(float));
+    l.resize(n);
+    r.resize(n);
+    for (uint32_t i = 0; i < n && ok; i++) {
+      ok = fread(&l[i], sizeof(float), 1, f) == 1 && fread(&r[i], sizeof(float), 1, f) == 1;
+    }
+  }
+  fclose(f);
+  return ok;
+}
+
+static void Fft(std::vector<std::complex<float>> &x)
+{
+  size_t n = x.size();
+  for (size_t i = 1, j = 0; i < n; i++) {
+    size_t bit = n >> 1;
+    for (; j & bit; bit >>= 1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(x[i], x[j]);
+  }
+  for (size_t len = 2; len <= n; len <<= 1) {
+    float ang = -2 * PI / len;
+    std::complex<float> wl(cosf(ang), sinf(ang));
+    for (size_t i = 0; i < n; i += len) {
+      std::complex<float> w(1);
+      for (size_t k = 0; k < len / 2; k++) {
+	std::complex<float> u = x[i + k], v = x[i + k + len / 2] * w;
+	x[i + k] = u + v;
+	x[i + k + len / 2] = u - v;
+	w *= wl;
+      }
+    }
+  }
+}
+
+// Log spaced band energies in dB for each frame
+static std::vector<std::vector<float>> BandSpectrum(const buffer &x)
+{
+  std::vector<std::vector<float>> frames;
+  std::vector<std::complex<float>> bins(SPEC_FRAME);
+  for (size_t start = 0; start + SPEC_FRAME <= x.size(); start += SPEC_HOP) {
+    for (size_t i = 0; i < SPEC_FRAME; i++) {
+      float w = 0.5f - 0.5f * cosf(2 * PI * i / SPEC_FRAME);
+      bins[i] = x[start + i] * w;
+    }
+    Fft(bins);
+    std::vector<float> bands(SPEC_BANDS, 0);
+    for (size_t k = 1; k < SPEC_FRAME / 2; k++) {
+      float f = (float)k * SCENE_SR / SPEC_FRAME;
+      if (f < SPEC_FMIN || f >= SPEC_FMAX) continue;
+      int b = (int)(SPEC_BANDS * logf(f / SPEC_FMIN) / logf(SPEC_FMAX / SPEC_FMIN));
+      bands[b] += std::norm(bins[k]);
+    }
+    for (auto &e : bands) {
+      e = 10 * log10f(e + 1e-30f);
+    }
+    frames.push_back(bands);
+  }
+  return frames;
+}
+
+// No inf or NaN anywhere, a scene that blows up fails without a golden to compare with
+static bool Finite(const buffer &x)
+{
+  for (float v : x) {
+    if (!std::isfinite(v)) return false;
+  }
+  return true;
+}
+
+static float Rms(const buffer &x)
+{
+  double acc = 0;
+  for (float v : x) acc += (double)v * v;
+  return sqrt(acc / std::max<size_t>(1, x.size()));
+}
+
+/*
+ * Level difference in dB and mean band spectrum distance in dB
+ * Bands more than SPEC_FLOOR_DB below the golden's loudest band are ignored
+ */
+static void Compare(const buffer &golden, const buffer &x, float &rms_db, float &spec_db)
+{
+  float rg = Rms(golden), rx = Rms(x);
+  rms_db = (rg < 1e-9f && rx < 1e-9f) ? 0 : 20 * log10f((rx + 1e-12f) / (rg + 1e-12f));
+
+  std::vector<std::vector<float>> sg = BandSpectrum(golden), sx = BandSpectrum(x);
+  float peak = -300;
+  for (auto &f : sg) for (float e : f) peak = std::max(peak, e);
+  float floor = peak + SPEC_FLOOR_DB;
+
+  double acc = 0;
+  size_t count = 0;
+  for (size_t i = 0; i < std::min(sg.size(), sx.size()); i++) {
+    for (int b = 0; b < SPEC_BANDS; b++) {
+      if (sg[i][b] < floor && sx[i][b] < floor) continue;
+      float d = std::max(sg[i][b], floor) - std::max(sx[i][b], floor);
+      acc += d * d;
+      count++;
+    }
+  }
+  spec_db = count ? sqrt(acc / count) : 0;
+  if (sg.size() != sx.size()) spec_db = INFINITY;
+}
+
+/*
+ * A scene as the reference keeps it: per channel, the level in dB
+ * and the band energies in dB of each REF_SEG_S segment, segment after segment
+ */
+struct scene_print
+{
+  float rms_db[2];
+  std::vector<float> bands[2];
+};
+
+static scene_print Print(const buffer &l, const buffer &r)
+{
+  scene_print p;
+  const buffer *ch[2] = {&l, &r};
+  size_t per_seg = (size_t)lrintf(REF_SEG_S * SCENE_SR / SPEC_HOP);
+  for (int c = 0; c < 2; c++) {
+    p.rms_db[c] = 20 * log10f(Rms(*ch[c]) + 1e-12f);
+    std::vector<std::vector<float>> frames = BandSpectrum(*ch[c]);
+    for (size_t start = 0; start < frames.size(); start += per_seg) {
+      size_t end = std::min(frames.size(), start + per_seg);
+      for (int b = 0; b < SPEC_BANDS; b++) {
+	double e = 0;
+	for (size_t i = start; i < end; i++) e += pow(10, frames[i][b] / 10);
+	p.bands[c].push_back(10 * log10(e / (end - start) + 1e-30));
+      }
+    }
+  }
+  return p;
+}
+
+// One line per channel: name,channel,level,bands in tenths of a dB
+static void WritePrint(FILE *f, const std::string &name, const scene_print &p)
+{
+  for (int c = 0; c < 2; c++) {
+    fprintf(f, "%s,%c,%.2f", name.c_str(), "lr"[c], p.rms_db[c]);
+    for (float e : p.bands[c]) fprintf(f, ",%ld", lrintf(e * 10));
+    fprintf(f, "\n");
+  }
+}
+
+static bool ReadPrints(const char *path, std::vector<std::pair<std::string, scene_print>> &prints)
+{
+  FILE *f = fopen(path, "r");
+  if (!f) return false;
+  char name[64], ch;
+  float rms;
+  while (fscanf(f, " %63[^,],%c,%f", name, &ch, &rms) == 3) {
+    if (ch == 'l') prints.push_back(std::make_pair(std::string(name), scene_print()));
+    if (prints.empty() || prints.back().first != name || (ch != 'l' && ch != 'r')) break;
+    int c = ch == 'r';
+    scene_print &p = prints.back().second;
+    p.rms_db[c] = rms;
+    long v;
+    while (fscanf(f, ",%ld", &v) == 1) p.bands[c].push_back(v * 0.1f);
+  }
+  bool ok = feof(f);
+  fclose(f);
+  return ok;
+}
+
+// As Compare, for one channel of a render's print against the reference's
+static void ComparePrint(const scene_print &ref, const scene_print &x, int c, float &rms_db, float &spec_db)
+{
+  float rr = ref.rms_db[c], rx = x.rms_db[c];
+  rms_db = (rr < -180 && rx < -180) ? 0 : rx - rr;
+
+  const std::vector<float> &br = ref.bands[c], &bx = x.bands[c];
+  float peak = -300;
+  for (float e : br) peak = std::max(peak, e);
+  float floor = peak + SPEC_FLOOR_DB;
+
+  double acc = 0;
+  size_t count = 0;
+  for (size_t i = 0; i < std::min(br.size(), bx.size()); i++) {
+    if (br[i] < floor && bx[i] < floor) continue;
+    float d = std::max(br[i], floor) - std::max(bx[i], floor);
+    acc += d * d;
+    count++;
+  }
+  spec_db = count ? sqrt(acc / count) : 0;
+  if (br.size() != bx.size()) spec_db = INFINITY;
+}
+
+int main(int argc, char **argv)
+{
+  const char *golden_dir = "golden";
+  const char *out_dir = NULL;
+  const char *filter = NULL;
+  const char *exciter_path = NULL;
+  const char *ref_path = NULL;
+  bool write_golden = false, write_ref = false;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--golden") && i + 1 < argc) {
+      golden_dir = argv[++i];
+    } else if (!strcmp(argv[i], "--write-golden")) {
+      write_golden = true;
+    } else if (!strcmp(argv[i], "--ref") && i + 1 < argc) {
+      ref_path = argv[++i];
+    } else if (!strcmp(argv[i], "--write-ref") && i + 1 < argc) {
+      ref_path = argv[++i];
+      write_ref = true;
+    } else if (!strcmp(argv[i], "--out") && i + 1 < argc) {
+      out_dir = argv[++i];
+    } else if (!strcmp(argv[i], "--filter") && i + 1 < argc) {
+      filter = argv[++i];
+    } else if (!strcmp(argv[i], "--rms-tol") && i + 1 < argc) {
+      rms_tol = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--spec-tol") && i + 1 < argc) {
+      spec_tol = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--reps") && i + 1 < argc) {
+      reps = atoi(argv[++i]);
+    } else if (!strcmp(argv[i], "--ir-cache")) {
+      use_ir_cache = true;
+    } else if (!strcmp(argv[i], "--precision")) {
+      use_precision = true;
+    } else if (!strcmp(argv[i], "--governor") && i + 1 < argc) {
+      governor_speed = atof(argv[++i]);
+    } else if (!strcmp(argv[i], "--exciters") && i + 1 < argc) {
+      exciter_path = argv[++i];
+    } else {
+      fprintf(stderr, "usage: %s [--golden dir] [--write-golden] [--ref file] [--write-ref file] [--out dir]"
+		      " [--filter substring] [--rms-tol dB] [--spec-tol dB] [--reps n] [--ir-cache]"
+		      " [--precision] [--governor speed] [--exciters bank]\n", argv[0]);
+      return 1;
+    }
+  }
+
+  mapped_file bank_file;
+  if (exciter_path) {
+    if (!bank_file.Open(exciter_path) || !exciters.Attach(bank_file.Data(), bank_file.Size())) {
+      fprintf(stderr, "%s: not an exciter bank\n", exciter_path);
+      return 1;
+    }
+    bank_file.Prefault();
+  } else {
+    exciters.Attach(exciter_blob, sizeof(exciter_blob));
+  }
+
+  std::vector<std::pair<std::string, scene_print>> prints;
+  FILE *ref_out = NULL;
+  if (write_ref) {
+    ref_out = fopen(ref_path, "w");
+    if (!ref_out) {
+      fprintf(stderr, "cannot write %s\n", ref_path);
+      return 1;
+    }
+  } else if (ref_path && !ReadPrints(ref_path, prints)) {
+    fprintf(stderr, "%s: not a scene reference\n", ref_path);
+    return 1;
+  }
+
+  int failed = 0, passed = 0, missing = 0;
+  printf("name,fs,block,modes,voices,unit,ns,per_sec\n");
+
+  for (int mode = PING; mode < LAST_MODE; mode++) {
+    for (int output = NONE; output < LAST_OUTPUT; output++) {
+      for (size_t p = 0; p < NUM_SCENE_PHRASES; p++) {
+	const scene_phrase &phrase = scene_phrases[p];
+	if (!SceneApplies(phrase, (ui_mode)mode)) continue;
+
+	std::string name = std::string(scene_mode_names[mode]) + "." + scene_output_names[output] + "." + phrase.name;
+	if (filter && !strstr(name.c_str(), filter)) continue;
+
+	buffer l, r;
+	double best = 1e30;
+	for (int rep = 0; rep < reps; rep++) {
+	  auto t0 = std::chrono::steady_clock::now();
+	  Render(phrase, (ui_mode)mode, (ui_output_mode)output, l, r);
+	  auto t1 = std::chrono::steady_clock::now();
+	  best = std::min(best, std::chrono::duration<double, std::nano>(t1 - t0).count() / l.size());
+	}
+	printf("scene.%s,%d,%d,%d,%d,sample,%.3f,%.1f\n", name.c_str(), SCENE_SR, SCENE_BLOCK,
+	       mode >= INHARM ? NUM_INHARM_PARTIALS : NUM_HARM_PARTIALS, NUM_NOTES, best, 1e9 / best);
+	fflush(stdout);
+
+	std::string golden_path = std::string(golden_dir) + "/" + name + ".wav";
+	bool finite = Finite(l) && Finite(r);
+	if (out_dir) {
+	  WriteWav(std::string(out_dir) + "/" + name + ".wav", l, r);
+	}
+	if (!finite) {
+	  fprintf(stderr, "%-36s FAIL  not finite\n", name.c_str());
+	  failed++;
+	  continue;
+	}
+	if (write_ref) {
+	  WritePrint(ref_out, name, Print(l, r));
+	  continue;
+	}
+	if (ref_path) {
+	  auto found = std::find_if(prints.begin(), prints.end(),
+	      [&](const std::pair<std::string, scene_print> &e) { return e.first == name; });
+	  if (found == prints.end()) {
+	    fprintf(stderr, "%-36s MISSING from %s\n", name.c_str(), ref_path);
+	    missing++;
+	    continue;
+	  }
+	  scene_print x = Print(l, r);
+	  float rms_l, spec_l, rms_r, spec_r;
+	  ComparePrint(found->second, x, 0, rms_l, spec_l);
+	  ComparePrint(found->second, x, 1, rms_r, spec_r);
+	  float rms_db = std::max(fabsf(rms_l), fabsf(rms_r));
+	  float spec_db = std::max(spec_l, spec_r);
+	  bool ok = rms_db <= rms_tol && spec_db <= spec_tol;
+	  fprintf(stderr, "%-36s %s  level %.2f dB  spectrum %.2f dB\n", name.c_str(), ok ? "ok  " : "FAIL", rms_db, spec_db);
+	  ok ? passed++ : failed++;
+	  continue;
+	}
+	if (write_golden) {
+	  if (!WriteWav(golden_path, l, r)) {
+	    fprintf(stderr, "%-36s cannot write %s\n", name.c_str(), golden_path.c_str());
+	    failed++;
+	  }
+	  continue;
+	}
+
+	buffer gl, gr;
+	if (!ReadWav(golden_path, gl, gr)) {
+	  fprintf(stderr, "%-36s MISSING %s\n", name.c_str(), golden_path.c_str());
+	  missing++;
+	  continue;
+	}
+	float rms_l, spec_l, rms_r, spec_r;
+	Compare(gl, l, rms_l, spec_l);
+	Compare(gr, r, rms_r, spec_r);
+	float rms_db = std::max(fabsf(rms_l), fabsf(rms_r));
+	float spec_db = std::max(spec_l, spec_r);
+	bool ok = rms_db <= rms_tol && spec_db <= spec_tol;
+	fprintf(stderr, "%-36s %s  level %.2f dB  spectrum %.2f dB\n", name.c_str(), ok ? "ok  " : "FAIL", rms_db, spec_db);
+	ok ? passed++ : failed++;
+      }
+    }
+  }
+
+  if (ref_out) {
+    fclose(ref_out);
+  } else if (!write_golden) {
+    fprintf(stderr, "\n%d passed, %d failed, %d missing\n", passed, failed, missing);
+  }
+  return (failed || missing) ? 1 : 0;
+}
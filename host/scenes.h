@@ -0,0 +1,160 @@
+#pragma once
+#ifndef DSY_SCENES_H
+#define DSY_SCENES_H
+
+#include <stdint.h>
+#include <string.h>
+#include <math.h>
+#include "modal_engine.h"
+
+/*
+ * Scripted scenes for render_scenes
+ *
+ * A scene is a mode, an output stage and a phrase.
+ * Every ui_mode is rendered with every output mode for the phrases that make sense in it.
+ * Modes are reached the way a player would - by pressing button 2 from PING.
+ */
+
+typedef enum {
+  SC_NOTE = 0,	// a = note, b = velocity
+  SC_CC,	// a = control number, b = value
+  SC_RAMP,	// a = control number, b = from, c = to over dur seconds - MIDI pickup needs a sweep
+  SC_BUTTON1,	// next inharmonic preset
+  SC_BUTTON2,	// next mode
+  SC_PARAM,	// a = param_id, dur = value, straight to SetParam the way a host sets it
+  SC_MULTIRATE,	// a = on
+  SC_BEND,	// pitch wheel MSB, b = from, c = to over dur seconds like SC_RAMP
+  SC_END
+} scene_op;
+
+typedef struct {
+  float t;	// seconds from the start of the scene
+  uint8_t op, a, b, c;
+  float dur;
+} scene_event;
+
+#define SCENE_MAX_EVENTS 24
+
+typedef struct {
+  const char *name;
+  float length;	// seconds
+  scene_event events[SCENE_MAX_EVENTS];
+} scene_phrase;
+
+static const scene_phrase scene_phrases[] = {
+  // Plain notes, including a retrigger of the first voice
+  {"notes", 2.0f, {
+    {0.00f, SC_NOTE, 48, 100},
+    {0.25f, SC_NOTE, 52, 80},
+    {0.50f, SC_NOTE, 55, 60},
+    {0.75f, SC_NOTE, 60, 127},
+    {1.00f, SC_NOTE, 64, 40},
+    {1.25f, SC_NOTE, 36, 110},
+    {0, SC_END}}},
+
+  // Resonance, stiffness, beta, brightness and input filter moves under ringing notes
+  {"timbre", 2.5f, {
+    {0.00f, SC_NOTE, 45, 100},
+    {0.05f, SC_NOTE, 57, 100},
+    {0.10f, SC_RAMP, CC_STIFF, 0, 80, 0.6f},
+    {0.20f, SC_RAMP, CC_MOD, 64, 120, 0.4f},
+    {0.80f, SC_RAMP, CC_BETA, 0, 127, 0.3f},
+    {1.00f, SC_NOTE, 50, 90},
+    {1.10f, SC_RAMP, CC_MGF, 32, 0, 0.4f},
+    {1.50f, SC_RAMP, CC_IFC, 1, 40, 0.5f},
+    {1.60f, SC_NOTE, 62, 90},
+    {0, SC_END}}},
+
+  // All three LFOs running
+  {"lfo", 2.5f, {
+    {0.00f, SC_RAMP, CC_LFO_STIFF_D, 0, 90, 0.1f},
+    {0.00f, SC_RAMP, CC_LFO_BETA_D, 0, 70, 0.1f},
+    {0.00f, SC_RAMP, CC_LFO_IFC_D, 0, 20, 0.1f},
+    {0.10f, SC_RAMP, CC_LFO_STIFF_R, 1, 30, 0.1f},
+    {0.10f, SC_RAMP, CC_LFO_BETA_R, 1, 12, 0.1f},
+    {0.10f, SC_RAMP, CC_LFO_IFC_R, 1, 8, 0.1f},
+    {0.20f, SC_NOTE, 40, 110},
+    {0.70f, SC_NOTE, 47, 110},
+    {1.20f, SC_NOTE, 52, 110},
+    {0, SC_END}}},
+
+  // Envelope times for the noise and enveloped input modes
+  {"env", 2.0f, {
+    {0.00f, SC_RAMP, CC_ATK, 16, 100, 0.2f},
+    {0.00f, SC_RAMP, CC_REL, 16, 127, 0.2f},
+    {0.30f, SC_NOTE, 48, 100},
+    {0.80f, SC_RAMP, CC_ATK, 100, 2, 0.2f},
+    {1.10f, SC_NOTE, 55, 100},
+    {0, SC_END}}},
+
+  // Step through the inharmonic presets
+  {"presets", 3.0f, {
+    {0.00f, SC_NOTE, 60, 100},
+    {0.30f, SC_BUTTON1},
+    {0.30f, SC_NOTE, 60, 100},
+    {0.60f, SC_BUTTON1},
+    {0.60f, SC_NOTE, 60, 100},
+    {0.90f, SC_BUTTON1},
+    {0.90f, SC_NOTE, 60, 100},
+    {1.20f, SC_BUTTON1},
+    {1.20f, SC_NOTE, 60, 100},
+    {1.50f, SC_BUTTON1},
+    {1.50f, SC_NOTE, 60, 100},
+    {1.80f, SC_RAMP, CC_MOD, 64, 127, 0.3f},
+    {2.10f, SC_NOTE, 48, 100},
+    {0, SC_END}}},
+
+  // Values past every parameter's range, which have to land inside it
+  {"bounds", 1.5f, {
+    {0.00f, SC_NOTE, 48, 100},
+    {0.10f, SC_PARAM, daisysp::PARAM_RES, 0, 0, 1.2f},
+    {0.10f, SC_PARAM, daisysp::PARAM_G, 0, 0, 1000},
+    {0.10f, SC_PARAM, daisysp::PARAM_MGF, 0, 0, -40},
+    {0.10f, SC_PARAM, daisysp::PARAM_STIFF, 0, 0, 2},
+    {0.10f, SC_PARAM, daisysp::PARAM_BETA, 0, 0, -3},
+    {0.10f, SC_PARAM, daisysp::PARAM_IFC, 0, 0, 1e6f},
+    {0.10f, SC_PARAM, daisysp::PARAM_AT, 0, 0, -1},
+    {0.10f, SC_PARAM, daisysp::PARAM_DT, 0, 0, 50},
+    {0.10f, SC_PARAM, daisysp::PARAM_OUT, 0, 0, 9},
+    {0.20f, SC_NOTE, 55, 127},
+    {0.40f, SC_PARAM, daisysp::PARAM_LFO_STIFF_RATE, 0, 0, 1e5f},
+    {0.40f, SC_PARAM, daisysp::PARAM_LFO_STIFF_DEPTH, 0, 0, 20},
+    {0.40f, SC_PARAM, daisysp::PARAM_LFO_IFC_RATE, 0, 0, -5},
+    {0.40f, SC_PARAM, daisysp::PARAM_LFO_IFC_DEPTH, 0, 0, 1e4f},
+    {0.40f, SC_PARAM, daisysp::PARAM_RES, 0, 0, -2},
+    {0.50f, SC_NOTE, 60, 100},
+    {0.90f, SC_PARAM, daisysp::PARAM_RES, 0, 0, NAN},
+    {0.90f, SC_PARAM, daisysp::PARAM_G, 0, 0, INFINITY},
+    {1.00f, SC_NOTE, 43, 127},
+    {0, SC_END}}},
+
+  // Multirate notes bent up and down, moving modes across tiers while they ring
+  {"multirate", 2.5f, {
+    {0.00f, SC_MULTIRATE, 1},
+    {0.00f, SC_NOTE, 40, 110},
+    {0.05f, SC_NOTE, 52, 90},
+    {0.30f, SC_BEND, 0, 64, 127, 0.4f},
+    {0.90f, SC_BEND, 0, 127, 0, 0.8f},
+    {1.20f, SC_NOTE, 45, 100},
+    {1.90f, SC_BEND, 0, 0, 64, 0.3f},
+    {0, SC_END}}},
+};
+
+#define NUM_SCENE_PHRASES (sizeof(scene_phrases) / sizeof(scene_phrases[0]))
+
+static const char *scene_mode_names[daisysp::LAST_MODE] = {"ping", "noise_env", "ext", "ext_env", "inharm", "inharm_noise", "sample"};
+static const char *scene_output_names[daisysp::LAST_OUTPUT] = {"clean", "exp", "tanh", "atan"};
+
+// Which phrases are worth rendering in each mode
+inline bool SceneApplies(const scene_phrase &p, daisysp::ui_mode mode)
+{
+  using namespace daisysp;
+  bool inharm = (mode == INHARM || mode == INHARM_NOISE);
+  bool env = (mode == NOISE_ENV || mode == EXT_ENV || mode == INHARM_NOISE);
+  if (!strcmp(p.name, "presets")) return inharm;
+  if (!strcmp(p.name, "env")) return env;
+  if (!strcmp(p.name, "multirate")) return !inharm;
+  return true;
+}
+
+#endif
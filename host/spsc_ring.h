@@ -0,0 +1,60 @@
+#pragma once
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+/*
+ * A lock-free ring between one writer thread and one reader thread.
+ * Neither side ever waits or allocates, a full ring refuses what doesn't fit
+ * and an empty one returns nothing. N is a power of 2.
+ */
+template <typename T, size_t N>
+class spsc_ring
+{
+  static_assert((N & (N - 1)) == 0, "N must be a power of 2");
+
+  public:
+    // Writer side. Copies up to n items in, returns how many fitted
+    size_t Write(const T *src, size_t n)
+    {
+      size_t w = write_.load(std::memory_order_relaxed);
+      size_t space = N - (w - read_.load(std::memory_order_acquire));
+      if (n > space) n = space;
+      for (size_t i = 0; i < n; i++) {
+	buf_[(w + i) & (N - 1)] = src[i];
+      }
+      write_.store(w + n, std::memory_order_release);
+      return n;
+    }
+
+    bool Push(const T &item) { return Write(&item, 1) == 1; }
+
+    // Reader side. Copies up to n items out, returns how many there were
+    size_t Read(T *dst, size_t n)
+    {
+      size_t r = read_.load(std::memory_order_relaxed);
+      size_t avail = write_.load(std::memory_order_acquire) - r;
+      if (n > avail) n = avail;
+      for (size_t i = 0; i < n; i++) {
+	dst[i] = buf_[(r + i) & (N - 1)];
+      }
+      read_.store(r + n, std::memory_order_release);
+      return n;
+    }
+
+    bool Pop(T &item) { return Read(&item, 1) == 1; }
+
+    // Either side, a snapshot
+    size_t Size() const { return write_.load(std::memory_order_acquire) - read_.load(std::memory_order_acquire); }
+    size_t Space() const { return N - Size(); }
+
+  private:
+    T buf_[N];
+    // Apart so the two sides don't share a cache line
+    alignas(64) std::atomic<size_t> write_{0};
+    alignas(64) std::atomic<size_t> read_{0};
+};
+#endif
@@ -3,6 +3,7 @@
 #define DSY_IIR_1P_LP_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include "arm_math.h"
 #ifdef __cplusplus
 
@@ -54,6 +55,13 @@ class iir_1p_lp
     return out;
   }
 
+  void ProcessBlock(const float *in, float *out, size_t size)
+  {
+    for (size_t i = 0; i < size; i++) {
+      out[i] = Process(in[i]);
+    }
+  }
+
 
   void update_fc(float fc, float g = 1)
   {
@@ -76,6 +84,23 @@ class iir_1p_lp
     }
   }
 
+  // b0 b1 a1, and the history x[n-1] y[n-1], for saving a voice and putting it back
+  void get_coefs(float *c) const
+  {
+    c[0] = b0_;
+    c[1] = b1_;
+    c[2] = a1_;
+  }
+
+  float xn() const { return xn_; }
+  float yn() const { return yn_; }
+
+  void set_state(float xn, float yn)
+  {
+    xn_ = xn;
+    yn_ = yn;
+  }
+
   private:
     float b0_, b1_, a1_, alpha_, xn_, yn_;
     float fs_, fc_, wc_, g_, to_wc_;
@@ -3,15 +3,67 @@
 #define DSY_IIR_RESON_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include "arm_math.h"
-#include "dumb_biquad.h"
 #ifdef __cplusplus
 
+// The M7's cache line. Hot resonator state is laid out in whole lines.
+#define RESON_ALIGN 32
+
 namespace daisysp
 {
+/*
+ * reson_hot
+ *
+ * The part of a resonator touched every sample: coefficients and output history, nothing else.
+ * The resonator's zeros are fixed at b1 = 0, b2 = -b0 so the numerator is b0 * (x[n] - x[n-2]).
+ * That difference is the same for every mode fed the same input, so the input history
+ * lives once per voice in a reson_input and each mode costs 3 multiplies.
+ * 20 bytes. Voices keep arrays of them starting on a cache line.
+ */
+struct reson_hot
+{
+  float a[2];
+  float b0;
+  float yn[2];
+};
+
+// d is x[n] - x[n-2] from the reson_input feeding this mode
+inline float reson_process(reson_hot &h, float d)
+{
+  float out = h.b0 * d - h.a[0] * h.yn[0] - h.a[1] * h.yn[1];
+  h.yn[1] = h.yn[0];
+  h.yn[0] = out;
+  return out;
+}
+
+// Input history shared by every mode of a voice
+struct reson_input
+{
+  float xn[2] = {0, 0};
+  // Added after the difference so it reaches the poles, see DENORMAL_OFFSET
+  float offset = 0;
+
+  // Returns x[n] - x[n-2]
+  float Process(float in)
+  {
+    float d = in - xn[1] + offset;
+    xn[1] = xn[0];
+    xn[0] = in;
+    return d;
+  }
+
+  void Reset()
+  {
+    xn[0] = xn[1] = 0;
+  }
+};
+
 /** iir_reson
  *
- * Εxtend the dumb_biquad to turn it into a resonator
+ * Resonator coefficient control - the cold, control rate half of a resonator.
+ * Holds the musical parameters and writes coefficients into the reson_hot it is attached to.
+ * The owning voice keeps its reson_hots together so the per-sample loop only walks hot data.
  *   Jared Anderson May 2021
  *
  * Based on:
@@ -24,9 +76,17 @@ namespace daisysp
  *   Source: Computer Music Journal, Vol. 18, No. 4, (Winter, 1994), pp. 8-10
  *
  */
-class iir_reson : public dumb_biquad
+class iir_reson
 {
   public:
+  iir_reson() {}
+  ~iir_reson() {}
+
+  void attach(reson_hot *hot)
+  {
+    h_ = hot;
+  }
+
   /*
    * Initialize by setting the sample rate fs
    * cutoff freq fc in Hz
@@ -37,22 +97,43 @@ class iir_reson : public dumb_biquad
   {
     fs_ = fs;
     fc_ = fc;
-    to_wc_ = 2 * PI / fs_; 
+    to_wc_ = 2 * PI / fs_;
     wc_ = to_wc_ * fc_;
     r_  = r;
     g_  = g;
 
-    a[0] = -2 * r_ * cos(wc_);
-    a[1] = r_ * r_;
+    cos_ = cos(wc_);
+    h_->a[0] = -2 * r_ * cos_;
+    h_->a[1] = r_ * r_;
 
     /*
      * Normalize by placing poles near DC and nyquist
      * There are lots of different propositions of ways to do this
      * This way seems to behave the best for a large range of r
      */
-    b[0] = g_ * r_;
-    b[1] = 0;
-    b[2] = -b[0];
+    h_->b0 = g_ * r_;
+
+    h_->yn[0] = h_->yn[1] = 0;
+  }
+
+  float fc() const { return fc_; }
+  float r() const { return r_; }
+  float g() const { return g_; }
+
+  // Rewrite the coefficients from the parameters, for when something else has changed them
+  void refresh()
+  {
+    h_->a[0] = -2 * r_ * cos_;
+    h_->a[1] = r_ * r_;
+    h_->b0 = g_ * r_;
+  }
+
+  // Output nothing until the next update_g. The pole coefficients are kept
+  void silence()
+  {
+    g_ = 0;
+    h_->b0 = 0;
+    h_->yn[0] = h_->yn[1] = 0;
   }
 
   void update_fc(float fc)
@@ -60,19 +141,37 @@ class iir_reson : public dumb_biquad
     if (fc != fc_) {
       fc_ = fc;
       wc_ = to_wc_ * fc_;
-      a[0] = -2 * r_ * cos(wc_);
+      cos_ = cos(wc_);
+      h_->a[0] = -2 * r_ * cos_;
+    }
+  }
+
+  // cos(wc) for a cutoff of fc, worked out the way update_fc does it
+  float cos_wc(float fc) const
+  {
+    float wc = to_wc_ * fc;
+    return cos(wc);
+  }
+
+  // update_fc with cos(wc) from cos_wc, for coefficients worked out ahead of time
+  void set_fc(float fc, float cos_wc)
+  {
+    if (fc != fc_) {
+      fc_ = fc;
+      wc_ = to_wc_ * fc_;
+      cos_ = cos_wc;
+      h_->a[0] = -2 * r_ * cos_;
     }
   }
 
+  // Radius only, cos(wc) is kept from the last frequency change
   void update_r(float r)
   {
     if (r != r_) {
       r_ = r;
-      wc_ = to_wc_ * fc_;
-      a[0] = -2 * r_ * cos(wc_);
-      a[1] = r_ * r_;
-      b[0] = g_ * r_;
-      b[2] = -b[0];
+      h_->a[0] = -2 * r_ * cos_;
+      h_->a[1] = r_ * r_;
+      h_->b0 = g_ * r_;
     }
   }
 
@@ -80,15 +179,14 @@ class iir_reson : public dumb_biquad
   {
     if (g != g_) {
       g_ = g;
-      b[0] = g_ * r_;
-      b[2] = -b[0];
+      h_->b0 = g_ * r_;
     }
   }
 
   private:
-    float fs_, fc_, wc_, r_, g_, to_wc_;
+    reson_hot *h_ = nullptr;
+    float fs_ = 0, fc_ = 0, wc_ = 0, cos_ = 1, r_ = 0, g_ = 0, to_wc_ = 0;
 };
 } // namespace daisysp
 #endif
 #endif
-
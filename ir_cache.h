@@ -0,0 +1,326 @@
+#pragma once
+#ifndef DSY_IR_CACHE_H
+#define DSY_IR_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "arm_math.h"
+#include "denormal.h"
+#ifdef __cplusplus
+
+// Responses held at once
+#define IR_CACHE_SLOTS	  16
+// Longest response, in samples. Voices that ring longer always run live
+#define IR_CACHE_LEN	  96000
+// Voice state is kept every this many samples so a cached note can go back to its resonators
+#define IR_CACHE_SNAP	  256
+#define IR_CACHE_SNAPS	  (IR_CACHE_LEN / IR_CACHE_SNAP + 1)
+// Most modes a cached voice can have
+#define IR_CACHE_MAX_MODES 16
+// Room in a key and a state snapshot, see the voices' save_coefs and load_state
+#define IR_CACHE_COEFS	  (4 + 3 * IR_CACHE_MAX_MODES)
+#define IR_CACHE_STATE	  (4 + 2 * IR_CACHE_MAX_MODES)
+// A response has ended once output and state stay below this (per unit gain and ping)
+#define IR_CACHE_FLOOR	  1e-7f
+// A voice is pinged from the cache only when its own state is below this
+#define IR_CACHE_REST	  1e-6f
+// Samples rendered per Service call
+#define IR_CACHE_CHUNK	  4096
+
+namespace daisysp
+{
+/*
+ * A voice's coefficients with its gain divided out, in the layout the voices write:
+ *   n_modes, input filter b0 b1 a1, then a[0] a[1] b0 for each mode
+ */
+struct ir_key
+{
+  int len;
+  uint32_t hash;
+  float c[IR_CACHE_COEFS];
+
+  void Hash()
+  {
+    hash = 2166136261u;
+    const uint8_t *p = (const uint8_t *)c;
+    for (size_t i = 0; i < len * sizeof(float); i++) {
+      hash = (hash ^ p[i]) * 16777619u;
+    }
+  }
+
+  bool operator==(const ir_key &o) const
+  {
+    return hash == o.hash && len == o.len && !memcmp(c, o.c, len * sizeof(float));
+  }
+};
+
+// Rounded to 16 bits of mantissa, so gains that differ only by rounding give the same key
+inline float ir_quantize(float x)
+{
+  uint32_t u;
+  memcpy(&u, &x, sizeof(u));
+  u = (u + 0x40) & ~0x7fu;
+  memcpy(&x, &u, sizeof(x));
+  return x;
+}
+
+/*
+ * ir_cache
+ *
+ * Impulse responses of pinged voices, so a note whose voice was at rest and whose
+ * parameters haven't moved plays back from memory instead of running its resonators.
+ * A response is the voice's output for a unit ping with its gain divided out,
+ * the engine scales it by the ping and the voice's gain.
+ *
+ * The audio side only looks responses up. A miss posts a request and the note plays live,
+ * the main loop renders requests a chunk at a time with Service into the least recently
+ * used slot nobody is playing. Responses that haven't died away within IR_CACHE_LEN
+ * are remembered as uncacheable so they aren't asked for again.
+ *
+ * Every IR_CACHE_SNAP samples the renderer also keeps the voice's state, StateAt rebuilds
+ * the state at any point from there so a cached note can be handed back to its resonators
+ * when its parameters move or it is retriggered while still ringing.
+ *
+ * About 7MB with the defaults - SDRAM on the Pod. No constructor, call Init,
+ * so it can live in a section that isn't there until the hardware is up.
+ */
+class ir_cache
+{
+  public:
+    void Init()
+    {
+      for (int s = 0; s < IR_CACHE_SLOTS; s++) {
+	slots_[s].state.store(EMPTY);
+	slots_[s].users.store(0);
+	slots_[s].last_use.store(0);
+	slots_[s].len = 0;
+      }
+      clock_.store(0);
+      request_posted_.store(false);
+      rendering_ = -1;
+      hits_ = misses_ = 0;
+    }
+
+    // Audio side
+
+    // A slot holding key's response, acquired, or -1. A miss asks for it to be rendered
+    int Find(const ir_key &key)
+    {
+      uint32_t now = clock_.fetch_add(1, std::memory_order_relaxed);
+      for (int s = 0; s < IR_CACHE_SLOTS; s++) {
+	slot &sl = slots_[s];
+	uint8_t state = sl.state.load();
+	if (state == EMPTY || !(sl.key == key)) continue;
+	if (state != READY) return -1;
+	// Claim before checking again, see Claim
+	sl.users.fetch_add(1);
+	if (sl.state.load() != READY) {
+	  sl.users.fetch_sub(1);
+	  return -1;
+	}
+	sl.last_use.store(now, std::memory_order_relaxed);
+	hits_++;
+	return s;
+      }
+      misses_++;
+      if (!request_posted_.load(std::memory_order_acquire)) {
+	request_ = key;
+	request_posted_.store(true, std::memory_order_release);
+      }
+      return -1;
+    }
+
+    void Release(int s)
+    {
+      slots_[s].users.fetch_sub(1);
+    }
+
+    const float *Samples(int s) const { return samples_[s]; }
+    uint32_t Length(int s) const { return slots_[s].len; }
+    const ir_key &Key(int s) const { return slots_[s].key; }
+    int Modes(int s) const { return Modes(slots_[s].key); }
+
+    // Slot s's voice state pos samples after the ping, in the voices' load_state layout
+    void StateAt(int s, uint32_t pos, float *state) const
+    {
+      const slot &sl = slots_[s];
+      uint32_t snap = pos / IR_CACHE_SNAP;
+      int n = StateLen(sl.key);
+      memcpy(state, states_[s][snap], n * sizeof(float));
+      for (uint32_t i = snap * IR_CACHE_SNAP; i < pos; i++) {
+	Step(sl.key, state, i == 0 ? 1 : 0);
+      }
+    }
+
+    uint32_t Hits() const { return hits_; }
+    uint32_t Misses() const { return misses_; }
+
+    // Main loop side
+
+    // Render up to budget samples of whatever has been asked for. True while there's work left
+    bool Service(uint32_t budget = IR_CACHE_CHUNK)
+    {
+#ifndef MODAL_KEEP_DENORMALS
+      // Rendered the way the audio side would run it
+      denormal_guard ftz;
+#endif
+      if (rendering_ < 0) {
+	if (!request_posted_.load(std::memory_order_acquire)) return false;
+	if (Held(request_)) {
+	  // Asked for twice before the first render finished
+	  request_posted_.store(false, std::memory_order_release);
+	  return false;
+	}
+	rendering_ = Claim(request_);
+	// Every slot is playing, try again later
+	if (rendering_ < 0) return true;
+	request_posted_.store(false, std::memory_order_release);
+	render_pos_ = 0;
+	quiet_ = 0;
+	memset(render_state_, 0, sizeof(render_state_));
+      }
+
+      slot &sl = slots_[rendering_];
+      float *out = samples_[rendering_];
+      int n_state = StateLen(sl.key);
+      for (uint32_t i = 0; i < budget; i++) {
+	if (render_pos_ % IR_CACHE_SNAP == 0) {
+	  // Snapshots hold the state before the sample at their position is produced
+	  memcpy(states_[rendering_][render_pos_ / IR_CACHE_SNAP], render_state_, n_state * sizeof(float));
+	  if (render_pos_ > 0 && quiet_ >= IR_CACHE_SNAP && Quiet(render_state_, n_state)) {
+	    Finish(READY);
+	    return false;
+	  }
+	}
+	if (render_pos_ == IR_CACHE_LEN) {
+	  Finish(UNCACHEABLE);
+	  return false;
+	}
+	// A unit ping on the first sample
+	float y = Step(sl.key, render_state_, render_pos_ == 0 ? 1 : 0);
+	out[render_pos_++] = y;
+	quiet_ = fabsf(y) < IR_CACHE_FLOOR ? quiet_ + 1 : 0;
+      }
+      return true;
+    }
+
+  private:
+    enum { EMPTY = 0, RENDERING, READY, UNCACHEABLE };
+
+    struct slot
+    {
+      ir_key key;
+      std::atomic<uint8_t> state;
+      std::atomic<uint8_t> users;
+      std::atomic<uint32_t> last_use;
+      uint32_t len;
+    };
+
+    static int Modes(const ir_key &key) { return (key.len - 4) / 3; }
+    static int StateLen(const ir_key &key) { return 4 + 2 * Modes(key); }
+
+    /*
+     * One sample of the voice from its coefficients, the same arithmetic as iir_1p_lp,
+     * reson_input and reson_process. state is input filter x y, input x[n-1] x[n-2], then y[n-1] y[n-2] per mode
+     */
+    static float Step(const ir_key &key, float *state, float in)
+    {
+      const float *c = key.c;
+      float filt = in * c[1] + state[0] * c[2] - c[3] * state[1];
+      state[0] = in;
+      state[1] = filt;
+      float d = filt - state[3];
+      state[3] = state[2];
+      state[2] = filt;
+      float out = 0;
+      int n = Modes(key);
+      for (int i = 0; i < n; i++) {
+	const float *m = &c[4 + 3 * i];
+	float *y = &state[4 + 2 * i];
+	float v = m[2] * d - m[0] * y[0] - m[1] * y[1];
+	y[1] = y[0];
+	y[0] = v;
+	out += v / c[0];
+      }
+      return out;
+    }
+
+    static bool Quiet(const float *state, int n)
+    {
+      for (int i = 0; i < n; i++) {
+	if (fabsf(state[i]) >= IR_CACHE_FLOOR) return false;
+      }
+      return true;
+    }
+
+    bool Held(const ir_key &key) const
+    {
+      for (int s = 0; s < IR_CACHE_SLOTS; s++) {
+	if (slots_[s].state.load() != EMPTY && slots_[s].key == key) return true;
+      }
+      return false;
+    }
+
+    /*
+     * Take the least recently used slot nobody is playing, -1 if there isn't one yet
+     * The slot is marked first and its users checked after, Find adds a user first and checks
+     * the mark after, so whichever side looks second backs off.
+     */
+    int Claim(const ir_key &key)
+    {
+      int best = -1;
+      uint32_t oldest = 0;
+      uint32_t now = clock_.load(std::memory_order_relaxed);
+      for (int s = 0; s < IR_CACHE_SLOTS; s++) {
+	slot &sl = slots_[s];
+	uint8_t state = sl.state.load();
+	if (sl.users.load() != 0) continue;
+	uint32_t age = state == EMPTY ? UINT32_MAX : now - sl.last_use.load(std::memory_order_relaxed);
+	if (best < 0 || age > oldest) {
+	  best = s;
+	  oldest = age;
+	}
+      }
+      if (best < 0) return -1;
+      slot &sl = slots_[best];
+      uint8_t was = sl.state.load();
+      sl.state.store(RENDERING);
+      if (sl.users.load() != 0) {
+	sl.state.store(was);
+	return -1;
+      }
+      sl.key = key;
+      sl.len = 0;
+      sl.last_use.store(now, std::memory_order_relaxed);
+      return best;
+    }
+
+    void Finish(uint8_t state)
+    {
+      slot &sl = slots_[rendering_];
+      sl.len = render_pos_;
+      sl.state.store(state);
+      rendering_ = -1;
+    }
+
+    slot slots_[IR_CACHE_SLOTS];
+    float samples_[IR_CACHE_SLOTS][IR_CACHE_LEN];
+    float states_[IR_CACHE_SLOTS][IR_CACHE_SNAPS][IR_CACHE_STATE];
+    std::atomic<uint32_t> clock_;
+    uint32_t hits_, misses_;
+
+    // One request in flight from the audio side to the main loop
+    ir_key request_;
+    std::atomic<bool> request_posted_;
+
+    // The render in progress
+    int rendering_;
+    uint32_t render_pos_;
+    uint32_t quiet_;
+    float render_state_[IR_CACHE_STATE];
+};
+} // namespace daisysp
+#endif
+#endif
@@ -0,0 +1,402 @@
+#pragma once
+#ifndef DSY_MODAL_CHORD_H
+#define DSY_MODAL_CHORD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include "arm_math.h"
+#include "iir_reson.h"
+#include "iir_1p_lp.h"
+#include "denormal.h"
+#include "modal_note.h"
+#include "modal_voice.h"
+#include "tuning.h"
+#ifdef MODAL_CMSIS_BIQUAD
+#include "reson_bank_cmsis.h"
+#endif
+#ifdef __cplusplus
+
+// Most notes one chord voice plays
+#define CHORD_MAX_TONES	  4
+
+/*
+ * Chord shapes: notes above the played note, in steps of the tuning, and a detune in cents
+ * spread evenly across the tones, lowest tone flattest
+ */
+typedef struct {
+  int tones;
+  int intervals[CHORD_MAX_TONES];
+  float detune;
+} chord_shape;
+
+#define NUM_CHORD_SHAPES 8
+const chord_shape chord_shapes[NUM_CHORD_SHAPES] = {
+  // Off, single notes
+  {1, {0}, 0},
+  // Unison
+  {4, {0, 0, 0, 0}, 12},
+  // Fifth and octave
+  {3, {0, 7, 12}, 0},
+  // Major
+  {3, {0, 4, 7}, 0},
+  // Minor
+  {3, {0, 3, 7}, 0},
+  // Sus4
+  {3, {0, 5, 7}, 0},
+  // Major 7th
+  {4, {0, 4, 7, 11}, 0},
+  // Minor 7th
+  {4, {0, 3, 7, 10}, 0},
+};
+
+namespace daisysp
+{
+/*
+ * modal_chord
+ *
+ * K harmonic notes played as one wide voice: the modes of every tone are laid out in one
+ * reson_hot array behind a single input filter and input history, so a K note chord
+ * costs one K * N mode loop rather than K voices each with their own excitation.
+ *
+ * The modes are modal_note's, the frequency ratios, gains and resonances each harmonic gets
+ * are worked out once when stiffness, beta, gain or mgf move and shared by every tone,
+ * so a new chord only multiplies its tones' fundamentals through them.
+ * Each tone's 1 / n_modes normalisation is folded into its gains, every tone is as loud
+ * as a modal_note would play it.
+ *
+ * Always runs K * N modes, unused tones are silent. No mode budget or multirate.
+ */
+template <int N, int K>
+class modal_chord : public modal_voice<modal_chord<N, K>, N * K>
+{
+    friend class modal_voice<modal_chord<N, K>, N * K>;
+
+  public:
+    modal_chord()
+    {
+      for (int j = 0; j < N * K; j++) {
+	modes[j].attach(&hot_[j]);
+      }
+      hot_.fill(reson_hot());
+      side_.fill(0);
+    }
+    // The resonators point into hot_
+    modal_chord(const modal_chord &) = delete;
+    modal_chord &operator=(const modal_chord &) = delete;
+
+    void init(float fs, float fc, float r)
+    {
+      fs_ = fs;
+      r_ = r;
+      gdb_ = DEFAULT_GDB;
+      g_ = powf(10, gdb_ / 20.0);
+      stiffness_ = DEFAULT_STIFF;
+      beta_ = DEFAULT_BETA;
+      mgf_ = DEFAULT_MGF;
+      mrf_ = 0;
+      bend_ = 1;
+      press_ = 0;
+
+      update_ratios();
+      update_res();
+      update_gains();
+      for (int j = 0; j < N * K; j++) {
+	int i = j % N;
+	modes[j].init(fs_, ratio_[i] * fc, res_[i], 0);
+      }
+      for (int k = 0; k < K; k++) {
+	tone_fc_[k] = k == 0 ? fc : 0;
+	tune(k);
+      }
+
+      input_filt.init(fs_, DEFAULT_IFC);
+      input_hist_.Reset();
+#ifdef MODAL_CMSIS_BIQUAD
+      cmsis_.Reset();
+#endif
+    }
+
+    float Process(float in)
+    {
+      return ProcessFiltered(input_filt.Process(in + input_hist_.offset));
+    }
+
+    // in_filt has already been through an input filter at this voice's cutoff
+    float ProcessFiltered(float in_filt)
+    {
+      float out = 0;
+      float d = input_hist_.Process(in_filt);
+      // Gains are already normalised, silent modes cost the same as the rest
+      for (int j = 0; j < N * K; j++) {
+	out += reson_process(hot_[j], d);
+      }
+      return out;
+    }
+
+    // Stereo versions, side receives the modes weighted by their side gains, see set_pan
+    float Process(float in, float &side)
+    {
+      return ProcessFiltered(input_filt.Process(in + input_hist_.offset), side);
+    }
+
+    float ProcessFiltered(float in_filt, float &side)
+    {
+      float d = input_hist_.Process(in_filt);
+      float out = 0, s = 0;
+      for (int j = 0; j < N * K; j++) {
+	float v = reson_process(hot_[j], d);
+	out += v;
+	s += v * side_[j];
+      }
+      side = s;
+      return out;
+    }
+
+    // Each tone's modes alternate either side of pan the way a modal_note's do
+    void set_pan(float pan, float spread)
+    {
+      for (int j = 0; j < N * K; j++) {
+	float g = pan + ((j % N) & 1 ? spread : -spread);
+	side_[j] = CLAMP(g, -1.0f, 1.0f);
+      }
+    }
+
+    /*
+     * Play tones fundamentals, fc[0] first. Tones past tones, or at 0 Hz, are silent.
+     * Tones that keep their pitch carry on ringing.
+     * pitch, if given, has each tone's pitch_table entry for exactly fc[k] made with
+     * pitch_key, or null for tones that work their modes out themselves
+     */
+    void set_chord(const float *fc, int tones, const pitch_entry<N> *const *pitch = nullptr)
+    {
+      for (int k = 0; k < K; k++) {
+	float f = k < tones ? fc[k] : 0;
+	if (f != tone_fc_[k]) {
+	  tone_fc_[k] = f;
+	  tune(k, k < tones && pitch ? pitch[k] : nullptr);
+	}
+      }
+    }
+
+    // What the tones' mode frequencies depend on besides the fundamental, as modal_note's pitch_key
+    void pitch_key(uint32_t *key) const
+    {
+      key[0] = pitch_bits(stiffness_);
+      key[1] = beta_;
+      key[2] = N;
+    }
+
+    float tone_fc(int k) const { return tone_fc_[k]; }
+
+    void update_r(float r)
+    {
+      if (r != r_) {
+	r_ = r;
+	update_res();
+	for (int j = 0; j < N * K; j++) {
+	  modes[j].update_r(pressed(res_[j % N]));
+	}
+      }
+    }
+
+    void update_g(float g)
+    {
+      if (g != g_) {
+	g_ = g;
+	update_gains();
+	for (int k = 0; k < K; k++) {
+	  apply_gains(k);
+	}
+      }
+    }
+
+    void update_stiffness(float stiffness)
+    {
+      if (stiffness != stiffness_) {
+	stiffness_ = stiffness;
+	update_ratios();
+	for (int k = 0; k < K; k++) {
+	  tune(k);
+	}
+      }
+    }
+
+    void update_beta(int beta)
+    {
+      if (beta != beta_) {
+	beta_ = beta;
+	update_ratios();
+	// The harmonics picked have moved, so have their gains and resonances
+	update_res();
+	update_gains();
+	for (int j = 0; j < N * K; j++) {
+	  modes[j].update_r(pressed(res_[j % N]));
+	}
+	for (int k = 0; k < K; k++) {
+	  tune(k);
+	}
+      }
+    }
+
+    void update_mgf(float mgf)
+    {
+      if (mgf != mgf_) {
+	mgf_ = mgf;
+	update_gains();
+	for (int k = 0; k < K; k++) {
+	  apply_gains(k);
+	}
+      }
+    }
+
+    // Pitch bend: every tone at ratio times its fundamental, only its modes' frequencies are rewritten
+    void bend(float ratio)
+    {
+      if (ratio != bend_) {
+	bend_ = ratio;
+	for (int k = 0; k < K; k++) {
+	  tune(k);
+	}
+      }
+    }
+
+    // Pressure: every mode's pole radius amt (0 to 1) of the way up to RES_MAX, the radius is all that's rewritten
+    void press(float amt)
+    {
+      if (amt != press_) {
+	press_ = amt;
+	for (int j = 0; j < N * K; j++) {
+	  modes[j].update_r(pressed(res_[j % N]));
+	}
+      }
+    }
+
+    void update_ifc(float ifc)
+    {
+      input_filt.update_fc(ifc);
+    }
+
+    // Each sounding mode's frequency, pole radius and gain at resonance, see modal_note::resonances
+    int resonances(float *fc, float *r, float *peak) const
+    {
+      int n = 0;
+      for (int j = 0; j < N * K; j++) {
+	float g = modes[j].g() * modes[j].r();
+	if (g == 0) continue;
+	fc[n] = modes[j].fc();
+	r[n] = modes[j].r();
+	// The normalisation is already in the gain
+	peak[n] = g / (1 - r[n]);
+	n++;
+      }
+      return n;
+    }
+
+  private:
+    // Nothing to reload when modal_voice rewrites the modes' state
+    void state_changed() {}
+
+    // The gains are already normalised
+    int divisor() const
+    {
+      return 1;
+    }
+
+    // The harmonics modal_note picks, as multiples of the fundamental
+    void update_ratios()
+    {
+      int calculated_modes = 0;
+      for (int i = 0; calculated_modes < N; i++) {
+
+	// skip modes defined by beta
+	if (fmod(i, beta_) == 0) continue;
+
+	ratio_[calculated_modes] = (i + 1) * sqrt(1 + stiffness_ * pow(i, 2));
+	harm_[calculated_modes] = i;
+	calculated_modes++;
+      }
+    }
+
+    void update_res()
+    {
+      for (int i = 0; i < N; i++) {
+	float mode_r = r_ - harm_[i] * mrf_;
+	res_[i] = CLAMP(mode_r, 0, RES_MAX);
+      }
+    }
+
+    void update_gains()
+    {
+      for (int i = 0; i < N; i++) {
+	gain_[i] = g_ / pow((harm_[i] + 1), mgf_);
+      }
+    }
+
+    // Tone k's modes from its fundamental, modes above Nyquist are silent.
+    // Unbent tones with a pitch_table entry copy its coefficients instead
+    void tune(int k, const pitch_entry<N> *e = nullptr)
+    {
+      int n = 0;
+      if (e && bend_ == 1) {
+	n = e->n_set;
+	for (int i = 0; i < n; i++) {
+	  modes[k * N + i].set_fc(e->mode_fc[i], e->cos_wc[i]);
+	}
+      } else {
+	float fc = tone_fc_[k] * bend_;
+	if (fc > 0) {
+	  while (n < N && ratio_[n] * fc <= fs_ / 2) n++;
+	}
+	for (int i = 0; i < n; i++) {
+	  modes[k * N + i].update_fc(ratio_[i] * fc);
+	}
+      }
+      tone_modes_[k] = n;
+      apply_gains(k);
+    }
+
+    float pressed(float mode_r) const
+    {
+      return mode_r + press_ * (RES_MAX - mode_r);
+    }
+
+    void apply_gains(int k)
+    {
+      int n = tone_modes_[k];
+      for (int i = 0; i < N; i++) {
+	if (i < n) {
+	  modes[k * N + i].update_g(gain_[i] / n);
+	} else {
+	  modes[k * N + i].silence();
+	}
+      }
+#ifdef MODAL_CMSIS_BIQUAD
+      for (int i = n; i < N; i++) {
+	cmsis_.SetState(k * N + i, 0, 0, 0, 0);
+      }
+#endif
+    }
+
+    alignas(RESON_ALIGN) std::array<reson_hot, N * K> hot_;	// hot - contiguous, walked every sample
+    reson_input input_hist_;
+#ifdef MODAL_CMSIS_BIQUAD
+    reson_bank_cmsis<N * K> cmsis_;
+#endif
+    std::array<iir_reson, N * K> modes;	// cold - touched at control rate
+    iir_1p_lp input_filt;
+    std::array<float, N * K> side_;	// per-mode side gain, see set_pan
+
+    // Shared by every tone, indexed by mode
+    float ratio_[N], gain_[N], res_[N];
+    int harm_[N];
+
+    float tone_fc_[K];
+    int tone_modes_[K];
+    float bend_ = 1, press_ = 0;
+    float fs_, r_, gdb_, g_, stiffness_, mgf_, mrf_;
+    int beta_;
+};
+} // namespace daisysp
+#endif
+#endif
@@ -0,0 +1,1760 @@
+#pragma once
+#ifndef DSY_MODAL_ENGINE_H
+#define DSY_MODAL_ENGINE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "daisysp.h"
+#include "modal_note.h"
+#include "modal_inharm.h"
+#include "modal_chord.h"
+#ifdef MODAL_OLA
+#include "modal_ola.h"
+#endif
+#include "ir_cache.h"
+#include "exciter_bank.h"
+#include "crc_noise.h"
+#include "tri_lfo.h"
+#include "PagedParam.h"
+#include "param_store.h"
+#include "trace_ring.h"
+#include "cpu_governor.h"
+#include "waveshaper.h"
+#include "denormal.h"
+#ifdef __cplusplus
+
+#define TRACE_RING_SIZE	1024
+#define TRACE_ACTIVE_THRESH 0.0001f
+
+#define NUM_HARM_PARTIALS   4
+#define NUM_NOTES	    5
+
+// Longest stretch rendered in one pass, larger host blocks are split
+#define ENGINE_MAX_BLOCK    256
+
+#define NUM_LFOS      3
+#define LFO_RATE_DEFAULT 0.3
+#define LFO_RATE_MIN  0
+#define LFO_RATE_MAX  60
+#define LFO_DEPTH_MIN 0.0f
+#define LFO_DEPTH_MAX 1.0f
+#define LFO_IFC	      0
+#define LFO_STIFF     1
+#define LFO_BETA      2
+
+#define PING_AMT      	    1 //0.25
+
+#define PARAM_THRESH	  0.05f
+
+#define RES_MIN	  0.99333
+#define RES_MAX   0.99999
+#define IFC_DEFAULT 220
+#define IFC_MIN   10
+#define IFC_MAX   22000
+#define GAIN_DEFAULT 5
+#define GAIN_MIN  0.0f
+#define STIFF_MIN 0
+#define STIFF_MAX 0.005
+#define BETA_MIN  2
+#define BETA_MAX  5
+#define MGF_DEFAULT 0
+#define MGF_MIN	  -1
+#define MGF_MAX   3
+#define ENV_DEFAULT 0.015
+#define ENV_MIN	  0.001
+#define ENV_MAX	  0.1
+// Stereo: width scales the side signal, 0 is mono. Voices are panned up to +-PAN_SPREAD apart
+// and each voice's modes +-MODE_SPREAD either side of it
+#define WIDTH_DEFAULT	    0.0f
+#define WIDTH_MAX	    2.0f
+#define PAN_SPREAD_DEFAULT  0.5f
+#define MODE_SPREAD_DEFAULT 0.3f
+// Sympathetic resonance: how loud a voice rings in sympathy with a voice it is tuned to,
+// mode pairs couple when they are within SYMP_WIDTH of their combined bandwidths
+#define SYMP_DEFAULT	    0.0f
+#define SYMP_MAX	    0.5f
+#define SYMP_WIDTH	    2.0f
+// The most modes any voice has, a chord's
+#define SYMP_MODES	    (NUM_HARM_PARTIALS * CHORD_MAX_TONES)
+// A voice the governor steals fades out over this many samples before it's cleared
+#define STEAL_FADE_SAMPLES  CULL_FADE_SAMPLES
+
+// Expression: pitch bend ranges in semitones, for channel 0 (the MPE master) and for MPE member channels.
+// Timbre on a member channel moves its voice's input filter cutoff up to TIMBRE_OCTAVES either way
+#define BEND_RANGE_DEFAULT	2
+#define MPE_BEND_RANGE_DEFAULT	48
+#define TIMBRE_OCTAVES		2.0f
+#define MIDI_CHANNELS		16
+#define RPN_NULL		0x3fff
+#define RPN_BEND_RANGE		0
+#define RPN_MPE			6
+
+#define CC_TO_VAL(x, min, max) (min + (x / 127.0f) * (max - min))
+
+#define CC_MOD	       	1
+#define CC_GAIN       	7
+#define	CC_IFC		14
+#define CC_STIFF      	70
+#define CC_BETA       	71
+#define CC_REL        	72
+#define CC_ATK        	73
+#define CC_MGF	       	74
+#define CC_MODE		75
+#define CC_INHARM	76
+#define CC_PAN		10
+#define CC_SPREAD	77
+#define CC_WIDTH	78
+#define CC_CHORD	79
+#define CC_SYMP		80
+#define CC_EXCITER	81
+// On MPE member channels CC 74 is the voice's timbre rather than MGF
+#define CC_TIMBRE	74
+#define CC_DATA		6
+#define CC_RPN_LSB	100
+#define CC_RPN_MSB	101
+#define CC_LFO_IFC_R  	85
+#define CC_LFO_IFC_D  	86
+#define CC_LFO_STIFF_R	87
+#define CC_LFO_STIFF_D	88
+#define CC_LFO_BETA_R	89
+#define CC_LFO_BETA_D	90
+
+/*
+ * Denormal policy: Process runs with subnormals flushed to zero unless MODAL_KEEP_DENORMALS is defined.
+ * SetDenormalOffset adds DENORMAL_OFFSET to the resonator inputs for FPUs where flushing isn't available.
+ * Define MODAL_DENORMAL_STATS to count subnormal filter state after every block.
+ *
+ * With MODAL_OLA each inharmonic voice also has a modal_ola twin fed the same controls,
+ * SetOlaVoice picks which of the two renders it.
+ *
+ * Stereo: every voice sums its modes into a mid bus and, weighted by per-mode side gains,
+ * a side bus. The outputs are mid +- width * side. At width 0 only the mid bus is run
+ * and both outputs are identical.
+ *
+ * With an ir_cache attached, pings in PING and INHARM mode on voices at rest play the voice's
+ * cached impulse response. A cached voice goes back to its resonators, exactly where the
+ * response had got to, as soon as anything it depends on moves or it is pinged again.
+ *
+ * With a chord shape set, harmonic note-ons play the whole chord on one modal_chord voice,
+ * sharing one excitation. A voice is either a chord or a single note, switching kinds cuts its tail.
+ *
+ * Sympathetic resonance: with SetSympathetic above 0 every voice's output from the last block
+ * is fed into the voices it shares a resonance with, after their input filters.
+ * Only voice pairs with modes close in frequency are coupled, so the cost is a multiply-add
+ * per coupled pair per sample. The couplings are worked out again whenever pitches or
+ * timbre move. Coupled voices always run live, OLA voices aren't coupled.
+ *
+ * Expression: pitch bend, channel and poly pressure, and with MPE (SetMpe, or an MPE Configuration
+ * Message) each note's own channel's bend, pressure and timbre. Messages only note what each voice
+ * should be doing. Once per block the voices that have moved are updated, however many messages
+ * arrived: bend scales the voice's mode frequencies, pressure only rewrites pole radii, timbre
+ * the input filter. OLA twins follow the bend only.
+ *
+ * Parameters: pots, CCs (including CC 1) and hosts only SetParam into a param_store.
+ * Once per block the audio side takes the mask of what was set since the last block and
+ * updates the voices for those parameters alone, a burst of CCs costs one update of each.
+ *
+ * Governor: with SetGovernor on, the load passed to ReportLoad after each block steps quality
+ * down and back up, see cpu_governor.h. Each rung taken, on top of the user's own settings:
+ *   GOV_PRECISION  SetPrecision off
+ *   GOV_MODES      every single note and inharmonic voice runs half as many modes, chords are left alone
+ *   GOV_CONTROL    the LFOs are read, and the voices they modulate updated, every other block
+ *   GOV_VOICES     the oldest voice fades out, is stopped and is left out of note allocation
+ * and the rungs given back restore them.
+ *
+ * SAMPLE mode excites harmonic voices with a transient from the exciter_bank given to SetExciters,
+ * played from the bank's memory in the ping's place and resampled to each note. Without a bank
+ * it pings.
+ */
+
+#ifdef MODAL_TRACE
+#define TRACE(...) tracer.Record(__VA_ARGS__)
+#else
+#define TRACE(...)
+#endif
+
+namespace daisysp
+{
+typedef enum {MIDI = 0, GAIN_OUT, STIFF_BETA, STIFF_LFO, BETA_LFO, IFC_MGF, IFC_LFO, AD, LAST_PAGE} ui_page;
+// New modes go last so CC 75 values and the Button 2 order keep the modes they had
+typedef enum {PING = 0, NOISE_ENV, EXT, EXT_ENV, INHARM, INHARM_NOISE, SAMPLE, LAST_MODE} ui_mode;
+
+/*
+ * The synth engine without any hardware attached
+ * Voices, excitation, modulation and the parameters shared between the pots and MIDI.
+ * The firmware feeds it from the Pod's controls and audio callback,
+ * host tools drive it directly.
+ * All state is held by value so an instance can be placed in whichever RAM section suits.
+ */
+class modal_engine
+{
+  public:
+    modal_engine() {}
+    ~modal_engine() {}
+
+    void Init(float sr, float cr)
+    {
+      sr_ = sr;
+      for (int i = 0; i < NUM_NOTES; i++) {
+	notes[i].init(sr, 45, 0.9999);
+	chords[i].init(sr, 45, 0.9999);
+	chord_voice_[i] = false;
+	inharms[i].init(sr, 45, &inharm_presets[cur_preset]);
+#ifdef MODAL_OLA
+	olas[i].init(sr, 45, &inharm_presets[cur_preset]);
+#endif
+
+	ir_slot_[i] = -1;
+	exc_voices_[i].Stop();
+	env[i].Init(sr);
+      	env[i].SetTime(ADSR_SEG_ATTACK, ENV_DEFAULT);
+      	env[i].SetTime(ADSR_SEG_DECAY, ENV_DEFAULT);
+	env[i].SetCurve(20);
+      }
+
+      noise.Init();
+      ext_filt.init(sr, DEFAULT_IFC);
+      exc_kernel_.Init();
+
+      g_p.Init(         (uint8_t)GAIN_OUT,    GAIN_DEFAULT,  GAIN_MIN,   GAIN_MAX,   PARAM_THRESH);
+      inharm_g_p.Init(  (uint8_t)GAIN_OUT,    GAIN_DEFAULT,  0.0f,       (LAST_OUTPUT - 1), PARAM_THRESH);
+      out_p.Init(       (uint8_t)GAIN_OUT,    0.0f,          0.0f,       1.0f,       PARAM_THRESH);
+      at_p.Init(        (uint8_t)AD,          ENV_DEFAULT,   ENV_MIN,    ENV_MAX,    PARAM_THRESH);
+      dt_p.Init(        (uint8_t)AD,          ENV_DEFAULT,   ENV_MIN,    ENV_MAX,    PARAM_THRESH);
+      ifc_p.Init(       (uint8_t)IFC_MGF,     IFC_DEFAULT,   IFC_MIN,    IFC_MAX,    PARAM_THRESH);
+      stiff_p.Init(     (uint8_t)STIFF_BETA,  STIFF_MIN,     STIFF_MIN,  STIFF_MAX,  PARAM_THRESH);
+      beta_p.Init(      (uint8_t)STIFF_BETA,  BETA_MIN,      BETA_MIN,   BETA_MAX,   PARAM_THRESH);
+      mgf_p.Init(       (uint8_t)IFC_MGF,     MGF_DEFAULT,   MGF_MIN,    MGF_MAX,    PARAM_THRESH);
+
+      lfo_ifc_rate_p.Init(     (uint8_t)IFC_LFO,    LFO_RATE_DEFAULT,  LFO_RATE_MIN,   LFO_RATE_MAX,   PARAM_THRESH);
+      lfo_ifc_depth_p.Init(    (uint8_t)IFC_LFO,    LFO_DEPTH_MIN,     LFO_DEPTH_MIN,  LFO_DEPTH_MAX,  PARAM_THRESH);
+      lfo_stiff_rate_p.Init(   (uint8_t)STIFF_LFO,  LFO_RATE_DEFAULT,  LFO_RATE_MIN,   LFO_RATE_MAX,   PARAM_THRESH);
+      lfo_stiff_depth_p.Init(  (uint8_t)STIFF_LFO,  LFO_DEPTH_MIN,     LFO_DEPTH_MIN,  LFO_DEPTH_MAX,  PARAM_THRESH);
+      lfo_beta_rate_p.Init(    (uint8_t)BETA_LFO,   LFO_RATE_DEFAULT,  LFO_RATE_MIN,   LFO_RATE_MAX,   PARAM_THRESH);
+      lfo_beta_depth_p.Init(   (uint8_t)BETA_LFO,   LFO_DEPTH_MIN,     LFO_DEPTH_MIN,  LFO_DEPTH_MAX,  PARAM_THRESH);
+
+      float defaults[NUM_PARAMS];
+      defaults[PARAM_G] = GAIN_DEFAULT;
+      defaults[PARAM_OUT] = 0.0f;
+      defaults[PARAM_STIFF] = cur_stiff = STIFF_MIN;
+      defaults[PARAM_BETA] = cur_beta = BETA_MIN;
+      defaults[PARAM_IFC] = cur_ifc = IFC_DEFAULT;
+      defaults[PARAM_MGF] = MGF_DEFAULT;
+      defaults[PARAM_AT] = defaults[PARAM_DT] = ENV_DEFAULT;
+      defaults[PARAM_RES] = 0.0f;
+      defaults[PARAM_LFO_IFC_RATE] = defaults[PARAM_LFO_STIFF_RATE] = defaults[PARAM_LFO_BETA_RATE] = LFO_RATE_DEFAULT;
+      defaults[PARAM_LFO_IFC_DEPTH] = defaults[PARAM_LFO_STIFF_DEPTH] = defaults[PARAM_LFO_BETA_DEPTH] = LFO_DEPTH_MIN;
+      params_.Init(defaults);
+      param_carry_ = 0;
+
+      cur_mode = PING;
+      cur_output_mode = NONE;
+
+      SetTuning(nullptr);
+      SetChord(0);
+      SetMpe(0);
+      for (int i = 0; i < NUM_NOTES; i++) {
+	voice_chan_[i] = 0;
+	voice_note_[i] = -1;
+	voice_press_[i] = 0;
+	voice_fc_[i] = 45;
+	ifc_scale_[i] = 1;
+      }
+      SetSympathetic(SYMP_DEFAULT);
+
+      width_ = WIDTH_DEFAULT;
+      pan_spread_ = PAN_SPREAD_DEFAULT;
+      mode_spread_ = MODE_SPREAD_DEFAULT;
+      UpdatePans();
+
+      for (int i = 0; i < NUM_LFOS; i++) {
+	lfos[i].Init(cr);
+      }
+      lfos[LFO_IFC].SetRange(IFC_MAX - IFC_MIN);
+      lfos[LFO_STIFF].SetRange(STIFF_MAX - STIFF_MIN);
+      lfos[LFO_BETA].SetRange(BETA_MAX - BETA_MIN);
+      for (int i = 0; i < NUM_LFOS; i++) {
+	lfo_held_[i] = 0;
+      }
+
+      precision_ = false;
+      mode_budget_ = NUM_HARM_PARTIALS;
+      governed_ = false;
+      control_block_ = 0;
+      stolen_ = 0;
+      fading_ = 0;
+      governor_.Init(cr);
+      ApplyGovernor();
+
+#ifdef MODAL_TRACE
+      tracer.Init();
+#endif
+    }
+
+    // Restart the noise source from a known state for repeatable renders
+    void SeedNoise(uint32_t seed)
+    {
+      noise.Init(seed);
+    }
+
+    /*
+     * Render one block
+     * in is the external input, out_l and out_r receive the output
+     */
+    void Process(const float *in, float *out_l, float *out_r, size_t size)
+    {
+#ifndef MODAL_KEEP_DENORMALS
+      denormal_guard ftz;
+#endif
+      TRACE(TRACE_CB_START, 0, size);
+
+      UpdateParams();
+      UpdateExpression();
+
+      lfos[LFO_IFC].Process();
+      lfos[LFO_STIFF].Process();
+      lfos[LFO_BETA].Process();
+
+      for (size_t done = 0; done < size; done += ENGINE_MAX_BLOCK) {
+	size_t n = size - done < ENGINE_MAX_BLOCK ? size - done : ENGINE_MAX_BLOCK;
+	if (width_ == 0) {
+	  ProcessVoices(in + done, mix_, nullptr, n);
+	  for (size_t i = 0; i < n; i++) {
+	    float to_out = waveshape(mix_[i] * (1.0f / NUM_NOTES), cur_output_mode);
+	    out_l[done + i] = to_out;
+	    out_r[done + i] = to_out;
+	  }
+	} else {
+	  ProcessVoices(in + done, mix_, side_, n);
+	  for (size_t i = 0; i < n; i++) {
+	    float s = width_ * side_[i];
+	    out_l[done + i] = waveshape((mix_[i] + s) * (1.0f / NUM_NOTES), cur_output_mode);
+	    out_r[done + i] = waveshape((mix_[i] - s) * (1.0f / NUM_NOTES), cur_output_mode);
+	  }
+	}
+      }
+
+#ifdef MODAL_DENORMAL_STATS
+      subnormal_states_ = 0;
+      for (int i = 0; i < NUM_NOTES; i++) {
+	subnormal_states_ += notes[i].count_subnormal() + inharms[i].count_subnormal();
+	subnormal_states_ += chords[i].count_subnormal();
+#ifdef MODAL_OLA
+	subnormal_states_ += olas[i].count_subnormal();
+#endif
+      }
+      if (subnormal_states_ > max_subnormal_states_) {
+	max_subnormal_states_ = subnormal_states_;
+      }
+#endif
+
+      TRACE(TRACE_CB_END);
+    }
+
+    // Total harmonic modes to run, shared evenly between the voices
+    void SetModeBudget(int total)
+    {
+      mode_budget_ = total / NUM_NOTES;
+      ApplyGovernor();
+    }
+
+    // Harmonic voices run their low modes at decimated rates
+    void SetMultirate(bool on)
+    {
+      for (int i = 0; i < NUM_NOTES; i++) {
+	notes[i].set_multirate(on);
+      }
+    }
+
+    // Harmonic and inharmonic voices run low modes with error feedback or in double as they need
+    void SetPrecision(bool on)
+    {
+      precision_ = on;
+      ApplyGovernor();
+    }
+
+    // Step quality down when the callback runs out of time, see cpu_governor.h. Off gives it all back
+    void SetGovernor(bool on)
+    {
+      governed_ = on;
+      governor_.Reset();
+      ApplyGovernor();
+    }
+
+    // Rungs (gov_rungs) in the order they are taken, and the load thresholds
+    void SetGovernorLadder(const uint8_t *rungs, int n)
+    {
+      governor_.SetLadder(rungs, n);
+      ApplyGovernor();
+    }
+
+    void SetGovernorThresholds(float high, float low)
+    {
+      governor_.SetThresholds(high, low);
+    }
+
+    // After each block: the time it took as a fraction of the time it lasts
+    void ReportLoad(float load)
+    {
+      if (!governed_ || !governor_.Update(load)) return;
+      ApplyGovernor();
+      TRACE(TRACE_GOVERN, governor_.Level(), (uint16_t)(load * 1000));
+    }
+
+    int GovernorLevel() { return governed_ ? governor_.Level() : 0; }
+
+    // Main loop side, the governor's steps for logging
+    bool GovernorStep(gov_event &e) { return governor_.Pop(e); }
+
+    // Voices the governor has left to play
+    int LiveVoices()
+    {
+      int count = NUM_NOTES;
+      for (int i = 0; i < NUM_NOTES; i++) {
+	count -= (stolen_ >> i) & 1;
+      }
+      return count;
+    }
+
+    void SetDenormalOffset(bool on)
+    {
+      for (int i = 0; i < NUM_NOTES; i++) {
+	notes[i].set_denormal_offset(on ? DENORMAL_OFFSET : 0);
+	chords[i].set_denormal_offset(on ? DENORMAL_OFFSET : 0);
+	inharms[i].set_denormal_offset(on ? DENORMAL_OFFSET : 0);
+#ifdef MODAL_OLA
+	olas[i].set_denormal_offset(on ? DENORMAL_OFFSET : 0);
+#endif
+      }
+    }
+
+#ifdef MODAL_OLA
+    // Render inharmonic voice v in the frequency domain, the one switched to starts from rest
+    void SetOlaVoice(int voice, bool on)
+    {
+      uint32_t bit = 1u << voice;
+      if (on == ((ola_voices_ & bit) != 0)) return;
+      if (on) {
+	olas[voice].clear();
+	ola_voices_ |= bit;
+      } else {
+	inharms[voice].clear();
+	ola_voices_ &= ~bit;
+      }
+      symp_dirty_ = true;
+    }
+#endif
+
+    /*
+     * Every MIDI note's frequency in Hz, copied.
+     * nullptr is 12 tone equal temperament rounded down to whole Hz, the way notes have always played
+     */
+    void SetTuning(const float *freqs)
+    {
+      for (int n = 0; n < TUNING_NOTES; n++) {
+	freqs_[n] = freqs ? freqs[n] : (int)mtof(n);
+      }
+      harm_pitch_.Init();
+      inharm_pitch_.Init();
+    }
+
+    /*
+     * Main loop: work out a chunk of the note-on tables for the current tuning and timbre.
+     * Notes not in the tables yet are worked out at note-on. True while there's work left
+     */
+    bool ServicePitch(int budget = PITCH_CHUNK)
+    {
+      bool harm = harm_pitch_.Service(notes[0], freqs_, budget);
+      bool inharm = inharm_pitch_.Service(inharms[0], freqs_, budget);
+      return harm || inharm;
+    }
+
+    /*
+     * Harmonic note-ons play chord_shapes[shape] from the played note, 0 plays single notes.
+     * Each tone's pitch is the tuning's note shape.intervals[k] above, the detune
+     * ratios are worked out here once rather than at every note-on
+     */
+    void SetChord(int shape)
+    {
+      const chord_shape &c = chord_shapes[shape];
+      chord_tones_ = c.tones < CHORD_MAX_TONES ? c.tones : CHORD_MAX_TONES;
+      for (int k = 0; k < chord_tones_; k++) {
+	chord_intervals_[k] = c.intervals[k];
+	float cents = chord_tones_ > 1 ? c.detune * (2.0f * k / (chord_tones_ - 1) - 1) : 0;
+	chord_detune_[k] = powf(2, cents / 1200);
+      }
+    }
+
+    // How loud voices ring in sympathy with each other, 0 (off) to SYMP_MAX
+    void SetSympathetic(float amount)
+    {
+      amount = CLAMP(amount, 0.0f, SYMP_MAX);
+      if (symp_amount_ == 0 && amount > 0) {
+	// Nothing has been kept while it was off
+	memset(symp_out_, 0, sizeof(symp_out_));
+	symp_len_ = 0;
+      }
+      if (amount == 0) {
+	memset(symp_n_, 0, sizeof(symp_n_));
+      }
+      symp_amount_ = amount;
+      symp_dirty_ = true;
+    }
+
+    // Voice pairs coupled at the moment
+    int CoupledPairs()
+    {
+      int count = 0;
+      for (int i = 0; i < NUM_NOTES; i++) {
+	count += symp_n_[i];
+      }
+      return count;
+    }
+
+    /*
+     * MPE lower zone: channel 0 is the master, channels 1 to members each carry one note's
+     * bend, pressure and timbre. 0 plays everything from channel 0 the way it always has.
+     * Resets every channel's expression and bend range
+     */
+    void SetMpe(int members)
+    {
+      mpe_members_ = CLAMP(members, 0, MIDI_CHANNELS - 1);
+      for (int c = 0; c < MIDI_CHANNELS; c++) {
+	chan_bend_[c] = chan_press_[c] = chan_timbre_[c] = 0;
+	bend_range_[c] = (mpe_members_ > 0 && c > 0) ? MPE_BEND_RANGE_DEFAULT : BEND_RANGE_DEFAULT;
+	rpn_[c] = RPN_NULL;
+      }
+      expr_dirty_ = (1u << NUM_NOTES) - 1;
+    }
+
+    // channel is one of the MPE zone's member channels
+    bool MpeMember(int channel)
+    {
+      return mpe_members_ > 0 && channel > 0 && channel <= mpe_members_;
+    }
+
+    // value is -8192 to 8191. Channels outside the MPE zone are the master channel
+    void PitchBend(int16_t value, int channel = 0)
+    {
+      channel = MpeMember(channel) ? channel : 0;
+      chan_bend_[channel] = value / 8192.0f;
+      ChannelMoved(channel);
+    }
+
+    void ChannelPressure(uint8_t value, int channel = 0)
+    {
+      channel = MpeMember(channel) ? channel : 0;
+      chan_press_[channel] = value / 127.0f;
+      ChannelMoved(channel);
+    }
+
+    // Poly aftertouch, for the voices last given note on channel
+    void PolyPressure(uint8_t note, uint8_t value, int channel = 0)
+    {
+      int c = MpeMember(channel) ? channel : 0;
+      for (int i = 0; i < NUM_NOTES; i++) {
+	if (voice_note_[i] == note && voice_chan_[i] == c) {
+	  voice_press_[i] = value / 127.0f;
+	  expr_dirty_ |= 1u << i;
+	}
+      }
+    }
+
+    // 0 is mono, 1 the voices' own placement, up to WIDTH_MAX wider still
+    void SetWidth(float width)
+    {
+      width_ = width;
+    }
+
+    // How far apart the voices are panned, and how far each voice's modes spread from its pan, 0 to 1
+    void SetSpread(float voices, float modes)
+    {
+      pan_spread_ = voices;
+      mode_spread_ = modes;
+      UpdatePans();
+    }
+
+    // Play pings from cache, nullptr runs every voice live. cache is filled by calling its Service
+    void SetIrCache(ir_cache *cache)
+    {
+      for (int i = 0; i < NUM_NOTES; i++) {
+	if (ir_slot_[i] >= 0) IrToLive(i);
+      }
+      ir_cache_ = cache;
+    }
+
+    /*
+     * Transients for SAMPLE mode, nullptr for none. The bank's memory is read in the audio callback,
+     * so it has to stay put while attached
+     */
+    void SetExciters(const exciter_bank *bank)
+    {
+      for (int i = 0; i < NUM_NOTES; i++) {
+	exc_voices_[i].Stop();
+      }
+      exciters_ = bank;
+      exciter_ = 0;
+    }
+
+    // The transient new notes play, wrapping around the bank
+    void SetExciter(int i)
+    {
+      int n = exciters_ ? exciters_->Count() : 0;
+      exciter_ = n > 0 ? ((i % n) + n) % n : 0;
+    }
+
+    void NextExciter() { SetExciter(exciter_ + 1); }
+
+    int Exciter() { return exciter_; }
+
+    // Voices playing from the cache
+    int CachedVoices()
+    {
+      int count = 0;
+      for (int i = 0; i < NUM_NOTES; i++) {
+	count += ir_slot_[i] >= 0;
+      }
+      return count;
+    }
+
+#ifdef MODAL_DENORMAL_STATS
+    // Subnormal filter states after the last block, and the most seen in any block
+    int SubnormalStates() { return subnormal_states_; }
+    int MaxSubnormalStates() { return max_subnormal_states_; }
+#endif
+
+    // channel only matters with MPE, a member channel's expression follows the note
+    void NoteOn(uint8_t note, uint8_t velocity, int channel = 0)
+    {
+      // Keys the tuning leaves unmapped don't play
+      if (freqs_[note] <= 0) return;
+      midi_f = freqs_[note];
+      symp_dirty_ = true;
+      voice_chan_[next_note] = MpeMember(channel) ? channel : 0;
+      voice_note_[next_note] = note;
+      voice_press_[next_note] = 0;
+      voice_fc_[next_note] = midi_f;
+      expr_dirty_ |= 1u << next_note;
+      TRACE(TRACE_NOTE_ON, note, next_note);
+#ifdef MODAL_TRACE
+      if (fabsf(voice_level[next_note]) > TRACE_ACTIVE_THRESH) {
+        TRACE(TRACE_STEAL, note, next_note);
+      }
+#endif
+      // TODO: fix velocity
+      if (cur_mode == INHARM || cur_mode == INHARM_NOISE) {
+        midi_v = CC_TO_VAL(velocity, 0, 1);
+        inharms[next_note].modulate_g(midi_v);
+        if (!inharm_pitch_.Load(inharms[next_note], note, midi_f)) {
+          inharms[next_note].update_fc(midi_f);
+        }
+#ifdef MODAL_OLA
+        olas[next_note].modulate_g(midi_v);
+        olas[next_note].update_fc(midi_f);
+#endif
+        TRACE(TRACE_RECALC, TRACE_P_FC, next_note);
+      } else if (chord_tones_ > 1) {
+        midi_v = CC_TO_VAL(velocity, 0, params_.Get(PARAM_G));
+        UseChord(next_note, true);
+        float fc[CHORD_MAX_TONES];
+        const pitch_entry<NUM_HARM_PARTIALS> *pitch[CHORD_MAX_TONES];
+        uint32_t key[3];
+        chords[next_note].pitch_key(key);
+        for (int k = 0; k < chord_tones_; k++) {
+          // Tones off the keyboard or on unmapped keys are silent
+          int n = note + chord_intervals_[k];
+          bool on = n >= 0 && n < TUNING_NOTES;
+          fc[k] = on ? freqs_[n] * chord_detune_[k] : 0;
+          // Detuned tones aren't at the table's frequency and find nothing
+          pitch[k] = on ? harm_pitch_.Find(n, fc[k], key) : nullptr;
+        }
+        chords[next_note].update_g(midi_v);
+        chords[next_note].set_chord(fc, chord_tones_, pitch);
+        TRACE(TRACE_RECALC, TRACE_P_FC, next_note);
+      } else {
+        midi_v = CC_TO_VAL(velocity, 0, params_.Get(PARAM_G));
+        UseChord(next_note, false);
+        notes[next_note].update_g(midi_v);
+        if (!harm_pitch_.Load(notes[next_note], note, midi_f)) {
+          notes[next_note].update_fc(midi_f);
+        }
+        TRACE(TRACE_RECALC, TRACE_P_FC, next_note);
+      }
+      play_note = true;
+    }
+
+    // Member channels only take timbre and RPNs, everything else is for the master channel.
+    // Channels outside the MPE zone are the master channel
+    void ControlChange(uint8_t control_number, uint8_t value, int channel = 0)
+    {
+      TRACE(TRACE_CC, control_number, value);
+      channel = MpeMember(channel) ? channel : 0;
+      if (Rpn(control_number, value, channel)) return;
+      if (MpeMember(channel)) {
+	if (control_number == CC_TIMBRE) {
+	  chan_timbre_[channel] = (value - 64) / 64.0f;
+	  ChannelMoved(channel);
+	}
+	return;
+      }
+      if (ParamCC(control_number, value)) return;
+      symp_dirty_ = true;
+      switch(control_number)
+      {
+        case CC_MODE:
+          cur_mode = (ui_mode)floor(CC_TO_VAL(value, 0, (LAST_MODE - 0.1))); // - 0.1 to avoid hitting LAST_MODE
+          // The other kind of voice catches up with the expression
+          expr_dirty_ = (1u << NUM_NOTES) - 1;
+          break;
+        case CC_INHARM:
+          LoadPreset(floor(CC_TO_VAL(value, 0, NUM_INHARM_PRESETS)));
+          break;
+        case CC_PAN:
+          SetSpread(CC_TO_VAL(value, 0, 1), mode_spread_);
+          break;
+        case CC_SPREAD:
+          SetSpread(pan_spread_, CC_TO_VAL(value, 0, 1));
+          break;
+        case CC_WIDTH:
+          SetWidth(CC_TO_VAL(value, 0, WIDTH_MAX));
+          break;
+        case CC_CHORD:
+          SetChord(floor(CC_TO_VAL(value, 0, (NUM_CHORD_SHAPES - 0.1))));
+          break;
+        case CC_SYMP:
+          SetSympathetic(CC_TO_VAL(value, 0, SYMP_MAX));
+          break;
+        case CC_EXCITER:
+          SetExciter(value);
+          break;
+        default: break;
+      }
+    }
+
+    void LoadPreset(int preset)
+    {
+      cur_preset = preset;
+      symp_dirty_ = true;
+      TRACE(TRACE_PRESET, cur_preset);
+      for (int i = 0; i < NUM_NOTES; i++) {
+        inharms[i].load_preset(&inharm_presets[cur_preset]);
+#ifdef MODAL_OLA
+        olas[i].load_preset(&inharm_presets[cur_preset]);
+#endif
+      }
+    }
+
+    // Button 1
+    void NextPreset()
+    {
+      LoadPreset(cur_preset + 1 == NUM_INHARM_PRESETS ? 0 : cur_preset + 1);
+    }
+
+    // Button 2
+    void NextMode()
+    {
+      cur_mode = (ui_mode)(cur_mode + 1);
+      symp_dirty_ = true;
+      expr_dirty_ = (1u << NUM_NOTES) - 1;
+      if (cur_mode >= LAST_MODE) {
+        cur_mode = PING;
+      }
+    }
+
+    // Output stage for hosts without the GAIN_OUT page
+    void SetOutputMode(ui_output_mode mode)
+    {
+      cur_output_mode = mode;
+    }
+
+    ui_mode Mode() { return cur_mode; }
+
+    int Preset() { return cur_preset; }
+
+    bool Inharmonic() { return cur_mode == INHARM || cur_mode == INHARM_NOISE; }
+
+    /*
+     * Any thread: a parameter in its own units, heard from the next block.
+     * Setting it again before then only changes the value that block sees.
+     * Values are clamped to the range the pots and CCs give
+     */
+    void SetParam(param_id id, float val)
+    {
+      // In param_id order
+      static const float range[NUM_PARAMS][2] = {
+	{GAIN_MIN,	GAIN_MAX},		// PARAM_G
+	{NONE,		LAST_OUTPUT - 1},	// PARAM_OUT
+	{STIFF_MIN,	STIFF_MAX},
+	{BETA_MIN,	BETA_MAX},
+	{IFC_MIN,	IFC_MAX},
+	{MGF_MIN,	MGF_MAX},
+	{ENV_MIN,	ENV_MAX},		// PARAM_AT
+	{ENV_MIN,	ENV_MAX},		// PARAM_DT
+	{0,		1},			// PARAM_RES
+	{LFO_RATE_MIN,	LFO_RATE_MAX},		// PARAM_LFO_IFC_RATE
+	{LFO_DEPTH_MIN,	LFO_DEPTH_MAX},
+	{LFO_RATE_MIN,	LFO_RATE_MAX},
+	{LFO_DEPTH_MIN,	LFO_DEPTH_MAX},
+	{LFO_RATE_MIN,	LFO_RATE_MAX},
+	{LFO_DEPTH_MIN,	LFO_DEPTH_MAX},
+      };
+      if (id < 0 || id >= NUM_PARAMS) return;
+      // NaN ends up at the bottom of the range
+      val = fminf(range[id][1], fmaxf(range[id][0], val));
+      // Beta and the output stage are whole numbers
+      params_.Set(id, (id == PARAM_BETA || id == PARAM_OUT) ? roundf(val) : val);
+    }
+
+    float Param(param_id id) { return params_.Get(id); }
+
+    // Pot and MIDI pickup for the UI, which passes the values they give to SetParam
+    PagedParam ifc_p, g_p, inharm_g_p, stiff_p, beta_p, mgf_p, mrf_p, out_p, at_p, dt_p;
+    PagedParam lfo_ifc_rate_p, lfo_ifc_depth_p, lfo_stiff_rate_p, lfo_stiff_depth_p, lfo_beta_rate_p, lfo_beta_depth_p;
+
+#ifdef MODAL_TRACE
+    trace_ring<TRACE_RING_SIZE> tracer;
+#endif
+
+  private:
+    /*
+     * Excitation and voices for up to ENGINE_MAX_BLOCK samples, summed into mix
+     *
+     * Anything every voice sees identically is computed once for the block:
+     * in EXT mode the input is filtered once onto the bus and every voice reads it
+     * (bar MPE notes given a timbre of their own),
+     * noise for the noise modes is drawn for all voices up front.
+     * Only per-voice differences (pings, envelopes) are built per voice.
+     * side is null in mono, otherwise it receives the side bus
+     */
+    void ProcessVoices(const float *in, float *mix, float *side, size_t n)
+    {
+      bool inharm = Inharmonic();
+      bool ext = (cur_mode == EXT || cur_mode == EXT_ENV);
+      bool noise_env = (cur_mode == NOISE_ENV || cur_mode == INHARM_NOISE);
+      bool sampled = (cur_mode == SAMPLE && exciters_ && exciters_->Count() > 0);
+
+      for (size_t i = 0; i < n; i++) {
+	mix[i] = 0;
+      }
+      if (side) {
+	for (size_t i = 0; i < n; i++) {
+	  side[i] = 0;
+	}
+      }
+
+      // A new note starts on the first sample of the block
+      int ping = -1;
+      if (!ext && play_note) {
+	ping = next_note;
+	play_note = false;
+	TRACE(TRACE_PING, 0, ping);
+	NextVoice();
+	if (noise_env) {
+	  env[ping].Trigger();
+	}
+	if (sampled) {
+	  exc_voices_[ping].Start(*exciters_, exciter_, voice_fc_[ping], sr_);
+	}
+      }
+
+      if (ir_cache_) {
+	UpdateCached(ping, inharm);
+      }
+
+      if (symp_amount_ > 0 && symp_dirty_) {
+	UpdateCoupling(inharm);
+      }
+
+      if (noise_env) {
+	// Interleaved the same way the voices used to draw it sample by sample
+	for (size_t i = 0; i < n * NUM_NOTES; i++) {
+	  noise_bus_[i] = noise.Process();
+	}
+      }
+
+      if (cur_mode == EXT) {
+	ext_filt.ProcessBlock(in, bus_, n);
+      }
+
+      for (int j = 0; j < NUM_NOTES; j++) {
+	bool fading = fading_ & (1u << j);
+	if ((stolen_ & (1u << j)) && !fading) continue;
+	// A voice the governor has just stolen renders on its own and is faded into the mix
+	float *out = mix, *out_side = side;
+	if (fading) {
+	  out = fade_mix_;
+	  out_side = side ? fade_side_ : nullptr;
+	  for (size_t i = 0; i < n; i++) {
+	    fade_mix_[i] = fade_side_[i] = 0;
+	  }
+	}
+#ifdef MODAL_TRACE
+	float before = mix[n - 1];
+#endif
+	bool coupled = Coupled(j, inharm);
+	// A note whose timbre has moved its input filter away from ext_filt's filters the input itself
+	bool own_filt = cur_mode == EXT && ifc_scale_[j] != 1;
+	if (cur_mode == EXT && coupled) {
+	  AddCoupled(j, inharm, own_filt ? in : bus_, !own_filt, out, out_side, n);
+	} else if (own_filt) {
+	  if (chord_voice_[j]) {
+	    chords[j].AddBlock(in, out, out_side, n);
+	  } else {
+	    notes[j].AddBlock(in, out, out_side, n);
+	  }
+	} else if (cur_mode == EXT) {
+	  if (chord_voice_[j]) {
+	    chords[j].AddFilteredBlock(bus_, out, out_side, n);
+	  } else {
+	    notes[j].AddFilteredBlock(bus_, out, out_side, n);
+	  }
+	} else if (ir_slot_[j] >= 0) {
+	  AddCached(j, out, out_side, n);
+	} else {
+	  if (cur_mode == EXT_ENV) {
+	    for (size_t i = 0; i < n; i++) {
+	      exc_[i] = env[j].Process() * in[i];
+	    }
+	  } else if (noise_env) {
+	    for (size_t i = 0; i < n; i++) {
+	      exc_[i] = env[j].Process() * noise_bus_[i * NUM_NOTES + j];
+	    }
+	  } else if (sampled) {
+	    exc_voices_[j].Process(exc_kernel_, exc_, n);
+	  } else {
+	    for (size_t i = 0; i < n; i++) {
+	      exc_[i] = 0;
+	    }
+	    if (j == ping) {
+	      exc_[0] = PING_AMT;
+	    }
+	  }
+	  if (coupled) {
+	    AddCoupled(j, inharm, exc_, false, out, out_side, n);
+	  } else if (inharm) {
+#ifdef MODAL_OLA
+	    if (ola_voices_ & (1u << j)) {
+	      AddOla(j, out, out_side, n);
+	    } else
+#endif
+	    inharms[j].AddBlock(exc_, out, out_side, n);
+	  } else if (chord_voice_[j]) {
+	    chords[j].AddBlock(exc_, out, out_side, n);
+	  } else {
+	    notes[j].AddBlock(exc_, out, out_side, n);
+	  }
+	}
+	if (fading) {
+	  FadeStolen(j, mix, side, n);
+	}
+#ifdef MODAL_TRACE
+	voice_level[j] = mix[n - 1] - before;
+#endif
+      }
+
+      if (symp_amount_ > 0) {
+	symp_cur_ ^= 1;
+	symp_len_ = n;
+      }
+    }
+
+    // Round robin over the voices the governor has left
+    void NextVoice()
+    {
+      do {
+	if (++next_note == NUM_NOTES) {
+	  next_note = 0;
+	}
+      } while (stolen_ & (1u << next_note));
+    }
+
+    // Rungs of kind rung the governor has taken
+    int Cut(int rung)
+    {
+      return governed_ ? governor_.Taken(rung) : 0;
+    }
+
+    // The user's settings less whatever the governor's level gives up
+    void ApplyGovernor()
+    {
+      bool precision = precision_ && Cut(GOV_PRECISION) == 0;
+      int modes = Cut(GOV_MODES);
+      int harm = NUM_HARM_PARTIALS >> modes, inharm = NUM_INHARM_PARTIALS >> modes;
+      harm = harm < 1 ? 1 : (harm < mode_budget_ ? harm : mode_budget_);
+      inharm = inharm < 1 ? 1 : inharm;
+      for (int i = 0; i < NUM_NOTES; i++) {
+	notes[i].set_precision(precision);
+	inharms[i].set_precision(precision);
+	notes[i].set_mode_budget(harm);
+	inharms[i].set_mode_budget(inharm);
+      }
+      control_div_ = 1 << Cut(GOV_CONTROL);
+      StealVoices(Cut(GOV_VOICES));
+    }
+
+    /*
+     * Leave k voices out, at least one always plays. New ones are taken oldest first,
+     * starting at the voice the next note would have reused, and fade out over
+     * STEAL_FADE_SAMPLES before they're stopped. A voice with a note-on waiting for this
+     * block is kept, one still fading out is only given back once it has stopped
+     */
+    void StealVoices(int k)
+    {
+      k = k < NUM_NOTES - 1 ? k : NUM_NOTES - 1;
+      int have = NUM_NOTES - LiveVoices();
+      if (have == k) return;
+      for (int v = next_note + (play_note ? 1 : 0); have < k; v++) {
+	int j = v % NUM_NOTES;
+	if (stolen_ & (1u << j) || (play_note && j == next_note)) continue;
+	stolen_ |= 1u << j;
+	fading_ |= 1u << j;
+	fade_left_[j] = STEAL_FADE_SAMPLES;
+	have++;
+      }
+      for (int j = 0; j < NUM_NOTES && have > k; j++) {
+	if ((stolen_ & ~fading_) & (1u << j)) {
+	  stolen_ &= ~(1u << j);
+	  have--;
+	}
+      }
+      if (stolen_ & (1u << next_note)) {
+	NextVoice();
+      }
+      symp_dirty_ = true;
+    }
+
+    // Add stolen voice j's block, rendered into fade_mix_ and fade_side_, on its way out
+    void FadeStolen(int j, float *mix, float *side, size_t n)
+    {
+      for (size_t i = 0; i < n; i++) {
+	float w = (float)fade_left_[j] / STEAL_FADE_SAMPLES;
+	mix[i] += fade_mix_[i] * w;
+	if (side) side[i] += fade_side_[i] * w;
+	if (fade_left_[j] > 0) fade_left_[j]--;
+      }
+      if (fade_left_[j] == 0) {
+	StopVoice(j);
+	fading_ &= ~(1u << j);
+	// The governor may have given it back while it faded
+	StealVoices(Cut(GOV_VOICES));
+      }
+    }
+
+    void StopVoice(int voice)
+    {
+      if (ir_slot_[voice] >= 0) {
+	ir_cache_->Release(ir_slot_[voice]);
+	ir_slot_[voice] = -1;
+      }
+      exc_voices_[voice].Stop();
+      notes[voice].clear();
+      chords[voice].clear();
+      inharms[voice].clear();
+#ifdef MODAL_OLA
+      olas[voice].clear();
+#endif
+    }
+
+    // Voices listening to channel have moved, the master channel moves them all
+    void ChannelMoved(int channel)
+    {
+      if (!MpeMember(channel)) {
+	expr_dirty_ = (1u << NUM_NOTES) - 1;
+	return;
+      }
+      for (int i = 0; i < NUM_NOTES; i++) {
+	if (voice_chan_[i] == channel) expr_dirty_ |= 1u << i;
+      }
+    }
+
+    // CCs for params_ are only noted here, true if control_number was one
+    bool ParamCC(uint8_t control_number, uint8_t value)
+    {
+      switch(control_number)
+      {
+        case CC_MOD:
+          SetParam(PARAM_RES, CC_TO_VAL(value, 0, 1));
+          return true;
+        case CC_GAIN:
+          // inharmonic gain is really a modulation factor between 0 and 1
+          SetParam(PARAM_G, Inharmonic() ? inharm_g_p.MidiCCIn(value) : g_p.MidiCCIn(value));
+          return true;
+        case CC_STIFF:
+          SetParam(PARAM_STIFF, stiff_p.MidiCCIn(value));
+          return true;
+        case CC_BETA:
+          SetParam(PARAM_BETA, beta_p.MidiCCIn(value));
+          return true;
+        case CC_MGF:
+          SetParam(PARAM_MGF, mgf_p.MidiCCIn(value));
+          return true;
+        case CC_REL:
+          SetParam(PARAM_DT, dt_p.MidiCCIn(value));
+          return true;
+        case CC_ATK:
+          SetParam(PARAM_AT, at_p.MidiCCIn(value));
+          return true;
+        case CC_IFC:
+          SetParam(PARAM_IFC, ifc_p.MidiCCIn(value));
+          return true;
+        case CC_LFO_IFC_R:
+          SetParam(PARAM_LFO_IFC_RATE, lfo_ifc_rate_p.MidiCCIn(value));
+          return true;
+        case CC_LFO_IFC_D:
+          SetParam(PARAM_LFO_IFC_DEPTH, lfo_ifc_depth_p.MidiCCIn(value));
+          return true;
+        case CC_LFO_STIFF_R:
+          SetParam(PARAM_LFO_STIFF_RATE, lfo_stiff_rate_p.MidiCCIn(value));
+          return true;
+        case CC_LFO_STIFF_D:
+          SetParam(PARAM_LFO_STIFF_DEPTH, lfo_stiff_depth_p.MidiCCIn(value));
+          return true;
+        case CC_LFO_BETA_R:
+          SetParam(PARAM_LFO_BETA_RATE, lfo_beta_rate_p.MidiCCIn(value));
+          return true;
+        case CC_LFO_BETA_D:
+          SetParam(PARAM_LFO_BETA_DEPTH, lfo_beta_depth_p.MidiCCIn(value));
+          return true;
+        default:
+          return false;
+      }
+    }
+
+    /*
+     * Registered parameters: bend range, and on channel 0 the MPE Configuration Message.
+     * A member channel's bend range goes for every member. True if the CC was part of one
+     */
+    bool Rpn(uint8_t control_number, uint8_t value, int channel)
+    {
+      if (control_number == CC_RPN_MSB) {
+	rpn_[channel] = (value << 7) | (rpn_[channel] & 0x7f);
+	return true;
+      }
+      if (control_number == CC_RPN_LSB) {
+	rpn_[channel] = (rpn_[channel] & (0x7f << 7)) | value;
+	return true;
+      }
+      if (control_number != CC_DATA || rpn_[channel] == RPN_NULL) return control_number == CC_DATA;
+      if (rpn_[channel] == RPN_BEND_RANGE) {
+	if (MpeMember(channel)) {
+	  for (int c = 1; c <= mpe_members_; c++) bend_range_[c] = value;
+	} else {
+	  bend_range_[channel] = value;
+	}
+	expr_dirty_ = (1u << NUM_NOTES) - 1;
+      } else if (rpn_[channel] == RPN_MPE && channel == 0) {
+	SetMpe(value);
+      }
+      return true;
+    }
+
+    // Voice v's bend in semitones, pressure 0 to 1 and timbre -1 to 1 from its note's channel and the master
+    float VoiceBend(int v)
+    {
+      int c = voice_chan_[v];
+      float bend = chan_bend_[0] * bend_range_[0];
+      return c ? bend + chan_bend_[c] * bend_range_[c] : bend;
+    }
+
+    float VoicePressure(int v)
+    {
+      float press = fmaxf(chan_press_[0], voice_press_[v]);
+      return fmaxf(press, chan_press_[voice_chan_[v]]);
+    }
+
+    float VoiceIfc(int v, float ifc)
+    {
+      return ifc_scale_[v] == 1 ? ifc : CLAMP(ifc * ifc_scale_[v], IFC_MIN, IFC_MAX);
+    }
+
+    /*
+     * Control rate: each voice whose expression has moved since the last block is updated once,
+     * only the kind of voice playing at the moment. Bend and pressure change pitch and radii,
+     * so the couplings are worked out again
+     */
+    void UpdateExpression()
+    {
+      if (!expr_dirty_) return;
+      bool inharm = Inharmonic();
+      for (int i = 0; i < NUM_NOTES; i++) {
+	if (!(expr_dirty_ & (1u << i))) continue;
+	float bend = VoiceBend(i);
+	float ratio = bend == 0 ? 1 : powf(2, bend / 12);
+	float press = VoicePressure(i);
+	float timbre = chan_timbre_[voice_chan_[i]];
+	float scale = timbre == 0 ? 1 : powf(2, TIMBRE_OCTAVES * timbre);
+	// The input filters are only touched when the timbre moves
+	bool timbre_moved = scale != ifc_scale_[i];
+	ifc_scale_[i] = scale;
+	float ifc = VoiceIfc(i, cur_ifc);
+	if (inharm) {
+	  inharms[i].bend(ratio);
+	  inharms[i].press(press);
+	  if (timbre_moved) inharms[i].update_ifc(ifc);
+#ifdef MODAL_OLA
+	  olas[i].update_fc(voice_fc_[i] * ratio);
+	  if (timbre_moved) olas[i].update_ifc(ifc);
+#endif
+	} else if (chord_voice_[i]) {
+	  chords[i].bend(ratio);
+	  chords[i].press(press);
+	  if (timbre_moved) chords[i].update_ifc(ifc);
+	} else {
+	  notes[i].bend(ratio);
+	  notes[i].press(press);
+	  if (timbre_moved) notes[i].update_ifc(ifc);
+	}
+	TRACE(TRACE_RECALC, TRACE_P_FC, i);
+      }
+      expr_dirty_ = 0;
+      symp_dirty_ = true;
+    }
+
+    // Voice takes part in sympathetic resonance
+    bool Coupled(int voice, bool inharm)
+    {
+      if (symp_amount_ == 0 || (stolen_ & (1u << voice))) return false;
+#ifdef MODAL_OLA
+      if (inharm && (ola_voices_ & (1u << voice))) return false;
+#endif
+      return true;
+    }
+
+    int Resonances(int voice, bool inharm, float *fc, float *r, float *peak)
+    {
+      if (inharm) return inharms[voice].resonances(fc, r, peak);
+      if (chord_voice_[voice]) return chords[voice].resonances(fc, r, peak);
+      return notes[voice].resonances(fc, r, peak);
+    }
+
+    /*
+     * Which voices feed which, and how much. A pair couples through its closest two modes:
+     * the weight falls from 1 for the same frequency to 0 at SYMP_WIDTH bandwidths apart,
+     * and is divided by the receiving mode's gain at resonance so the receiver rings at
+     * symp_amount_ times the sender's level. A voice's weights are scaled down to sum to at most 1
+     * so the feedback around any loop stays below symp_amount_
+     */
+    void UpdateCoupling(bool inharm)
+    {
+      float fc[NUM_NOTES][SYMP_MODES], r[NUM_NOTES][SYMP_MODES], peak[NUM_NOTES][SYMP_MODES];
+      int n_modes[NUM_NOTES];
+      for (int v = 0; v < NUM_NOTES; v++) {
+	n_modes[v] = Coupled(v, inharm) ? Resonances(v, inharm, fc[v], r[v], peak[v]) : 0;
+      }
+      // A resonator's bandwidth is about (1 - r) * fs / pi
+      float to_width = SYMP_WIDTH * sr_ / PI;
+      for (int b = 0; b < NUM_NOTES; b++) {
+	float total = 0;
+	symp_n_[b] = 0;
+	for (int a = 0; a < NUM_NOTES; a++) {
+	  if (a == b) continue;
+	  float best = 0, best_peak = 0;
+	  for (int i = 0; i < n_modes[a]; i++) {
+	    for (int j = 0; j < n_modes[b]; j++) {
+	      float width = to_width * ((1 - r[a][i]) + (1 - r[b][j]));
+	      float dist = fabsf(fc[a][i] - fc[b][j]);
+	      if (dist >= width) continue;
+	      float w = 1 - dist / width;
+	      if (w > best) {
+		best = w;
+		best_peak = peak[b][j];
+	      }
+	    }
+	  }
+	  if (best == 0 || best_peak == 0) continue;
+	  symp_src_[b][symp_n_[b]] = a;
+	  symp_gain_[b][symp_n_[b]] = best / best_peak;
+	  symp_n_[b]++;
+	  total += best;
+	}
+	float norm = symp_amount_ / (total > 1 ? total : 1);
+	for (int p = 0; p < symp_n_[b]; p++) {
+	  symp_gain_[b][p] *= norm;
+	}
+      }
+      symp_dirty_ = false;
+    }
+
+    /*
+     * A coupled voice: in, through the voice's input filter unless already filtered,
+     * plus last block's output of the voices feeding it. Its own output is kept for the next block
+     */
+    void AddCoupled(int voice, bool inharm, const float *in, bool filtered, float *mix, float *side, size_t n)
+    {
+      if (filtered) {
+	memcpy(filt_, in, n * sizeof(float));
+      } else if (inharm) {
+	inharms[voice].FilterBlock(in, filt_, n);
+      } else if (chord_voice_[voice]) {
+	chords[voice].FilterBlock(in, filt_, n);
+      } else {
+	notes[voice].FilterBlock(in, filt_, n);
+      }
+
+      size_t len = symp_len_ < n ? symp_len_ : n;
+      for (int p = 0; p < symp_n_[voice]; p++) {
+	const float *from = symp_out_[symp_cur_ ^ 1][symp_src_[voice][p]];
+	float g = symp_gain_[voice][p];
+	for (size_t i = 0; i < len; i++) {
+	  filt_[i] += g * from[i];
+	}
+      }
+
+      float *out = symp_out_[symp_cur_][voice];
+      for (size_t i = 0; i < n; i++) {
+	out[i] = 0;
+      }
+      if (inharm) {
+	inharms[voice].AddFilteredBlock(filt_, out, side, n);
+      } else if (chord_voice_[voice]) {
+	chords[voice].AddFilteredBlock(filt_, out, side, n);
+      } else {
+	notes[voice].AddFilteredBlock(filt_, out, side, n);
+      }
+      for (size_t i = 0; i < n; i++) {
+	mix[i] += out[i];
+      }
+    }
+
+    // Voice v's pan, the voices spread evenly so consecutive notes move across
+    float VoicePan(int voice)
+    {
+      return pan_spread_ * (2.0f * voice / (NUM_NOTES - 1) - 1);
+    }
+
+    void UpdatePans()
+    {
+      for (int i = 0; i < NUM_NOTES; i++) {
+	notes[i].set_pan(VoicePan(i), mode_spread_);
+	chords[i].set_pan(VoicePan(i), mode_spread_);
+	inharms[i].set_pan(VoicePan(i), mode_spread_);
+      }
+    }
+
+    /*
+     * Voice plays chords or single notes from now on, the other kind is stopped.
+     * A cached single note is dropped rather than handed back
+     */
+    void UseChord(int voice, bool chord)
+    {
+      if (chord == chord_voice_[voice]) return;
+      if (chord) {
+	if (ir_slot_[voice] >= 0) {
+	  ir_cache_->Release(ir_slot_[voice]);
+	  ir_slot_[voice] = -1;
+	}
+	notes[voice].clear();
+      } else {
+	chords[voice].clear();
+      }
+      chord_voice_[voice] = chord;
+    }
+
+#ifdef MODAL_OLA
+    // The frequency domain voices are placed as a whole
+    void AddOla(int voice, float *mix, float *side, size_t n)
+    {
+      if (!side) {
+	olas[voice].AddBlock(exc_, mix, n);
+	return;
+      }
+      for (size_t i = 0; i < n; i++) {
+	voice_[i] = 0;
+      }
+      olas[voice].AddBlock(exc_, voice_, n);
+      float pan = VoicePan(voice);
+      for (size_t i = 0; i < n; i++) {
+	mix[i] += voice_[i];
+	side[i] += pan * voice_[i];
+      }
+    }
+#endif
+
+    /*
+     * Voices with culling, multirate or modes above float precision, chords, and OLA voices,
+     * don't match their cached responses.
+     * Responses are mono, in stereo they only stand for voices whose modes aren't spread.
+     * Coupled voices hear each other, which a response doesn't
+     */
+    bool Cacheable(int voice, bool inharm)
+    {
+      if (width_ != 0 && mode_spread_ != 0) return false;
+      if (symp_amount_ > 0) return false;
+      if (!inharm) return !chord_voice_[voice] && notes[voice].plain();
+#ifdef MODAL_OLA
+      if (ola_voices_ & (1u << voice)) return false;
+#endif
+      return inharms[voice].plain();
+    }
+
+    // The voice's key and gain, 0 if it can't be cached
+    float SaveCoefs(int voice, bool inharm, ir_key &key)
+    {
+      if (!Cacheable(voice, inharm)) return 0;
+      return inharm ? inharms[voice].save_coefs(key) : notes[voice].save_coefs(key);
+    }
+
+    /*
+     * Hand cached voices back to their resonators when they have to run live,
+     * then look up this block's ping
+     */
+    void UpdateCached(int ping, bool inharm)
+    {
+      bool pinged_mode = (cur_mode == PING || cur_mode == INHARM);
+      for (int j = 0; j < NUM_NOTES; j++) {
+	if (ir_slot_[j] < 0) continue;
+	bool live = j == ping || !pinged_mode || inharm != ir_inharm_[j];
+	if (!live) {
+	  // Parameters have moved
+	  float ref = SaveCoefs(j, inharm, ir_key_);
+	  live = ref != ir_ref_[j] || !(ir_key_ == ir_cache_->Key(ir_slot_[j]));
+	}
+	if (live) {
+	  IrToLive(j);
+	}
+      }
+
+      if (ping < 0 || !pinged_mode) return;
+      bool rest = inharm ? inharms[ping].at_rest(IR_CACHE_REST) : notes[ping].at_rest(IR_CACHE_REST);
+      if (!rest) return;
+      float ref = SaveCoefs(ping, inharm, ir_key_);
+      if (ref == 0) return;
+      int s = ir_cache_->Find(ir_key_);
+      if (s < 0) return;
+      ir_slot_[ping] = s;
+      ir_pos_[ping] = 0;
+      ir_ref_[ping] = ref;
+      ir_inharm_[ping] = inharm;
+    }
+
+    void AddCached(int voice, float *mix, float *side, size_t n)
+    {
+      int s = ir_slot_[voice];
+      const float *ir = ir_cache_->Samples(s);
+      uint32_t pos = ir_pos_[voice];
+      uint32_t len = ir_cache_->Length(s);
+      float scale = PING_AMT * ir_ref_[voice];
+      size_t k = len - pos < n ? len - pos : n;
+      for (size_t i = 0; i < k; i++) {
+	mix[i] += scale * ir[pos + i];
+      }
+      if (side) {
+	float pan = scale * VoicePan(voice);
+	for (size_t i = 0; i < k; i++) {
+	  side[i] += pan * ir[pos + i];
+	}
+      }
+      ir_pos_[voice] = pos + k;
+      if (pos + k == len) {
+	// The rest of the tail is below the cache's floor, let the voice finish it
+	IrToLive(voice);
+	if (k < n) {
+	  for (size_t i = 0; i < n - k; i++) {
+	    exc_[i] = 0;
+	  }
+	  float *side_k = side ? side + k : nullptr;
+	  if (ir_inharm_[voice]) {
+	    inharms[voice].AddBlock(exc_, mix + k, side_k, n - k);
+	  } else {
+	    notes[voice].AddBlock(exc_, mix + k, side_k, n - k);
+	  }
+	}
+      }
+    }
+
+    // The voice's resonators take over from where its cached response has got to
+    void IrToLive(int voice)
+    {
+      int s = ir_slot_[voice];
+      float state[IR_CACHE_STATE];
+      ir_cache_->StateAt(s, ir_pos_[voice], state);
+      int n = ir_cache_->Modes(s);
+      float out_scale = PING_AMT * ir_ref_[voice];
+      if (ir_inharm_[voice]) {
+	inharms[voice].load_state(state, n, PING_AMT, out_scale);
+      } else {
+	notes[voice].load_state(state, n, PING_AMT, out_scale);
+      }
+      ir_cache_->Release(s);
+      ir_slot_[voice] = -1;
+    }
+
+    /*
+     * Once per block, the parameters set since the last block and the LFOs.
+     * Only what has moved is worked out again, once however many times it was set
+     */
+    void UpdateParams()
+    {
+      uint32_t dirty = params_.Take() | param_carry_;
+      param_carry_ = 0;
+
+      // The LFOs are read every control_div_ blocks, in between the voices they modulate stay put
+      if (++control_block_ >= control_div_) {
+	control_block_ = 0;
+	for (int i = 0; i < NUM_LFOS; i++) {
+	  lfo_held_[i] = lfos[i].GetOutput();
+	}
+      }
+
+      if (dirty & PARAM_BIT(PARAM_LFO_IFC_RATE)) {
+        lfos[LFO_IFC].SetFreq(params_.Get(PARAM_LFO_IFC_RATE));
+      }
+      if (dirty & PARAM_BIT(PARAM_LFO_IFC_DEPTH)) {
+        lfos[LFO_IFC].SetDepth(params_.Get(PARAM_LFO_IFC_DEPTH));
+      }
+      float new_ifc = params_.Get(PARAM_IFC);
+      float lfo_new_ifc = CLAMP(new_ifc + lfo_held_[LFO_IFC], IFC_MIN, IFC_MAX);
+
+      if (dirty & PARAM_BIT(PARAM_LFO_STIFF_RATE)) {
+        lfos[LFO_STIFF].SetFreq(params_.Get(PARAM_LFO_STIFF_RATE));
+      }
+      if (dirty & PARAM_BIT(PARAM_LFO_STIFF_DEPTH)) {
+        lfos[LFO_STIFF].SetDepth(params_.Get(PARAM_LFO_STIFF_DEPTH));
+      }
+      float new_stiff = params_.Get(PARAM_STIFF);
+      float lfo_new_stiff = CLAMP(new_stiff + lfo_held_[LFO_STIFF], STIFF_MIN, STIFF_MAX);
+
+      if (dirty & PARAM_BIT(PARAM_LFO_BETA_RATE)) {
+        lfos[LFO_BETA].SetFreq(params_.Get(PARAM_LFO_BETA_RATE));
+      }
+      if (dirty & PARAM_BIT(PARAM_LFO_BETA_DEPTH)) {
+        lfos[LFO_BETA].SetDepth(params_.Get(PARAM_LFO_BETA_DEPTH));
+      }
+      float new_beta = params_.Get(PARAM_BETA);
+      float lfo_new_beta = CLAMP(new_beta + lfo_held_[LFO_BETA], BETA_MIN, BETA_MAX);
+
+      bool g_moved = dirty & PARAM_BIT(PARAM_G);
+      bool mgf_moved = dirty & PARAM_BIT(PARAM_MGF);
+      bool res_moved = dirty & PARAM_BIT(PARAM_RES);
+      bool stiff_moved = lfo_new_stiff != cur_stiff;
+      bool beta_moved = lfo_new_beta != cur_beta;
+      bool ifc_moved = lfo_new_ifc != cur_ifc;
+      float g = params_.Get(PARAM_G);
+
+      if (g_moved || mgf_moved || res_moved || stiff_moved || beta_moved) {
+	// Mode frequencies or gains move
+	symp_dirty_ = true;
+      }
+
+      if (dirty & PARAM_BIT(PARAM_OUT)) {
+        cur_output_mode = (ui_output_mode)params_.Get(PARAM_OUT);
+      }
+
+      uint32_t env_bits = dirty & (PARAM_BIT(PARAM_AT) | PARAM_BIT(PARAM_DT));
+      if (env_bits) {
+	for (int i = 0; i < NUM_NOTES; i++) {
+	  // A running envelope keeps its times until it has finished
+	  if (env[i].IsRunning()) {
+	    param_carry_ |= env_bits;
+	    continue;
+	  }
+	  if (env_bits & PARAM_BIT(PARAM_AT)) {
+	    env[i].SetTime(ADSR_SEG_ATTACK, params_.Get(PARAM_AT));
+	  }
+	  if (env_bits & PARAM_BIT(PARAM_DT)) {
+	    env[i].SetTime(ADSR_SEG_DECAY, params_.Get(PARAM_DT));
+	  }
+	}
+      }
+
+      if (Inharmonic()) {
+	if (res_moved) {
+	  float amt = -1 + params_.Get(PARAM_RES) * 2;
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    inharms[i].modulate_r(amt);
+#ifdef MODAL_OLA
+	    olas[i].modulate_r(amt);
+#endif
+	    TRACE(TRACE_RECALC, TRACE_P_R, i);
+	  }
+	}
+	if (g_moved) {
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    inharms[i].modulate_g(g);
+#ifdef MODAL_OLA
+	    olas[i].modulate_g(g);
+#endif
+	    TRACE(TRACE_RECALC, TRACE_P_G, i);
+	  }
+	}
+	if (ifc_moved) {
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    inharms[i].update_ifc(VoiceIfc(i, lfo_new_ifc));
+#ifdef MODAL_OLA
+	    olas[i].update_ifc(VoiceIfc(i, lfo_new_ifc));
+#endif
+	    TRACE(TRACE_RECALC, TRACE_P_IFC, i);
+	  }
+	}
+      } else {
+	if (res_moved) {
+	  float r = RES_MIN + params_.Get(PARAM_RES) * (RES_MAX - RES_MIN);
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    notes[i].update_r(r);
+	    chords[i].update_r(r);
+	    TRACE(TRACE_RECALC, TRACE_P_R, i);
+	  }
+	}
+	if (g_moved) {
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    notes[i].update_g(g);
+	    chords[i].update_g(g);
+	    TRACE(TRACE_RECALC, TRACE_P_G, i);
+	  }
+	}
+	if (stiff_moved) {
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    notes[i].update_stiffness(lfo_new_stiff);
+	    chords[i].update_stiffness(lfo_new_stiff);
+	    TRACE(TRACE_RECALC, TRACE_P_STIFF, i);
+	  }
+	}
+	if (beta_moved) {
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    notes[i].update_beta(lfo_new_beta);
+	    chords[i].update_beta(lfo_new_beta);
+	    TRACE(TRACE_RECALC, TRACE_P_BETA, i);
+	  }
+	}
+	if (mgf_moved) {
+	  float mgf = params_.Get(PARAM_MGF);
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    notes[i].update_mgf(mgf);
+	    chords[i].update_mgf(mgf);
+	    TRACE(TRACE_RECALC, TRACE_P_MGF, i);
+	  }
+	}
+	if (ifc_moved) {
+	  for (int i = 0; i < NUM_NOTES; i++) {
+	    notes[i].update_ifc(VoiceIfc(i, lfo_new_ifc));
+	    chords[i].update_ifc(VoiceIfc(i, lfo_new_ifc));
+	    TRACE(TRACE_RECALC, TRACE_P_IFC, i);
+	  }
+	}
+      }
+      if (ifc_moved) {
+	ext_filt.update_fc(lfo_new_ifc);
+      }
+      cur_beta = lfo_new_beta;
+      cur_ifc = lfo_new_ifc;
+      cur_stiff = lfo_new_stiff;
+    }
+
+    // Every voice is sized at compile time, the engine never allocates
+    modal_note<NUM_HARM_PARTIALS> notes[NUM_NOTES];
+    modal_inharm<NUM_INHARM_PARTIALS> inharms[NUM_NOTES];
+    modal_chord<NUM_HARM_PARTIALS, CHORD_MAX_TONES> chords[NUM_NOTES];
+    // Which of notes or chords each voice plays
+    bool chord_voice_[NUM_NOTES];
+#ifdef MODAL_OLA
+    modal_ola<NUM_INHARM_PARTIALS> olas[NUM_NOTES];
+    uint32_t ola_voices_ = 0;
+#endif
+
+    // Note-on coefficients, see ServicePitch
+    float freqs_[TUNING_NOTES];
+    pitch_table<NUM_HARM_PARTIALS> harm_pitch_;
+    pitch_table<NUM_INHARM_PARTIALS> inharm_pitch_;
+
+    AdEnv env[NUM_NOTES];
+    crc_noise noise;
+
+    // Shared excitation for EXT mode, the voices' own input filters are bypassed
+    iir_1p_lp ext_filt;
+
+    // SAMPLE mode: the bank, the transient new notes play and each voice's playhead
+    const exciter_bank *exciters_ = nullptr;
+    int exciter_ = 0;
+    exciter_kernel exc_kernel_;
+    exciter_voice exc_voices_[NUM_NOTES];
+
+    // Voices playing from the cache: slot or -1, samples played, gain, which kind of voice
+    ir_cache *ir_cache_ = nullptr;
+    int ir_slot_[NUM_NOTES];
+    uint32_t ir_pos_[NUM_NOTES] = {};
+    float ir_ref_[NUM_NOTES] = {};
+    bool ir_inharm_[NUM_NOTES] = {};
+    ir_key ir_key_;
+
+    // The chord shape, see SetChord. 1 tone plays single notes
+    int chord_tones_;
+    int chord_intervals_[CHORD_MAX_TONES];
+    float chord_detune_[CHORD_MAX_TONES];
+
+    float width_, pan_spread_, mode_spread_;
+
+    // Sympathetic resonance: for each voice, the voices feeding it and their gains,
+    // and every voice's output for this block and the last, see UpdateCoupling
+    float sr_;
+    float symp_amount_ = 0;
+    bool symp_dirty_ = true;
+    int symp_n_[NUM_NOTES] = {};
+    int symp_src_[NUM_NOTES][NUM_NOTES - 1];
+    float symp_gain_[NUM_NOTES][NUM_NOTES - 1];
+    float symp_out_[2][NUM_NOTES][ENGINE_MAX_BLOCK];
+    int symp_cur_ = 0;
+    size_t symp_len_ = 0;
+
+    float mix_[ENGINE_MAX_BLOCK];
+    float side_[ENGINE_MAX_BLOCK];
+#ifdef MODAL_OLA
+    float voice_[ENGINE_MAX_BLOCK];
+#endif
+    float bus_[ENGINE_MAX_BLOCK];
+    float filt_[ENGINE_MAX_BLOCK];
+    float exc_[ENGINE_MAX_BLOCK];
+    float noise_bus_[ENGINE_MAX_BLOCK * NUM_NOTES];
+
+    tri_lfo lfos[NUM_LFOS];
+    float lfo_held_[NUM_LFOS];
+
+    // The governor and what it has given up: LFO reads every control_div_ blocks, stolen_ voices.
+    // precision_ and mode_budget_ are the user's own settings
+    cpu_governor governor_;
+    bool governed_ = false;
+    bool precision_ = false;
+    int mode_budget_ = NUM_HARM_PARTIALS;
+    int control_div_ = 1, control_block_ = 0;
+    uint32_t stolen_ = 0;
+    // Stolen voices still fading out, with samples left to go
+    uint32_t fading_ = 0;
+    int fade_left_[NUM_NOTES];
+    float fade_mix_[ENGINE_MAX_BLOCK];
+    float fade_side_[ENGINE_MAX_BLOCK];
+
+#ifdef MODAL_TRACE
+    float voice_level[NUM_NOTES] = {};
+#endif
+#ifdef MODAL_DENORMAL_STATS
+    int subnormal_states_ = 0;
+    int max_subnormal_states_ = 0;
+#endif
+
+    param_store params_;
+    // Bits put back for the next block, see UpdateParams
+    uint32_t param_carry_ = 0;
+    // What the voices were last given, LFOs included, so a held LFO moves nothing
+    float cur_beta, cur_ifc, cur_stiff;
+
+    // Expression, see UpdateExpression. Per channel: bend -1 to 1, pressure, timbre, bend range and RPN selected.
+    // Per voice: the channel and note it was last given, poly pressure, unbent pitch, input filter scale
+    int mpe_members_ = 0;
+    float chan_bend_[MIDI_CHANNELS], chan_press_[MIDI_CHANNELS], chan_timbre_[MIDI_CHANNELS];
+    int bend_range_[MIDI_CHANNELS];
+    uint16_t rpn_[MIDI_CHANNELS];
+    int voice_chan_[NUM_NOTES], voice_note_[NUM_NOTES];
+    float voice_press_[NUM_NOTES], voice_fc_[NUM_NOTES], ifc_scale_[NUM_NOTES];
+    uint32_t expr_dirty_ = 0;
+
+    float midi_f = 0;
+    float midi_v = 0;
+    int next_note = 0;
+    bool play_note = false;
+
+    ui_mode cur_mode = PING;
+    ui_output_mode cur_output_mode = NONE;
+    int cur_preset = 0;
+};
+} // namespace daisysp
+#endif
+#endif
@@ -8,10 +8,21 @@
 #define GAIN_MAX  10.0f
 
 #include <stdint.h>
+#include <stddef.h>
+#include <array>
 #include "arm_math.h"
 #include "iir_reson.h"
 #include "iir_1p_lp.h"
-#include "inharm_presets.h"
+#include "denormal.h"
+#include "ir_cache.h"
+#include "modal_voice.h"
+#include "tuning.h"
+#ifdef MODAL_CMSIS_BIQUAD
+#include "reson_bank_cmsis.h"
+#endif
+#include "mode_set.h"
+#include "mode_cull.h"
+#include "reson_precision.h"
 #ifdef __cplusplus
 
 namespace daisysp
@@ -21,31 +32,53 @@ namespace daisysp
  * Specify the fundamental frequency and the mode multiples, 
  * gain and resonance factors 
  *
+ * N is the most modes the voice can hold, presets with more are truncated
+ * Modes come from an inharm_preset or any mode_set
+ *
  *   Jared Anderson June 2021
  */
-class modal_inharm
+template <int N>
+class modal_inharm : public modal_voice<modal_inharm<N>, N>
 {
+    friend class modal_voice<modal_inharm<N>, N>;
+
   public:
-    modal_inharm(int n) :n_modes_{n}, modes{new iir_reson[n]} {}
-    ~modal_inharm() { delete[] modes; }
+    modal_inharm()
+    {
+      for (int i = 0; i < N; i++) {
+	modes[i].attach(&hot_[i]);
+      }
+      hot_.fill(reson_hot());
+      side_.fill(0);
+    }
+    // The resonators point into hot_
+    modal_inharm(const modal_inharm &) = delete;
+    modal_inharm &operator=(const modal_inharm &) = delete;
 
     void init(float fs, float fc, inharm_preset *preset)
+    {
+      init(fs, fc, preset_modes(preset));
+    }
+
+    void init(float fs, float fc, const mode_set &set)
     {
       fs_ = fs;
       fc_ = fc;
       mgf_ = DEFAULT_MGF;
-      n_modes_ = preset->num_modes;
+      bend_ = 1;
+      press_ = 0;
+      n_modes_ = set.num_modes < N ? set.num_modes : N;
 
       for (int i = 0; i < n_modes_; i++) {
-	modes_.push_back(preset->modes[i]);
-	gains_.push_back(preset->gains[i]);
-	res_.push_back(preset->res[i]);
+	modes_[i] = set.modes[i];
+	gains_[i] = set.gains[i];
+	res_[i] = set.res[i];
 
 	float mode_f;
-	if (modes_.at(i) > 0) {
-	  mode_f = modes_.at(i) * fc_;  
+	if (modes_[i] > 0) {
+	  mode_f = modes_[i] * fc_;  
 	} else {
-	  mode_f = -modes_.at(i);
+	  mode_f = -modes_[i];
 	}
 	// dont alias
 	if (mode_f > (fs_ / 2)) {
@@ -53,29 +86,43 @@ class modal_inharm
 	  break;
 	}
 
-	float mode_g = gains_.at(i) / pow((i + 1), mgf_);
-	float mode_r = res_.at(i);
+	float mode_g = gains_[i] / pow((i + 1), mgf_);
+	float mode_r = res_[i];
 
-	modes[i].init(fs_, mode_f, CLAMP(mode_r, 0, RES_MAX), mode_g);
+	base_fc_[i] = mode_f;
+	base_r_[i] = CLAMP(mode_r, 0, RES_MAX);
+	modes[i].init(fs_, mode_f, base_r_[i], mode_g);
       }
+      silence_from(n_modes_);
 
       input_filt.init(fs_, DEFAULT_IFC);
+      input_hist_.Reset();
+      cull_.Init(fs_);
+      prec_.Init(fs_);
+#ifdef MODAL_CMSIS_BIQUAD
+      cmsis_.Reset();
+#endif
     }
 
     void load_preset(inharm_preset *preset)
+    {
+      load_modes(preset_modes(preset));
+    }
+
+    void load_modes(const mode_set &set)
     {
       int i;
-      n_modes_ = preset->num_modes;
+      n_modes_ = set.num_modes < N ? set.num_modes : N;
       for (i = 0; i < n_modes_; i++) {
-	modes_.at(i) = preset->modes[i];
-	gains_.at(i) = preset->gains[i];
-	res_.at(i) = preset->res[i];
+	modes_[i] = set.modes[i];
+	gains_[i] = set.gains[i];
+	res_[i] = set.res[i];
 
 	float mode_f;
-	if (modes_.at(i) > 0) {
-	  mode_f = modes_.at(i) * fc_;  
+	if (modes_[i] > 0) {
+	  mode_f = modes_[i] * fc_;  
 	} else {
-	  mode_f = -modes_.at(i);
+	  mode_f = -modes_[i];
 	}
 	// dont alias
 	if (mode_f > (fs_ / 2)) {
@@ -83,38 +130,122 @@ class modal_inharm
 	  break;
 	}
 
-	float mode_g = gains_.at(i) / pow((i + 1), mgf_);
-	float mode_r = res_.at(i);
+	float mode_g = gains_[i] / pow((i + 1), mgf_);
+	float mode_r = res_[i];
 
-	modes[i].update_fc(mode_f);
-	modes[i].update_r(CLAMP(mode_r, 0, RES_MAX));
+	set_mode_fc(i, mode_f);
+	set_mode_r(i, CLAMP(mode_r, 0, RES_MAX));
 	modes[i].update_g(mode_g);
       }
+      silence_from(n_modes_);
+      coefs_changed();
     }
 
     float Process(float in)
+    {
+      // The offset also keeps the input filter's own tail out of the subnormal range
+      return ProcessFiltered(input_filt.Process(in + input_hist_.offset));
+    }
+
+    // in_filt has already been through an input filter at this voice's cutoff
+    float ProcessFiltered(float in_filt)
     {
       float out = 0;
-      float in_filt = input_filt.Process(in);
-      for (int i = 0; i < n_modes_; i++) {
-        out += modes[i].Process(in_filt) / n_modes_;
+      float d = input_hist_.Process(in_filt);
+      if (n_modes_ == 0) return out;
+      if (cull_.Dirty()) {
+	cull_.Update(modes.data(), hot_.data(), n_modes_);
+      }
+      if (cull_.Active()) {
+	return cull_.Process(hot_.data(), d, n_modes_);
+      }
+      if (prec_.Dirty()) {
+	prec_.Update(modes.data(), hot_.data(), n_modes_);
+      }
+      if (prec_.Active()) {
+	return prec_.Process(hot_.data(), d, n_modes_);
+      }
+      // Modes past n_modes_ are silent, a fixed trip count lets the loop unroll
+      for (int i = 0; i < N; i++) {
+        out += reson_process(hot_[i], d) / n_modes_;
       }
       // Let's do clamping after summing in the top level
       return out;
     }
 
+    // Stereo versions, side receives the modes weighted by their side gains, see set_pan
+    float Process(float in, float &side)
+    {
+      return ProcessFiltered(input_filt.Process(in + input_hist_.offset), side);
+    }
+
+    float ProcessFiltered(float in_filt, float &side)
+    {
+      if (cull_.Active()) {
+	// Culled voices are placed as a whole
+	float out = ProcessFiltered(in_filt);
+	side = pan_ * out;
+	return out;
+      }
+      float d = input_hist_.Process(in_filt);
+      if (n_modes_ == 0) {
+	side = 0;
+	return 0;
+      }
+      if (prec_.Dirty()) {
+	prec_.Update(modes.data(), hot_.data(), n_modes_);
+      }
+      if (prec_.Active()) {
+	return prec_.Process(hot_.data(), side_.data(), d, n_modes_, side);
+      }
+      float out = 0, s = 0;
+      for (int i = 0; i < N; i++) {
+	float v = reson_process(hot_[i], d);
+	out += v;
+	s += v * side_[i];
+      }
+      float norm = 1.0f / n_modes_;
+      side = s * norm;
+      return out * norm;
+    }
+
+    /*
+     * Place the modes between the outputs: each mode's side gain is pan plus or minus spread,
+     * alternate modes going opposite ways, limited to -1 (left) .. 1 (right).
+     * The outputs are mid + side and mid - side
+     */
+    void set_pan(float pan, float spread)
+    {
+      pan_ = pan;
+      spread_ = spread;
+      for (int i = 0; i < N; i++) {
+	float g = pan + ((i & 1) ? spread : -spread);
+	side_[i] = CLAMP(g, -1.0f, 1.0f);
+      }
+    }
+
+    // One mode's side gain, until the next set_pan
+    void set_mode_pan(int i, float pan)
+    {
+      side_[i] = CLAMP(pan, -1.0f, 1.0f);
+    }
+
+    float pan() const { return pan_; }
+    float spread() const { return spread_; }
+
     void update_fc(float fc)
     {
       int i;
       if (fc != fc_) {
+	coefs_changed();
 	fc_ = fc;
 
 	for (i = 0; i < n_modes_; i++) {
       	  float mode_f;
-	  if (modes_.at(i) > 0) {
-	    mode_f = modes_.at(i) * fc_;  
+	  if (modes_[i] > 0) {
+	    mode_f = modes_[i] * fc_;  
 	  } else {
-	    mode_f = -modes_.at(i);  
+	    mode_f = -modes_[i];  
 	  }
       	  // dont alias
       	  if (mode_f > (fs_ / 2)) { 
@@ -122,39 +253,119 @@ class modal_inharm
 	    break;
 	  }
 	
-      	  modes[i].update_fc(mode_f);
+      	  set_mode_fc(i, mode_f);
       	}
+	silence_from(n_modes_);
       }
     }
     
+    // What the mode frequencies depend on besides the fundamental, for pitch_table
+    void pitch_key(uint32_t *key) const
+    {
+      uint32_t hash = 2166136261u;
+      for (int i = 0; i < n_modes_; i++) {
+	hash = (hash ^ pitch_bits(modes_[i])) * 16777619u;
+      }
+      key[0] = hash;
+      key[1] = n_modes_;
+      key[2] = 0;
+    }
+
+    // The mode frequencies update_fc(fc) would set, worked out without touching the voice
+    void save_pitch(float fc, pitch_entry<N> &e) const
+    {
+      pitch_key(e.key);
+      e.fc = fc;
+      int i;
+      for (i = 0; i < n_modes_; i++) {
+	float mode_f;
+	if (modes_[i] > 0) {
+	  mode_f = modes_[i] * fc;
+	} else {
+	  mode_f = -modes_[i];
+	}
+	// dont alias
+	if (mode_f > (fs_ / 2)) break;
+
+	e.mode_fc[i] = mode_f;
+	e.cos_wc[i] = modes[i].cos_wc(mode_f);
+      }
+      e.n_set = e.n_modes = i;
+    }
+
+    // update_fc from a save_pitch entry made with the same pitch_key
+    void load_pitch(const pitch_entry<N> &e)
+    {
+      if (e.fc != fc_) {
+	coefs_changed();
+	fc_ = e.fc;
+	for (int i = 0; i < e.n_set; i++) {
+	  base_fc_[i] = e.mode_fc[i];
+	  if (bend_ == 1 || modes_[i] <= 0) {
+	    modes[i].set_fc(e.mode_fc[i], e.cos_wc[i]);
+	  } else {
+	    modes[i].update_fc(bent(i, e.mode_fc[i]));
+	  }
+	}
+	n_modes_ = e.n_modes;
+	silence_from(n_modes_);
+      }
+    }
+
     void update_r(float *res)
     {
       for (int i = 0; i < n_modes_; i++) {
 	float r = res[i];
-	if (r != res_.at(i)) {
-	  res_.at(i) = r;
-      	  modes[i].update_r(res_.at(i));
+	if (r != res_[i]) {
+	  res_[i] = r;
+      	  set_mode_r(i, res_[i]);
+	  coefs_changed();
 	}
       }
     }
 
-    // keeps res_.at(i) as the baseline and increases
+    // keeps res_[i] as the baseline and increases
     // amt should be between 0 and 1 where 0 is baseline and 1 is RES_MAX
     void modulate_r(float amt)
     {
       for (int i = 0; i < n_modes_; i++) {
-	float r = res_.at(i) + amt * (RES_MAX - res_.at(i));
-	modes[i].update_r(r);
+	float r = res_[i] + amt * (RES_MAX - res_[i]);
+	set_mode_r(i, r);
+      }
+      coefs_changed();
+    }
+
+    // Pitch bend: modes that follow the fundamental move to ratio times their frequency, see modal_note::bend
+    void bend(float ratio)
+    {
+      if (ratio != bend_) {
+	coefs_changed();
+	bend_ = ratio;
+	for (int i = 0; i < n_modes_; i++) {
+	  if (modes_[i] > 0) modes[i].update_fc(bent(i, base_fc_[i]));
+	}
+      }
+    }
+
+    // Pressure: every mode's pole radius amt (0 to 1) of the way up to RES_MAX, on top of modulate_r
+    void press(float amt)
+    {
+      if (amt != press_) {
+	coefs_changed();
+	press_ = amt;
+	for (int i = 0; i < n_modes_; i++) {
+	  modes[i].update_r(pressed(base_r_[i]));
+	}
       }
     }
 
-    // keeps gains_.at(i) as the baseline and increases
+    // keeps gains_[i] as the baseline and increases
     // amt should be between 0 and 1 where 0 is baseline and 1 is GAIN_MAX
     void modulate_g(float amt)
     {
       for (int i = 0; i < n_modes_; i++) {
-	//float g = gains_.at(i) + amt * (GAIN_MAX - gains_.at(i));
-	float g = gains_.at(i) + amt * (GAIN_MAX * gains_.at(i) - gains_.at(i));
+	//float g = gains_[i] + amt * (GAIN_MAX - gains_[i]);
+	float g = gains_[i] + amt * (GAIN_MAX * gains_[i] - gains_[i]);
 	modes[i].update_g(g);
       }
     }
@@ -185,12 +396,129 @@ class modal_inharm
       input_filt.update_fc(ifc);
     }
 
+    /*
+     * Each running mode's frequency, pole radius and gain at resonance into the voice's output,
+     * for working out couplings. Returns the number of modes written
+     */
+    int resonances(float *fc, float *r, float *peak) const
+    {
+      int n = 0;
+      for (int i = 0; i < n_modes_; i++) {
+	float g = modes[i].g() * modes[i].r();
+	if (g == 0) continue;
+	fc[n] = modes[i].fc();
+	r[n] = modes[i].r();
+	peak[n] = g / (1 - r[n]) / n_modes_;
+	n++;
+      }
+      return n;
+    }
+
+    // Run at most k modes, the most audible ones. N turns culling off
+    // Not applied to the CMSIS block path
+    void set_mode_budget(int k)
+    {
+      cull_.SetBudget(k);
+    }
+
+    int running_modes() const
+    {
+      return cull_.Active() ? cull_.Running() : N;
+    }
+
+    // Run low modes with error feedback or in double where float can't hold them, see reson_precision.h
+    // Not applied to the CMSIS block path, the mode budget takes over from it
+    void set_precision(bool on)
+    {
+      prec_.SetEnabled(on);
+    }
+
+    int precision_count(int cls) const
+    {
+      return prec_.Count(cls);
+    }
+
+    // Every mode runs in float, so the output is what save_coefs describes
+    bool plain()
+    {
+      if (prec_.Dirty()) {
+	prec_.Update(modes.data(), hot_.data(), n_modes_);
+      }
+      return !cull_.Active() && !prec_.Active();
+    }
+
   private:
-    int n_modes_;
-    iir_reson *modes;
+    // modal_voice has rewritten the modes' state
+    void state_changed()
+    {
+      prec_.Reload();
+    }
+
+    // What modal_voice's CMSIS path divides the summed modes by
+    int divisor() const
+    {
+      return n_modes_;
+    }
+
+    void coefs_changed()
+    {
+      cull_.MarkDirty();
+      prec_.MarkDirty();
+    }
+
+    // Mode i at mode_f Hz and radius mode_r before bend and pressure
+    void set_mode_fc(int i, float mode_f)
+    {
+      base_fc_[i] = mode_f;
+      modes[i].update_fc(bent(i, mode_f));
+    }
+
+    void set_mode_r(int i, float mode_r)
+    {
+      base_r_[i] = mode_r;
+      modes[i].update_r(pressed(mode_r));
+    }
+
+    // Modes at a fixed frequency don't bend
+    float bent(int i, float mode_f) const
+    {
+      if (bend_ == 1 || modes_[i] <= 0) return mode_f;
+      float f = mode_f * bend_;
+      return f < fs_ * BEND_NYQUIST ? f : fs_ * BEND_NYQUIST;
+    }
+
+    float pressed(float mode_r) const
+    {
+      return mode_r + press_ * (RES_MAX - mode_r);
+    }
+
+    void silence_from(int first)
+    {
+      for (int i = first; i < N; i++) {
+	modes[i].silence();
+      }
+#ifdef MODAL_CMSIS_BIQUAD
+      cmsis_.Reset(first);
+#endif
+    }
+
+    int n_modes_ = N;
+    alignas(RESON_ALIGN) std::array<reson_hot, N> hot_;	// hot - contiguous, walked every sample
+    reson_input input_hist_;
+    mode_cull<N> cull_;
+    reson_precision<N> prec_;
+#ifdef MODAL_CMSIS_BIQUAD
+    reson_bank_cmsis<N> cmsis_;
+#endif
+    std::array<iir_reson, N> modes;	// cold - touched at control rate
     iir_1p_lp input_filt;
+    std::array<float, N> side_;		// per-mode side gain, see set_pan
+    float pan_ = 0, spread_ = 0;
     float fs_, fc_, mgf_;
-    std::vector<float> modes_, gains_, res_;
+    std::array<float, N> modes_, gains_, res_;
+    // Mode frequencies and radii before bend and pressure
+    std::array<float, N> base_fc_, base_r_;
+    float bend_ = 1, press_ = 0;
 };
 } // namespace daisysp
 #endif
@@ -10,13 +10,27 @@
 #define DEFAULT_BETA  2
 #define DEFAULT_MGF   0
 #define DEFAULT_IFC   10
+// Bent modes stop short of Nyquist rather than alias
+#define BEND_NYQUIST  0.49f
 
 #define CLAMP(x, min, max)  ((x) > max) ? max : (((x) < min) ? min : x)
 
 #include <stdint.h>
+#include <stddef.h>
+#include <array>
 #include "arm_math.h"
 #include "iir_reson.h"
 #include "iir_1p_lp.h"
+#include "denormal.h"
+#include "ir_cache.h"
+#include "modal_voice.h"
+#include "tuning.h"
+#include "mode_cull.h"
+#include "reson_multirate.h"
+#include "reson_precision.h"
+#ifdef MODAL_CMSIS_BIQUAD
+#include "reson_bank_cmsis.h"
+#endif
 #ifdef __cplusplus
 
 namespace daisysp
@@ -26,13 +40,27 @@ namespace daisysp
  * Specify the fundamental frequency and number of modes as well as different stiffness, pluck position 
  * and gain/resonance factors 
  *
+ * N is the most modes the voice can hold, storage is fixed at compile time
+ *
  *   Jared Anderson May 2021
  */
-class modal_note
+template <int N>
+class modal_note : public modal_voice<modal_note<N>, N>
 {
+    friend class modal_voice<modal_note<N>, N>;
+
   public:
-    modal_note(int n) :n_modes_{n}, modes{new iir_reson[n]} {}
-    ~modal_note() { delete[] modes; }
+    modal_note()
+    {
+      for (int i = 0; i < N; i++) {
+	modes[i].attach(&hot_[i]);
+      }
+      hot_.fill(reson_hot());
+      side_.fill(0);
+    }
+    // The resonators point into hot_
+    modal_note(const modal_note &) = delete;
+    modal_note &operator=(const modal_note &) = delete;
 
     void init(float fs, float fc, float r)
     {
@@ -45,7 +73,15 @@ class modal_note
       beta_ = DEFAULT_BETA;
       mgf_ = DEFAULT_MGF;
       mrf_ = 0;
-
+      bend_ = 1;
+      press_ = 0;
+      n_modes_ = N;
+
+      // Modes the loop leaves alone bend from where they are
+      for (int i = 0; i < N; i++) {
+	base_fc_[i] = modes[i].fc();
+	base_r_[i] = modes[i].r();
+      }
       int calculated_modes = 0;
       for (int i = 0; calculated_modes < n_modes_; i++) {
 
@@ -64,28 +100,121 @@ class modal_note
 	float mode_r = r_ - i * mrf_;
 	if (mode_r < 0) mode_r = 0;
 
-	modes[calculated_modes].init(fs_, mode_f, CLAMP(mode_r, 0, RES_MAX), mode_g);
+	base_fc_[calculated_modes] = mode_f;
+	base_r_[calculated_modes] = CLAMP(mode_r, 0, RES_MAX);
+	modes[calculated_modes].init(fs_, mode_f, base_r_[calculated_modes], mode_g);
 	calculated_modes++;
       }
       n_modes_ = calculated_modes;
+      silence_from(n_modes_);
 
       input_filt.init(fs_, DEFAULT_IFC);
+      input_hist_.Reset();
+      cull_.Init(fs_);
+      mr_.Init(fs_);
+      prec_.Init(fs_);
+#ifdef MODAL_CMSIS_BIQUAD
+      cmsis_.Reset();
+#endif
     }
 
     float Process(float in)
+    {
+      // The offset also keeps the input filter's own tail out of the subnormal range
+      return ProcessFiltered(input_filt.Process(in + input_hist_.offset));
+    }
+
+    // in_filt has already been through an input filter at this voice's cutoff
+    float ProcessFiltered(float in_filt)
     {
       float out = 0;
-      float in_filt = input_filt.Process(in);
-      for (int i = 0; i < n_modes_; i++) {
-        out += modes[i].Process(in_filt) / n_modes_;
+      float d = input_hist_.Process(in_filt);
+      if (mr_.Enabled()) {
+	if (mr_.Dirty()) {
+	  mr_.Update(modes.data(), hot_.data(), n_modes_);
+	}
+	return mr_.Process(hot_.data(), in_filt, d, n_modes_);
+      }
+      if (cull_.Dirty()) {
+	cull_.Update(modes.data(), hot_.data(), n_modes_);
+      }
+      if (cull_.Active()) {
+	return cull_.Process(hot_.data(), d, n_modes_);
+      }
+      if (prec_.Dirty()) {
+	prec_.Update(modes.data(), hot_.data(), n_modes_);
+      }
+      if (prec_.Active()) {
+	return prec_.Process(hot_.data(), d, n_modes_);
+      }
+      // Modes past n_modes_ are silent, a fixed trip count lets the loop unroll
+      for (int i = 0; i < N; i++) {
+        out += reson_process(hot_[i], d) / n_modes_;
       }
       // Let's do any clamping after summing in the top level
       return out;
     }
 
+    // Stereo versions, side receives the modes weighted by their side gains, see set_pan
+    float Process(float in, float &side)
+    {
+      return ProcessFiltered(input_filt.Process(in + input_hist_.offset), side);
+    }
+
+    float ProcessFiltered(float in_filt, float &side)
+    {
+      if (mr_.Enabled() || cull_.Active()) {
+	// Culled and multirate voices are placed as a whole
+	float out = ProcessFiltered(in_filt);
+	side = pan_ * out;
+	return out;
+      }
+      float d = input_hist_.Process(in_filt);
+      if (prec_.Dirty()) {
+	prec_.Update(modes.data(), hot_.data(), n_modes_);
+      }
+      if (prec_.Active()) {
+	return prec_.Process(hot_.data(), side_.data(), d, n_modes_, side);
+      }
+      float out = 0, s = 0;
+      for (int i = 0; i < N; i++) {
+	float v = reson_process(hot_[i], d);
+	out += v;
+	s += v * side_[i];
+      }
+      float norm = 1.0f / n_modes_;
+      side = s * norm;
+      return out * norm;
+    }
+
+    /*
+     * Place the modes between the outputs: each mode's side gain is pan plus or minus spread,
+     * alternate modes going opposite ways, limited to -1 (left) .. 1 (right).
+     * The outputs are mid + side and mid - side
+     */
+    void set_pan(float pan, float spread)
+    {
+      pan_ = pan;
+      spread_ = spread;
+      for (int i = 0; i < N; i++) {
+	float g = pan + ((i & 1) ? spread : -spread);
+	side_[i] = CLAMP(g, -1.0f, 1.0f);
+      }
+    }
+
+    // One mode's side gain, until the next set_pan
+    void set_mode_pan(int i, float pan)
+    {
+      side_[i] = CLAMP(pan, -1.0f, 1.0f);
+    }
+
+    float pan() const { return pan_; }
+    float spread() const { return spread_; }
+
     void update_fc(float fc)
     {
       if (fc != fc_) {
+	coefs_changed();
 	fc_ = fc;
 
 	int calculated_modes = 0;
@@ -102,16 +231,73 @@ class modal_note
   	    break;
 	  }
 
-      	  modes[calculated_modes].update_fc(mode_f);
+      	  set_mode_fc(calculated_modes, mode_f);
       	  calculated_modes++;
       	}
 	n_modes_ = calculated_modes;
+	silence_from(n_modes_);
+      }
+    }
+
+    // What the mode frequencies depend on besides the fundamental, for pitch_table
+    void pitch_key(uint32_t *key) const
+    {
+      key[0] = pitch_bits(stiffness_);
+      key[1] = beta_;
+      key[2] = n_modes_;
+    }
+
+    // The mode frequencies update_fc(fc) would set, worked out without touching the voice
+    void save_pitch(float fc, pitch_entry<N> &e) const
+    {
+      pitch_key(e.key);
+      e.fc = fc;
+      e.n_set = 0;
+      int calculated_modes = 0;
+      for (int i = 0; calculated_modes < n_modes_; i++) {
+
+	// skip modes defined by beta
+	if (fmod(i, beta_) == 0) continue;
+
+	float mode_f = (i + 1) * fc * sqrt(1 + stiffness_ * pow(i, 2));
+
+	// dont alias
+	if (mode_f > (fs_ / 2)) {
+	  calculated_modes++;
+	  break;
+	}
+
+	e.mode_fc[calculated_modes] = mode_f;
+	e.cos_wc[calculated_modes] = modes[calculated_modes].cos_wc(mode_f);
+	calculated_modes++;
+	e.n_set = calculated_modes;
+      }
+      e.n_modes = calculated_modes;
+    }
+
+    // update_fc from a save_pitch entry made with the same pitch_key
+    void load_pitch(const pitch_entry<N> &e)
+    {
+      if (e.fc != fc_) {
+	coefs_changed();
+	fc_ = e.fc;
+	for (int i = 0; i < e.n_set; i++) {
+	  base_fc_[i] = e.mode_fc[i];
+	  if (bend_ == 1) {
+	    modes[i].set_fc(e.mode_fc[i], e.cos_wc[i]);
+	  } else {
+	    modes[i].update_fc(bent(e.mode_fc[i]));
+	  }
+	}
+	n_modes_ = e.n_modes;
+	silence_from(n_modes_);
       }
     }
 
     void update_r(float r)
     {
       if (r != r_) {
+	coefs_changed();
 	r_ = r;
 
         int calculated_modes = 0;
@@ -122,7 +308,8 @@ class modal_note
   
   	  float mode_r = r_ - i * mrf_;
   	  if (mode_r < 0) mode_r = 0;
-      	  modes[calculated_modes].update_r(mode_r);
+	  base_r_[calculated_modes] = mode_r;
+      	  modes[calculated_modes].update_r(pressed(mode_r));
       	  calculated_modes++;
       	}
       }
@@ -131,6 +318,7 @@ class modal_note
     void update_g(float g)
     {
       if (g != g_) {
+	coefs_changed();
 	g_ = g;
 
 	int calculated_modes = 0;
@@ -150,6 +338,7 @@ class modal_note
     void update_stiffness(float stiffness)
     {
       if (stiffness != stiffness_) {
+	coefs_changed();
 	stiffness_ = stiffness;
 
 	int calculated_modes = 0;
@@ -165,16 +354,18 @@ class modal_note
 	    break;
 	  }
 
-      	  modes[calculated_modes].update_fc(mode_f);
+      	  set_mode_fc(calculated_modes, mode_f);
       	  calculated_modes++;
 	}
 	n_modes_ = calculated_modes;
+	silence_from(n_modes_);
       }
     }
 
     void update_beta(int beta)
     {
       if (beta != beta_) {
+	coefs_changed();
 	beta_ = beta;
 
 	int calculated_modes = 0;
@@ -191,10 +382,11 @@ class modal_note
 	    break;
 	  }
 
-      	  modes[calculated_modes].update_fc(mode_f);
+      	  set_mode_fc(calculated_modes, mode_f);
       	  calculated_modes++;
       	}
 	n_modes_ = calculated_modes;
+	silence_from(n_modes_);
       }
     }
 
@@ -203,6 +395,7 @@ class modal_note
     void update_mgf(float mgf)
     {
       if (mgf != mgf_) {
+	coefs_changed();
 	mgf_ = mgf;
 
 	int calculated_modes = 0;
@@ -218,21 +411,168 @@ class modal_note
       }
     }
 
+    /*
+     * Pitch bend: every mode at ratio times the frequency the pitch gives it.
+     * Only multiplies the modes' frequencies and rewrites a[0], nothing depending on
+     * stiffness or beta is worked out again
+     */
+    void bend(float ratio)
+    {
+      if (ratio != bend_) {
+	coefs_changed();
+	bend_ = ratio;
+	for (int i = 0; i < n_modes_; i++) {
+	  modes[i].update_fc(bent(base_fc_[i]));
+	}
+      }
+    }
+
+    // Pressure: every mode's pole radius amt (0 to 1) of the way up to RES_MAX, the radius is all that's rewritten
+    void press(float amt)
+    {
+      if (amt != press_) {
+	coefs_changed();
+	press_ = amt;
+	for (int i = 0; i < n_modes_; i++) {
+	  modes[i].update_r(pressed(base_r_[i]));
+	}
+      }
+    }
+
     void update_ifc(float ifc)
     {
       input_filt.update_fc(ifc);
     }
 
-    /* TODO:
-     * Add chords
+    /*
+     * Each running mode's frequency, pole radius and gain at resonance into the voice's output,
+     * for working out couplings. Returns the number of modes written
      */
+    int resonances(float *fc, float *r, float *peak) const
+    {
+      int n = 0;
+      for (int i = 0; i < n_modes_; i++) {
+	float g = modes[i].g() * modes[i].r();
+	if (g == 0) continue;
+	fc[n] = modes[i].fc();
+	r[n] = modes[i].r();
+	peak[n] = g / (1 - r[n]) / n_modes_;
+	n++;
+      }
+      return n;
+    }
+
+    // Run at most k modes, the most audible ones. N turns culling off
+    // Not applied to the CMSIS block path
+    void set_mode_budget(int k)
+    {
+      cull_.SetBudget(k);
+    }
+
+    // Run low modes at decimated rates, see reson_multirate.h. Takes over from the mode budget
+    void set_multirate(bool on)
+    {
+      mr_.SetEnabled(on, modes.data());
+    }
+
+    int multirate_count(int tier) const
+    {
+      return mr_.Count(tier);
+    }
+
+    // Run low modes with error feedback or in double where float can't hold them, see reson_precision.h
+    // Not applied to the CMSIS block path, the mode budget and multirate take over from it
+    void set_precision(bool on)
+    {
+      prec_.SetEnabled(on);
+    }
+
+    int precision_count(int cls) const
+    {
+      return prec_.Count(cls);
+    }
+
+    int running_modes() const
+    {
+      return cull_.Active() ? cull_.Running() : N;
+    }
+
+    // Every mode runs at the full rate in float, so the output is what save_coefs describes
+    bool plain()
+    {
+      if (prec_.Dirty()) {
+	prec_.Update(modes.data(), hot_.data(), n_modes_);
+      }
+      return !mr_.Enabled() && !cull_.Active() && !prec_.Active();
+    }
 
   private:
-    int n_modes_;
-    iir_reson *modes;
+    // modal_voice has rewritten the modes' state
+    void state_changed()
+    {
+      prec_.Reload();
+    }
+
+    // What modal_voice's CMSIS path divides the summed modes by
+    int divisor() const
+    {
+      return n_modes_;
+    }
+
+    void coefs_changed()
+    {
+      cull_.MarkDirty();
+      mr_.MarkDirty();
+      prec_.MarkDirty();
+    }
+
+    // Mode k at mode_f Hz before bending
+    void set_mode_fc(int k, float mode_f)
+    {
+      base_fc_[k] = mode_f;
+      modes[k].update_fc(bent(mode_f));
+    }
+
+    float bent(float mode_f) const
+    {
+      if (bend_ == 1) return mode_f;
+      float f = mode_f * bend_;
+      return f < fs_ * BEND_NYQUIST ? f : fs_ * BEND_NYQUIST;
+    }
+
+    float pressed(float mode_r) const
+    {
+      return mode_r + press_ * (RES_MAX - mode_r);
+    }
+
+    void silence_from(int first)
+    {
+      for (int i = first; i < N; i++) {
+	modes[i].silence();
+      }
+#ifdef MODAL_CMSIS_BIQUAD
+      cmsis_.Reset(first);
+#endif
+    }
+
+    int n_modes_ = N;
+    alignas(RESON_ALIGN) std::array<reson_hot, N> hot_;	// hot - contiguous, walked every sample
+    reson_input input_hist_;
+    mode_cull<N> cull_;
+    reson_multirate<N> mr_;
+    reson_precision<N> prec_;
+#ifdef MODAL_CMSIS_BIQUAD
+    reson_bank_cmsis<N> cmsis_;
+#endif
+    std::array<iir_reson, N> modes;	// cold - touched at control rate
     iir_1p_lp input_filt;
+    std::array<float, N> side_;		// per-mode side gain, see set_pan
+    float pan_ = 0, spread_ = 0;
     float fs_, fc_, r_, gdb_, g_, stiffness_, mgf_, mrf_;
     int beta_;
+    // Mode frequencies and radii before bend and pressure
+    std::array<float, N> base_fc_, base_r_;
+    float bend_ = 1, press_ = 0;
 
 };
 } // namespace daisysp
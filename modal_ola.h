@@ -0,0 +1,567 @@
+#pragma once
+#ifndef DSY_MODAL_OLA_H
+#define DSY_MODAL_OLA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <array>
+#include "arm_math.h"
+#include "iir_reson.h"
+#include "iir_1p_lp.h"
+#include "denormal.h"
+#include "modal_inharm.h"
+#include "mode_set.h"
+#ifdef __cplusplus
+
+// Samples between frames, and the voice's latency
+#define OLA_HOP		64
+// Frames are Hann windowed over two hops and overlap by half
+#define OLA_LEN		(2 * OLA_HOP)
+// The input FFT is zero padded to this many hops, so its spectrum interpolates well between bins
+#define OLA_IN_PAD	4
+#define OLA_IN_LEN	(OLA_IN_PAD * OLA_HOP)
+// Bins either side of a mode that its windowed spectrum is spread over
+#define OLA_KERNEL	3
+// Kernel table points per bin
+#define OLA_KERNEL_OS	64
+#define OLA_KERNEL_SIZE (OLA_KERNEL * OLA_KERNEL_OS + 2)
+#define OLA_KERNEL_BINS (2 * OLA_KERNEL + 1)
+// Input spectrum bins past either end, filled by symmetry so the interpolation needn't check
+#define OLA_IN_GUARD	2
+// Frame bins plus the kernel's overhang either side, as complex pairs
+#define OLA_ACC_LEN	(2 * (OLA_HOP + 1 + 2 * OLA_KERNEL))
+
+namespace daisysp
+{
+/*
+ * ola_mode
+ *
+ * A mode as a complex one pole p = r e^jw, touched once per hop, not per sample.
+ * The real resonator b0 (1 - z^-2) / ((1 - p z^-1)(1 - p* z^-1)) is
+ * Re(b0 * -j e^jw / sin w * (1 - z^-2) s[n]) where s[n] = p s[n-1] + x[n].
+ * The states are driven by x itself and the (1 - z^-2) is taken at the end of each hop:
+ *   s[n] - s[n-2] = (1 - p^-2) s[n] + p^-1 x[n-1] + p^-2 x[n]
+ * The last two terms are the part of the response that follows the input rather than rings.
+ * Rendered as ringing for a whole frame they are only right when the input is smooth next to
+ * the mode, so they are kept for modes above the input filter's cutoff and dropped below it,
+ * where the input looks like noise to the mode and they would only add it.
+ */
+template <int CH = 1>
+struct ola_mode
+{
+  float s[2];	// state at the end of the last hop
+  float ph[2];	// p^OLA_HOP
+  // One output phasor per channel, each with its own b0
+  float q[CH][2];	// b0 * -j e^jw / sin w * (1 - p^-2)
+  float q1[CH][2];	// b0 * -j e^jw / sin w * p^-1, or 0 below the input filter
+  float q2[CH][2];	// b0 * -j e^jw / sin w * p^-2, or 0 below the input filter
+  float xw[4][2];	// weights of the four input bins from xk, see Interpolation
+  float kw[OLA_KERNEL_BINS];	// window kernel over the frame bins from sk
+  int16_t xk, sk;
+};
+
+/*
+ * modal_ola
+ *
+ * An inharmonic modal voice synthesised a frame at a time in the frequency domain,
+ * for mode counts where a resonator per mode costs too much.
+ * Takes the same mode data and controls as modal_inharm.
+ *
+ * Every hop each mode's state is advanced by p^hop and the hop's input is added in
+ * from an FFT of the input, interpolated at the mode's frequency.
+ * Each mode then adds its Hann windowed spectrum, a few bins of a tabulated kernel, to the frame
+ * and one inverse FFT renders every mode at once. Frames overlap-add at 50%.
+ * Per mode that is a few complex multiply-adds per hop instead of 3 multiplies per sample,
+ * plus two FFTs per hop for the voice.
+ *
+ * Approximations: within a frame each mode is a steady sinusoid, so decay is
+ * stepped per hop and crossfaded by the windows; an excitation's level and phase come from
+ * an interpolated spectrum; attacks are smeared over a hop. Output lags the input by OLA_HOP.
+ *
+ * The interpolation and kernel weights only change when a mode is retuned, so each mode carries
+ * its own and a hop is straight multiply-adds over the bins it touches.
+ *
+ * CH > 1 renders several outputs from the same mode states, each channel with its own gains
+ * (load_gains), for stereo mode sets. Process and AddBlock give channel 0.
+ *
+ * N is the most modes the voice can hold, 104 bytes each (24 more per extra channel)
+ * plus the cold parameters.
+ */
+template <int N, int CH = 1>
+class modal_ola
+{
+  public:
+    modal_ola()
+    {
+      arm_rfft_fast_init_f32(&fft_, OLA_LEN);
+      arm_rfft_fast_init_f32(&fft_in_, OLA_IN_LEN);
+      // Hann's transform, real because the window is centred on the frame
+      for (int i = 0; i < OLA_KERNEL_SIZE; i++) {
+	float delta = (float)i / OLA_KERNEL_OS;
+	float sum = 0;
+	for (int m = -OLA_HOP; m < OLA_HOP; m++) {
+	  float w = 0.5f - 0.5f * cosf(2 * PI * (m + OLA_HOP) / OLA_LEN);
+	  sum += w * cosf(2 * PI * delta * m / OLA_LEN);
+	}
+	kernel_[i] = sum;
+      }
+      clear();
+    }
+    modal_ola(const modal_ola &) = delete;
+    modal_ola &operator=(const modal_ola &) = delete;
+
+    void init(float fs, float fc, inharm_preset *preset)
+    {
+      init(fs, fc, preset_modes(preset));
+    }
+
+    void init(float fs, float fc, const mode_set &set)
+    {
+      fs_ = fs;
+      fc_ = fc;
+      mgf_ = DEFAULT_MGF;
+      ifc_ = DEFAULT_IFC;
+      input_filt.init(fs_, ifc_);
+      clear();
+      load_modes(set);
+    }
+
+    void load_preset(inharm_preset *preset)
+    {
+      load_modes(preset_modes(preset));
+    }
+
+    void load_modes(const mode_set &set)
+    {
+      n_set_ = set.num_modes < N ? set.num_modes : N;
+      for (int i = 0; i < n_set_; i++) {
+	modes_[i] = set.modes[i];
+	res_[i] = set.res[i];
+	r_[i] = CLAMP(res_[i], 0, RES_MAX);
+	for (int c = 0; c < CH; c++) {
+	  gains_[c][i] = set.gains[i];
+	  g_[c][i] = gains_[c][i] / pow((i + 1), mgf_);
+	}
+      }
+      retune();
+    }
+
+    // Channel ch's own gains for the modes last loaded, in the mode set's order
+    void load_gains(int ch, const float *gains)
+    {
+      for (int i = 0; i < n_set_; i++) {
+	gains_[ch][i] = gains[i];
+	g_[ch][i] = gains_[ch][i] / pow((i + 1), mgf_);
+      }
+      for (int i = 0; i < n_modes_; i++) {
+	Recalc(i);
+      }
+    }
+
+    float Process(float in)
+    {
+      return ProcessFiltered(input_filt.Process(in + offset_));
+    }
+
+    float ProcessFiltered(float in_filt)
+    {
+      float out = out_[0][pos_];
+      Push(in_filt);
+      return out;
+    }
+
+    // Every channel's output, out[c] for channel c
+    void ProcessFiltered(float in_filt, float *out)
+    {
+      for (int c = 0; c < CH; c++) {
+	out[c] = out_[c][pos_];
+      }
+      Push(in_filt);
+    }
+
+    // Block versions add the voice's output into out, the FFT work lands on hop boundaries
+    void AddBlock(const float *in, float *out, size_t size)
+    {
+      for (size_t i = 0; i < size; i++) {
+	out[i] += Process(in[i]);
+      }
+    }
+
+    void AddFilteredBlock(const float *in_filt, float *out, size_t size)
+    {
+      for (size_t i = 0; i < size; i++) {
+	out[i] += ProcessFiltered(in_filt[i]);
+      }
+    }
+
+    // Channel c is added into out[c]
+    void AddFilteredBlock(const float *in_filt, float *const *out, size_t size)
+    {
+      for (size_t i = 0; i < size; i++) {
+	for (int c = 0; c < CH; c++) {
+	  out[c][i] += out_[c][pos_];
+	}
+	Push(in_filt[i]);
+      }
+    }
+
+    void update_fc(float fc)
+    {
+      if (fc != fc_) {
+	fc_ = fc;
+	retune();
+      }
+    }
+
+    void update_r(float *res)
+    {
+      for (int i = 0; i < n_modes_; i++) {
+	if (res[i] != res_[i]) {
+	  res_[i] = res[i];
+	  r_[i] = res_[i];
+	  Recalc(i);
+	}
+      }
+    }
+
+    // As modal_inharm::modulate_r
+    void modulate_r(float amt)
+    {
+      for (int i = 0; i < n_modes_; i++) {
+	r_[i] = res_[i] + amt * (RES_MAX - res_[i]);
+	Recalc(i);
+      }
+    }
+
+    // As modal_inharm::modulate_g, only the output phasors change
+    void modulate_g(float amt)
+    {
+      for (int i = 0; i < n_modes_; i++) {
+	for (int c = 0; c < CH; c++) {
+	  g_[c][i] = gains_[c][i] + amt * (GAIN_MAX * gains_[c][i] - gains_[c][i]);
+	}
+	Recalc(i);
+      }
+    }
+
+    void update_ifc(float ifc)
+    {
+      if (ifc != ifc_) {
+	ifc_ = ifc;
+	input_filt.update_fc(ifc);
+	for (int i = 0; i < n_modes_; i++) {
+	  Follow(i);
+	}
+      }
+    }
+
+    // Stop ringing and drop anything buffered
+    void clear()
+    {
+      for (int i = 0; i < N; i++) {
+	hot_[i].s[0] = hot_[i].s[1] = 0;
+      }
+      for (int i = 0; i < OLA_HOP; i++) {
+	in_[i] = 0;
+	for (int c = 0; c < CH; c++) {
+	  out_[c][i] = tail_[c][i] = 0;
+	}
+      }
+      pos_ = 0;
+      excited_ = false;
+    }
+
+    // Constant added to the input, 0 or DENORMAL_OFFSET. The states are only touched once a hop,
+    // this just keeps the input filter's tail out of the subnormal range
+    void set_denormal_offset(float offset)
+    {
+      offset_ = offset;
+    }
+
+    // Mode state currently in the subnormal range - for debugging long tails
+    int count_subnormal() const
+    {
+      int count = 0;
+      for (int i = 0; i < n_modes_; i++) {
+	count += is_subnormal(hot_[i].s[0]) + is_subnormal(hot_[i].s[1]);
+      }
+      return count;
+    }
+
+    int num_modes() const { return n_modes_; }
+
+  private:
+    void Push(float in_filt)
+    {
+      in_[pos_] = in_filt;
+      excited_ |= in_filt != 0;
+      if (++pos_ == OLA_HOP) {
+	Hop();
+	pos_ = 0;
+      }
+    }
+
+    // Frequencies from the fundamental, dropping modes past Nyquist as modal_inharm does
+    void retune()
+    {
+      int n = n_set_;
+      for (int i = 0; i < n_set_; i++) {
+	f_[i] = modes_[i] > 0 ? modes_[i] * fc_ : -modes_[i];
+	// dont alias
+	if (f_[i] > (fs_ / 2)) {
+	  n = i;
+	  break;
+	}
+      }
+      // Modes coming back start from rest
+      for (int i = n_modes_; i < n; i++) {
+	hot_[i].s[0] = hot_[i].s[1] = 0;
+      }
+      n_modes_ = n;
+      for (int i = 0; i < n_modes_; i++) {
+	Recalc(i);
+      }
+    }
+
+    void Recalc(int i)
+    {
+      ola_mode<CH> &m = hot_[i];
+      float r = r_[i];
+      float w = 2 * PI * f_[i] / fs_;
+      float sw = sinf(w);
+
+      float rh = powf(r, OLA_HOP);
+      m.ph[0] = rh * cosf(w * OLA_HOP);
+      m.ph[1] = rh * sinf(w * OLA_HOP);
+
+      // From the middle of a hop to its end
+      const int to_end = OLA_HOP - 1 - OLA_HOP / 2;
+      float re = powf(r, to_end);
+      float e[2] = {re * cosf(w * to_end), re * sinf(w * to_end)};
+      float damp = logf(r > 0 ? r : 1e-6f) * OLA_IN_LEN / (2 * PI);
+      Interpolation(f_[i] * OLA_IN_LEN / fs_, damp, e, m);
+
+      float bin = f_[i] * OLA_LEN / fs_;
+      m.sk = (int16_t)ceilf(bin - OLA_KERNEL);
+      for (int j = 0; j < OLA_KERNEL_BINS; j++) {
+	m.kw[j] = Kernel(bin - (m.sk + j));
+      }
+
+      // Right at DC or Nyquist the resonator's zeros cancel it
+      float u[3][2] = {};
+      if (fabsf(sw) >= 1e-6f) {
+	// -j e^jw / sin w = 1 - j cot w, times (1 - p^-2), p^-1 and p^-2
+	float qi = -cosf(w) / sw;
+	float r1 = r > 0 ? 1 / r : 0;
+	float p1r = r1 * cosf(w), p1i = -r1 * sinf(w);
+	float p2r = r1 * r1 * cosf(2 * w), p2i = -r1 * r1 * sinf(2 * w);
+	u[0][0] = (1 - p2r) + qi * p2i;
+	u[0][1] = -p2i + qi * (1 - p2r);
+	u[1][0] = p1r - qi * p1i;
+	u[1][1] = p1i + qi * p1r;
+	u[2][0] = p2r - qi * p2i;
+	u[2][1] = p2i + qi * p2r;
+      }
+      // Right at DC or Nyquist the resonator's zeros cancel it and u stays 0
+      for (int c = 0; c < CH; c++) {
+	float b0 = g_[c][i] * r;
+	m.q[c][0] = b0 * u[0][0];
+	m.q[c][1] = b0 * u[0][1];
+	q1_[i][c][0] = b0 * u[1][0];
+	q1_[i][c][1] = b0 * u[1][1];
+	q2_[i][c][0] = b0 * u[2][0];
+	q2_[i][c][1] = b0 * u[2][1];
+      }
+      Follow(i);
+    }
+
+    /*
+     * What a hop's input adds to a mode's state: sum of x[n] p^(OLA_HOP - 1 - n)
+     *   = p^(OLA_HOP - 1 - c) * sum of x[n] p^(c - n), c the middle of the hop
+     * The sum is the input spectrum at the mode's frequency with r^(c - n) ~ 1 + (c - n) ln r
+     * folded in through the spectrum's slope, both from a cubic Lagrange fit over the four
+     * nearest bins. Weights for those bins, times p^(OLA_HOP - 1 - c), go in the mode.
+     */
+    static void Interpolation(float bin, float damp, const float *e, ola_mode<CH> &m)
+    {
+      int k0 = (int)bin;
+      float t = bin - k0;
+      float t2 = t * t;
+      float c[4] = {
+	-t * (t - 1) * (t - 2) / 6,
+	(t + 1) * (t - 1) * (t - 2) / 2,
+	-(t + 1) * t * (t - 2) / 2,
+	(t + 1) * t * (t - 1) / 6,
+      };
+      float dc[4] = {
+	-(3 * t2 - 6 * t + 2) / 6,
+	(3 * t2 - 4 * t - 1) / 2,
+	-(3 * t2 - 2 * t - 2) / 2,
+	(3 * t2 - 1) / 6,
+      };
+      m.xk = (int16_t)(k0 - 1);
+      for (int j = 0; j < 4; j++) {
+	// sum (c - n) x[n] e^-jw(n - c) = -j dX/dw
+	float wr = c[j], wi = -damp * dc[j];
+	m.xw[j][0] = e[0] * wr - e[1] * wi;
+	m.xw[j][1] = e[0] * wi + e[1] * wr;
+      }
+    }
+
+    // The input following terms, for modes above the input filter only
+    void Follow(int i)
+    {
+      ola_mode<CH> &m = hot_[i];
+      bool above = f_[i] > ifc_;
+      for (int c = 0; c < CH; c++) {
+	m.q1[c][0] = above ? q1_[i][c][0] : 0;
+	m.q1[c][1] = above ? q1_[i][c][1] : 0;
+	m.q2[c][0] = above ? q2_[i][c][0] : 0;
+	m.q2[c][1] = above ? q2_[i][c][1] : 0;
+      }
+    }
+
+    void Hop()
+    {
+      // Advance every mode to the end of this hop, adding the hop's input
+      if (excited_) {
+	// Centred on the hop so the spectrum's phase turns slowly enough to interpolate
+	for (int i = 0; i < OLA_IN_LEN; i++) {
+	  pad_[i] = 0;
+	}
+	for (int n = 0; n < OLA_HOP; n++) {
+	  pad_[(n - OLA_HOP / 2 + OLA_IN_LEN) % OLA_IN_LEN] = in_[n];
+	}
+	arm_rfft_fast_f32(&fft_in_, pad_, in_spec_, 0);
+	Unpack();
+	for (int i = 0; i < n_modes_; i++) {
+	  ola_mode<CH> &m = hot_[i];
+	  const float *b = &xs_[2 * (m.xk + OLA_IN_GUARD)];
+	  float sr = m.ph[0] * m.s[0] - m.ph[1] * m.s[1];
+	  float si = m.ph[0] * m.s[1] + m.ph[1] * m.s[0];
+	  for (int j = 0; j < 4; j++) {
+	    sr += m.xw[j][0] * b[2 * j] - m.xw[j][1] * b[2 * j + 1];
+	    si += m.xw[j][0] * b[2 * j + 1] + m.xw[j][1] * b[2 * j];
+	  }
+	  m.s[0] = sr;
+	  m.s[1] = si;
+	}
+	excited_ = false;
+      } else {
+	for (int i = 0; i < n_modes_; i++) {
+	  ola_mode<CH> &m = hot_[i];
+	  float sr = m.ph[0] * m.s[0] - m.ph[1] * m.s[1];
+	  float si = m.ph[0] * m.s[1] + m.ph[1] * m.s[0];
+	  m.s[0] = sr;
+	  m.s[1] = si;
+	}
+      }
+
+      // A frame centred on the end of the hop
+      for (int c = 0; c < CH; c++) {
+	for (int i = 0; i < OLA_ACC_LEN; i++) {
+	  acc_[c][i] = 0;
+	}
+      }
+      float norm = n_modes_ > 0 ? 0.5f / n_modes_ : 0;
+      float x1 = in_[OLA_HOP - 2], x0 = in_[OLA_HOP - 1];
+      for (int i = 0; i < n_modes_; i++) {
+	const ola_mode<CH> &m = hot_[i];
+	for (int c = 0; c < CH; c++) {
+	  const float *q = m.q[c], *q1 = m.q1[c], *q2 = m.q2[c];
+	  float cr = (q[0] * m.s[0] - q[1] * m.s[1] + q1[0] * x1 + q2[0] * x0) * norm;
+	  float ci = (q[0] * m.s[1] + q[1] * m.s[0] + q1[1] * x1 + q2[1] * x0) * norm;
+	  float *a = &acc_[c][2 * (m.sk + OLA_KERNEL)];
+	  for (int j = 0; j < OLA_KERNEL_BINS; j++) {
+	    a[2 * j] += m.kw[j] * cr;
+	    a[2 * j + 1] += m.kw[j] * ci;
+	  }
+	}
+      }
+      for (int c = 0; c < CH; c++) {
+	Pack(acc_[c]);
+	arm_rfft_fast_f32(&fft_, spec_, frame_, 1);
+
+	// Without the (-1)^k a centred window comes out rotated by half a frame
+	for (int n = 0; n < OLA_HOP; n++) {
+	  out_[c][n] = tail_[c][n] + frame_[n + OLA_HOP];
+	  tail_[c][n] = frame_[n];
+	}
+      }
+    }
+
+    // Packed input spectrum to complex bins, with the guard bins either side by symmetry
+    void Unpack()
+    {
+      const int half = OLA_IN_LEN / 2;
+      float *x = &xs_[2 * OLA_IN_GUARD];
+      x[0] = in_spec_[0];
+      x[1] = 0;
+      x[2 * half] = in_spec_[1];
+      x[2 * half + 1] = 0;
+      for (int k = 1; k < half; k++) {
+	x[2 * k] = in_spec_[2 * k];
+	x[2 * k + 1] = in_spec_[2 * k + 1];
+      }
+      for (int k = 1; k <= OLA_IN_GUARD; k++) {
+	x[-2 * k] = x[2 * k];
+	x[-2 * k + 1] = -x[2 * k + 1];
+	x[2 * (half + k)] = x[2 * (half - k)];
+	x[2 * (half + k) + 1] = -x[2 * (half - k) + 1];
+      }
+    }
+
+    /*
+     * The modes' bins to the packed frame spectrum
+     * Bins past either end belong to the negative frequency images, they fold back conjugated.
+     * DC and Nyquist are real and get both a mode and its image.
+     */
+    void Pack(float *acc)
+    {
+      float *a = &acc[2 * OLA_KERNEL];
+      for (int k = 1; k <= OLA_KERNEL; k++) {
+	a[2 * k] += a[-2 * k];
+	a[2 * k + 1] -= a[-2 * k + 1];
+	a[2 * (OLA_HOP - k)] += a[2 * (OLA_HOP + k)];
+	a[2 * (OLA_HOP - k) + 1] -= a[2 * (OLA_HOP + k) + 1];
+      }
+      spec_[0] = 2 * a[0];
+      spec_[1] = 2 * a[2 * OLA_HOP];
+      for (int k = 1; k < OLA_HOP; k++) {
+	spec_[2 * k] = a[2 * k];
+	spec_[2 * k + 1] = a[2 * k + 1];
+      }
+    }
+
+    float Kernel(float delta) const
+    {
+      if (fabsf(delta) > OLA_KERNEL) return 0;
+      float x = fabsf(delta) * OLA_KERNEL_OS;
+      int i = (int)x;
+      float frac = x - i;
+      return kernel_[i] + frac * (kernel_[i + 1] - kernel_[i]);
+    }
+
+    int n_modes_ = 0, n_set_ = 0;
+    std::array<ola_mode<CH>, N> hot_;	// hot - walked once per hop
+    iir_1p_lp input_filt;
+    float offset_ = 0;
+
+    arm_rfft_fast_instance_f32 fft_, fft_in_;
+    float in_[OLA_HOP], out_[CH][OLA_HOP], tail_[CH][OLA_HOP];
+    float frame_[OLA_LEN], spec_[OLA_LEN];
+    float pad_[OLA_IN_LEN], in_spec_[OLA_IN_LEN];
+    float xs_[2 * (OLA_IN_LEN / 2 + 1 + 2 * OLA_IN_GUARD)];	// input spectrum, unpacked
+    float acc_[CH][OLA_ACC_LEN];		// frame spectra before packing
+    float kernel_[OLA_KERNEL_SIZE];
+    int pos_ = 0;
+    bool excited_ = false;
+
+    float fs_ = 48000, fc_ = 0, mgf_ = 0, ifc_ = 0;
+    std::array<float, N> modes_, res_, gains_[CH];	// cold - as loaded
+    std::array<float, N> f_, r_, g_[CH];		// cold - after fundamental and modulation
+    float q1_[N][CH][2], q2_[N][CH][2];
+};
+} // namespace daisysp
+#endif
+#endif
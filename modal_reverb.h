@@ -0,0 +1,101 @@
+#pragma once
+#ifndef DSY_MODAL_REVERB_H
+#define DSY_MODAL_REVERB_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arm_math.h"
+#include "modal_ola.h"
+#include "mode_set.h"
+#include "denormal.h"
+#ifdef __cplusplus
+
+// Most modes a reverb mode set can bring, larger sets are truncated
+#define REVERB_MAX_MODES  1024
+// Longest stretch processed in one pass, larger blocks are split
+#define REVERB_MAX_BLOCK  256
+// GM's reverb send controller
+#define CC_REVERB	  91
+#define REVERB_SEND_DEFAULT 0.0f
+
+namespace daisysp
+{
+/*
+ * modal_reverb
+ *
+ * A reverb send built from the same decaying modes as the voices, fitted to a room's
+ * impulse response by tools/fit_modes.py. The mono sum of the dry output is sent,
+ * the wet stereo return is added back in.
+ *
+ * Reverb sets run to thousands of modes, so they go through a stereo modal_ola:
+ * one state per mode, shared by both channels' gains, one hop of FFT work per 64 samples.
+ * The send isn't filtered, the modes see the whole band. The wet signal lags by OLA_HOP + 1
+ * samples, a pre-delay well under the room's own.
+ *
+ * Too big for DTCM, keep it in SRAM.
+ */
+class modal_reverb
+{
+  public:
+    void Init(float fs, const stereo_mode_set &set)
+    {
+      send_ = REVERB_SEND_DEFAULT;
+      ret_ = 1;
+      // The fundamental doesn't matter, reverb modes are all fixed frequencies
+      bank_.init(fs, 1, Left(set));
+      bank_.load_gains(1, set.gains_r);
+    }
+
+    // Swap rooms, the tail of the old one is dropped
+    void Load(const stereo_mode_set &set)
+    {
+      bank_.clear();
+      bank_.load_modes(Left(set));
+      bank_.load_gains(1, set.gains_r);
+    }
+
+    void SetSend(float send) { send_ = send; }
+    void SetReturn(float ret) { ret_ = ret; }
+    float Send() const { return send_; }
+
+    // Adds the wet return into l and r, in place
+    void Process(float *l, float *r, size_t size)
+    {
+#ifndef MODAL_KEEP_DENORMALS
+      denormal_guard ftz;
+#endif
+      for (size_t done = 0; done < size; done += REVERB_MAX_BLOCK) {
+	size_t n = size - done < REVERB_MAX_BLOCK ? size - done : REVERB_MAX_BLOCK;
+	float *wet[2] = {wet_l_, wet_r_};
+	for (size_t i = 0; i < n; i++) {
+	  send_bus_[i] = 0.5f * send_ * (l[done + i] + r[done + i]);
+	  wet_l_[i] = wet_r_[i] = 0;
+	}
+	bank_.AddFilteredBlock(send_bus_, wet, n);
+	for (size_t i = 0; i < n; i++) {
+	  l[done + i] += ret_ * wet_l_[i];
+	  r[done + i] += ret_ * wet_r_[i];
+	}
+      }
+    }
+
+    void clear() { bank_.clear(); }
+
+    int num_modes() const { return bank_.num_modes(); }
+
+  private:
+    static mode_set Left(const stereo_mode_set &set)
+    {
+      mode_set left = {set.num_modes, set.modes, set.res, set.gains_l};
+      return left;
+    }
+
+    modal_ola<REVERB_MAX_MODES, 2> bank_;
+    float send_ = REVERB_SEND_DEFAULT, ret_ = 1;
+
+    float send_bus_[REVERB_MAX_BLOCK];
+    float wet_l_[REVERB_MAX_BLOCK], wet_r_[REVERB_MAX_BLOCK];
+};
+} // namespace daisysp
+#endif
+#endif
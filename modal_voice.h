@@ -0,0 +1,216 @@
+#pragma once
+#ifndef DSY_MODAL_VOICE_H
+#define DSY_MODAL_VOICE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arm_math.h"
+#include "iir_reson.h"
+#include "iir_1p_lp.h"
+#include "denormal.h"
+#include "ir_cache.h"
+#ifdef MODAL_CMSIS_BIQUAD
+#include "reson_bank_cmsis.h"
+#endif
+#ifdef __cplusplus
+
+namespace daisysp
+{
+/*
+ * modal_voice
+ *
+ * What every modal voice does the same way with its M resonators, written once.
+ * V is the voice: it keeps hot_, side_, input_hist_, input_filt, n_modes_ (and cmsis_ with
+ * MODAL_CMSIS_BIQUAD) itself, so its layout is its own, and makes modal_voice a friend.
+ * V::state_changed is called whenever the modes' state is rewritten here, and the CMSIS
+ * block path divides the summed modes by V::divisor as the voice's own loop does
+ */
+template <typename V, int M>
+class modal_voice
+{
+  public:
+    // Block versions add the voice's output into out
+    // With MODAL_CMSIS_BIQUAD the modes run through CMSIS-DSP instead of reson_process
+    void AddBlock(const float *in, float *out, size_t size)
+    {
+      V &v = self();
+#ifdef MODAL_CMSIS_BIQUAD
+      float in_filt[CMSIS_BANK_BLOCK];
+      for (size_t done = 0; done < size; done += CMSIS_BANK_BLOCK) {
+	size_t n = size - done < CMSIS_BANK_BLOCK ? size - done : CMSIS_BANK_BLOCK;
+	v.input_filt.ProcessBlock(in + done, in_filt, n);
+	v.cmsis_.AddBlock(v.hot_.data(), in_filt, out + done, n, v.divisor());
+      }
+#else
+      for (size_t i = 0; i < size; i++) {
+	out[i] += v.Process(in[i]);
+      }
+#endif
+    }
+
+    void AddFilteredBlock(const float *in_filt, float *out, size_t size)
+    {
+      V &v = self();
+#ifdef MODAL_CMSIS_BIQUAD
+      v.cmsis_.AddBlock(v.hot_.data(), in_filt, out, size, v.divisor());
+#else
+      for (size_t i = 0; i < size; i++) {
+	out[i] += v.ProcessFiltered(in_filt[i]);
+      }
+#endif
+    }
+
+    // Stereo versions, side receives the modes weighted by their side gains. side null is the mono version
+    void AddBlock(const float *in, float *out, float *side, size_t size)
+    {
+      if (!side) {
+	AddBlock(in, out, size);
+	return;
+      }
+      V &v = self();
+#ifdef MODAL_CMSIS_BIQUAD
+      float in_filt[CMSIS_BANK_BLOCK];
+      for (size_t done = 0; done < size; done += CMSIS_BANK_BLOCK) {
+	size_t n = size - done < CMSIS_BANK_BLOCK ? size - done : CMSIS_BANK_BLOCK;
+	v.input_filt.ProcessBlock(in + done, in_filt, n);
+	v.cmsis_.AddBlock(v.hot_.data(), v.side_.data(), in_filt, out + done, side + done, n, v.divisor());
+      }
+#else
+      for (size_t i = 0; i < size; i++) {
+	float s;
+	out[i] += v.Process(in[i], s);
+	side[i] += s;
+      }
+#endif
+    }
+
+    void AddFilteredBlock(const float *in_filt, float *out, float *side, size_t size)
+    {
+      if (!side) {
+	AddFilteredBlock(in_filt, out, size);
+	return;
+      }
+      V &v = self();
+#ifdef MODAL_CMSIS_BIQUAD
+      v.cmsis_.AddBlock(v.hot_.data(), v.side_.data(), in_filt, out, side, size, v.divisor());
+#else
+      for (size_t i = 0; i < size; i++) {
+	float s;
+	out[i] += v.ProcessFiltered(in_filt[i], s);
+	side[i] += s;
+      }
+#endif
+    }
+
+    // Just the input filter, for feeding AddFilteredBlock with something added after it
+    void FilterBlock(const float *in, float *in_filt, size_t size)
+    {
+      V &v = self();
+      for (size_t i = 0; i < size; i++) {
+	in_filt[i] = v.input_filt.Process(in[i] + v.input_hist_.offset);
+      }
+    }
+
+    // Stop ringing, for when the voice has been rendered by something else for a while
+    void clear()
+    {
+      V &v = self();
+      for (int i = 0; i < M; i++) {
+	v.hot_[i].yn[0] = v.hot_[i].yn[1] = 0;
+      }
+      v.input_hist_.Reset();
+      v.state_changed();
+#ifdef MODAL_CMSIS_BIQUAD
+      v.cmsis_.Reset();
+#endif
+    }
+
+    // Constant added to every mode's input, 0 or DENORMAL_OFFSET
+    void set_denormal_offset(float offset)
+    {
+      self().input_hist_.offset = offset;
+    }
+
+    // Filter state currently in the subnormal range - for debugging long tails
+    int count_subnormal() const
+    {
+      const V &v = self();
+      int count = 0;
+      for (int i = 0; i < M; i++) {
+	count += is_subnormal(v.hot_[i].yn[0]) + is_subnormal(v.hot_[i].yn[1]);
+      }
+      count += is_subnormal(v.input_hist_.xn[0]) + is_subnormal(v.input_hist_.xn[1]);
+      return count;
+    }
+
+    /*
+     * The voice's coefficients for ir_cache, with the largest mode gain divided out
+     * so the same voice at another velocity has the same key.
+     * Returns the gain divided out, 0 if the voice can't be cached
+     */
+    float save_coefs(ir_key &key) const
+    {
+      const V &v = self();
+      int n_modes = v.n_modes_;
+      float ref = 0;
+      for (int i = 0; i < n_modes; i++) {
+	ref = fmaxf(ref, fabsf(v.hot_[i].b0));
+      }
+      if (ref == 0 || n_modes > IR_CACHE_MAX_MODES) return 0;
+      key.len = 4 + 3 * n_modes;
+      key.c[0] = n_modes;
+      v.input_filt.get_coefs(&key.c[1]);
+      for (int i = 0; i < n_modes; i++) {
+	float *c = &key.c[4 + 3 * i];
+	c[0] = v.hot_[i].a[0];
+	c[1] = v.hot_[i].a[1];
+	c[2] = ir_quantize(v.hot_[i].b0 / ref);
+      }
+      key.Hash();
+      return ref;
+    }
+
+    /*
+     * Take over from a cached response, state is from ir_cache::StateAt for n modes.
+     * The input side is scaled by the ping, the modes by the ping and the gain save_coefs returned
+     */
+    void load_state(const float *state, int n, float in_scale, float out_scale)
+    {
+      V &v = self();
+      v.input_filt.set_state(state[0] * in_scale, state[1] * in_scale);
+      v.input_hist_.xn[0] = state[2] * in_scale;
+      v.input_hist_.xn[1] = state[3] * in_scale;
+      for (int i = 0; i < M; i++) {
+	// Modes silenced since the response was rendered stay silent
+	bool on = i < n && i < v.n_modes_;
+	v.hot_[i].yn[0] = on ? state[4 + 2 * i] * out_scale : 0;
+	v.hot_[i].yn[1] = on ? state[5 + 2 * i] * out_scale : 0;
+#ifdef MODAL_CMSIS_BIQUAD
+	v.cmsis_.SetState(i, v.input_hist_.xn[0], v.input_hist_.xn[1], v.hot_[i].yn[0], v.hot_[i].yn[1]);
+#endif
+      }
+      v.state_changed();
+    }
+
+    // Everything the voice remembers is below floor, a ping now sounds like its impulse response
+    bool at_rest(float floor) const
+    {
+      const V &v = self();
+      if (fabsf(v.input_filt.xn()) >= floor || fabsf(v.input_filt.yn()) >= floor) return false;
+      if (fabsf(v.input_hist_.xn[0]) >= floor || fabsf(v.input_hist_.xn[1]) >= floor) return false;
+      for (int i = 0; i < M; i++) {
+	if (fabsf(v.hot_[i].yn[0]) >= floor || fabsf(v.hot_[i].yn[1]) >= floor) return false;
+      }
+#ifdef MODAL_CMSIS_BIQUAD
+      if (!v.cmsis_.AtRest(floor)) return false;
+#endif
+      return true;
+    }
+
+  private:
+    V &self() { return static_cast<V &>(*this); }
+    const V &self() const { return static_cast<const V &>(*this); }
+};
+} // namespace daisysp
+#endif
+#endif
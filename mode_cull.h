@@ -0,0 +1,197 @@
+#pragma once
+#ifndef DSY_MODE_CULL_H
+#define DSY_MODE_CULL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arm_math.h"
+#include "iir_reson.h"
+#ifdef __cplusplus
+
+// Length of a mode's fade in or out when the budget changes which modes run
+#define CULL_FADE_SAMPLES 256
+// Modes already running rank this much higher, so near ties don't swap back and forth
+#define CULL_HYSTERESIS	  1.25f
+// Unstable radii are scored as this instead
+#define CULL_RES_LIMIT	  0.999999f
+
+namespace daisysp
+{
+/*
+ * mode_cull
+ *
+ * Keeps only the budget most audible of a voice's N modes running.
+ * Modes are ranked by (impulse amplitude x decay x loudness weighting):
+ *   g r / sqrt(1 - r^2) scaled by the A-weighting curve at the mode's frequency.
+ * Modes entering or leaving the set are faded over CULL_FADE_SAMPLES,
+ * a mode that has faded out is cleared, not processed at all and restarts from rest.
+ * The voice calls MarkDirty whenever its coefficients change and Update before processing.
+ */
+template <int N>
+class mode_cull
+{
+  public:
+    void Init(float fs)
+    {
+      fs_ = fs;
+      budget_ = N;
+      // Everything runs until the first budget is set, as in the voice's plain loop
+      n_steady_ = N;
+      n_fading_ = 0;
+      for (int i = 0; i < N; i++) {
+	state_[i] = ON;
+	w_[i] = 1;
+	step_[i] = 0;
+	left_[i] = 0;
+	steady_[i] = i;
+      }
+      dirty_ = true;
+    }
+
+    void SetBudget(int k)
+    {
+      k = k < 0 ? 0 : (k > N ? N : k);
+      if (k != budget_) {
+	budget_ = k;
+	dirty_ = true;
+      }
+    }
+
+    int Budget() const { return budget_; }
+
+    // Modes being processed, including the ones fading
+    int Running() const { return n_steady_ + n_fading_; }
+
+    // With the whole budget and nothing fading the voice runs its plain loop
+    bool Active() const { return budget_ < N || n_fading_ > 0; }
+
+    void MarkDirty() { dirty_ = true; }
+    bool Dirty() const { return dirty_; }
+
+    // Re-rank and start any fades
+    void Update(const iir_reson *modes, reson_hot *hot, int n_modes)
+    {
+      dirty_ = false;
+      if (budget_ >= N && n_steady_ == N) return;
+
+      float score[N];
+      for (int i = 0; i < N; i++) {
+	score[i] = i < n_modes ? Score(modes[i]) : 0;
+	if (state_[i] == ON || state_[i] == FADE_IN) score[i] *= CULL_HYSTERESIS;
+      }
+
+      // Top budget_ by insertion, N is small
+      int top[N];
+      int n_top = 0;
+      for (int i = 0; i < N; i++) {
+	if (score[i] <= 0) continue;
+	int pos = n_top;
+	while (pos > 0 && score[top[pos - 1]] < score[i]) pos--;
+	if (pos >= budget_) continue;
+	if (n_top < budget_) n_top++;
+	for (int j = n_top - 1; j > pos; j--) top[j] = top[j - 1];
+	top[pos] = i;
+      }
+
+      // A full budget brings everything back so the voice can return to its plain loop
+      bool want[N] = {};
+      for (int j = 0; j < n_top; j++) {
+	want[top[j]] = true;
+      }
+      if (budget_ >= N) {
+	for (int i = 0; i < N; i++) want[i] = true;
+      }
+
+      n_steady_ = n_fading_ = 0;
+      for (int i = 0; i < N; i++) {
+	if (want[i]) {
+	  if (state_[i] == OFF || state_[i] == FADE_OUT) {
+	    StartFade(i, FADE_IN, 1.0f / CULL_FADE_SAMPLES);
+	  }
+	} else if (state_[i] == ON || state_[i] == FADE_IN) {
+	  StartFade(i, FADE_OUT, -1.0f / CULL_FADE_SAMPLES);
+	}
+
+	if (state_[i] == ON) {
+	  steady_[n_steady_++] = i;
+	} else if (state_[i] != OFF) {
+	  fading_[n_fading_++] = i;
+	}
+      }
+    }
+
+    // d is x[n] - x[n-2], scaled the same way as the voice's plain loop
+    float Process(reson_hot *hot, float d, int n_modes)
+    {
+      float out = 0;
+      for (int k = 0; k < n_steady_; k++) {
+	out += reson_process(hot[steady_[k]], d) / n_modes;
+      }
+      // Backwards so finished fades can be swapped out in place
+      for (int k = n_fading_ - 1; k >= 0; k--) {
+	int i = fading_[k];
+	out += reson_process(hot[i], d) * w_[i] / n_modes;
+	w_[i] += step_[i];
+	if (--left_[i] == 0) {
+	  fading_[k] = fading_[--n_fading_];
+	  if (state_[i] == FADE_IN) {
+	    w_[i] = 1;
+	    state_[i] = ON;
+	    steady_[n_steady_++] = i;
+	  } else {
+	    w_[i] = 0;
+	    state_[i] = OFF;
+	    hot[i].yn[0] = hot[i].yn[1] = 0;
+	  }
+	}
+      }
+      return out;
+    }
+
+  private:
+    enum { OFF = 0, FADE_IN, ON, FADE_OUT };
+
+    void StartFade(int i, uint8_t state, float step)
+    {
+      state_[i] = state;
+      step_[i] = step;
+      // From wherever the weight is now
+      float dist = state == FADE_IN ? 1 - w_[i] : w_[i];
+      left_[i] = (int)ceilf(dist * CULL_FADE_SAMPLES);
+      if (left_[i] < 1) left_[i] = 1;
+    }
+
+    float Score(const iir_reson &m)
+    {
+      float r = fabsf(m.r());
+      if (r >= 1) r = CULL_RES_LIMIT;
+      float f = m.fc();
+      if (f <= 0 || f >= fs_ / 2) return 0;
+      return fabsf(m.g()) * r / sqrtf(1 - r * r) * AWeight(f);
+    }
+
+    // IEC 61672 A-weighting, linear gain normalised to 1 at 1kHz
+    static float AWeight(float f)
+    {
+      float f2 = f * f;
+      float num = 12194.0f * 12194.0f * f2 * f2;
+      float den = (f2 + 20.6f * 20.6f)
+		  * sqrtf((f2 + 107.7f * 107.7f) * (f2 + 737.9f * 737.9f))
+		  * (f2 + 12194.0f * 12194.0f);
+      return 1.2589f * num / den;
+    }
+
+    float fs_;
+    int budget_ = N;
+    bool dirty_ = true;
+
+    uint8_t state_[N];
+    float w_[N], step_[N];
+    int left_[N];
+
+    uint8_t steady_[N], fading_[N];
+    int n_steady_ = 0, n_fading_ = 0;
+};
+} // namespace daisysp
+#endif
+#endif
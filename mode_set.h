@@ -0,0 +1,35 @@
+#pragma once
+#ifndef DSY_MODE_SET_H
+#define DSY_MODE_SET_H
+
+#include "inharm_presets.h"
+#ifdef __cplusplus
+
+/*
+ * A set of modes in the inharm_preset layout, but of any length and held by pointer
+ * so large tables can live in flash or SDRAM.
+ * modes[i] > 0 is a multiple of the fundamental, modes[i] < 0 a fixed frequency in Hz.
+ */
+typedef struct {
+  int num_modes;
+  const float *modes;
+  const float *res;
+  const float *gains;
+} mode_set;
+
+// Two channels of gains over the same modes, for stereo sets such as fitted reverbs
+typedef struct {
+  int num_modes;
+  const float *modes;
+  const float *res;
+  const float *gains_l;
+  const float *gains_r;
+} stereo_mode_set;
+
+inline mode_set preset_modes(const inharm_preset *preset)
+{
+  mode_set set = {preset->num_modes, preset->modes, preset->res, preset->gains};
+  return set;
+}
+#endif
+#endif
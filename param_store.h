@@ -0,0 +1,80 @@
+#pragma once
+#ifndef DSY_PARAM_STORE_H
+#define DSY_PARAM_STORE_H
+
+#include <stdint.h>
+#include <atomic>
+#ifdef __cplusplus
+
+namespace daisysp
+{
+// The engine's continuous parameters, in their own units
+typedef enum {
+  PARAM_G = 0,		// gain, or the inharmonic gain modulation
+  PARAM_OUT,		// output stage, a ui_output_mode, whole numbers
+  PARAM_STIFF,
+  PARAM_BETA,		// whole numbers
+  PARAM_IFC,
+  PARAM_MGF,
+  PARAM_AT,
+  PARAM_DT,
+  PARAM_RES,		// CC 1, 0 to 1: resonance, or the inharmonic resonance modulation
+  PARAM_LFO_IFC_RATE,
+  PARAM_LFO_IFC_DEPTH,
+  PARAM_LFO_STIFF_RATE,
+  PARAM_LFO_STIFF_DEPTH,
+  PARAM_LFO_BETA_RATE,
+  PARAM_LFO_BETA_DEPTH,
+  NUM_PARAMS
+} param_id;
+
+#define PARAM_BIT(id) (1u << (id))
+
+/*
+ * param_store
+ *
+ * One value per parameter and one dirty bit each. The control side (main loop, MIDI, a host
+ * thread) sets values as often as it likes, each Set stores the value and publishes its bit.
+ * The audio side takes the whole mask once per block and only works on the parameters set
+ * since, reading the last value each was given however many times it was set in between.
+ * A value set while the audio side is reading is either seen now or flagged for next block,
+ * never lost.
+ */
+class param_store
+{
+  static_assert(NUM_PARAMS <= 32, "the dirty mask is 32 bits");
+
+  public:
+    // Values without dirty bits, the voices already start there
+    void Init(const float *values)
+    {
+      for (int i = 0; i < NUM_PARAMS; i++) {
+	values_[i].store(values[i], std::memory_order_relaxed);
+      }
+      dirty_.store(0, std::memory_order_release);
+    }
+
+    // Control side
+    void Set(param_id id, float val)
+    {
+      values_[id].store(val, std::memory_order_relaxed);
+      dirty_.fetch_or(PARAM_BIT(id), std::memory_order_release);
+    }
+
+    // Audio side, the bits set since the last Take
+    uint32_t Take()
+    {
+      if (dirty_.load(std::memory_order_relaxed) == 0) return 0;
+      return dirty_.exchange(0, std::memory_order_acquire);
+    }
+
+    // Either side
+    float Get(param_id id) const { return values_[id].load(std::memory_order_relaxed); }
+
+  private:
+    std::atomic<float> values_[NUM_PARAMS];
+    std::atomic<uint32_t> dirty_{0};
+};
+} // namespace daisysp
+#endif
+#endif
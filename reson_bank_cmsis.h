@@ -0,0 +1,126 @@
+#pragma once
+#ifndef DSY_RESON_BANK_CMSIS_H
+#define DSY_RESON_BANK_CMSIS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arm_math.h"
+#include "iir_reson.h"
+#ifdef __cplusplus
+
+// Samples run through the CMSIS kernels per call
+#define CMSIS_BANK_BLOCK 64
+
+namespace daisysp
+{
+/*
+ * reson_bank_cmsis
+ *
+ * Runs a voice's N resonators through CMSIS-DSP's arm_biquad_cascade_df1_f32, block at a time.
+ * The modes are in parallel, not in series: each is a one stage cascade fed the same input
+ * and the outputs are summed.
+ * Coefficients are taken from the voice's reson_hots at the start of every block,
+ * the filter history lives here, so a voice using the bank must not also run its per-sample path.
+ */
+template <int N>
+class reson_bank_cmsis
+{
+  public:
+    reson_bank_cmsis()
+    {
+      for (int i = 0; i < N; i++) {
+	arm_biquad_cascade_df1_init_f32(&inst_[i], 1, coefs_[i], state_[i]);
+      }
+    }
+    reson_bank_cmsis(const reson_bank_cmsis &) = delete;
+    reson_bank_cmsis &operator=(const reson_bank_cmsis &) = delete;
+
+    // Clears the history of modes first..N-1
+    void Reset(int first = 0)
+    {
+      for (int i = first; i < N; i++) {
+	state_[i][0] = state_[i][1] = state_[i][2] = state_[i][3] = 0;
+      }
+    }
+
+    // Mode i's history as arm_biquad_cascade_df1_f32 keeps it
+    void SetState(int i, float x1, float x2, float y1, float y2)
+    {
+      state_[i][0] = x1;
+      state_[i][1] = x2;
+      state_[i][2] = y1;
+      state_[i][3] = y2;
+    }
+
+    // Every mode's history is below floor
+    bool AtRest(float floor) const
+    {
+      for (int i = 0; i < N; i++) {
+	for (int j = 0; j < 4; j++) {
+	  if (fabsf(state_[i][j]) >= floor) return false;
+	}
+      }
+      return true;
+    }
+
+    // out += sum of every mode / n_modes
+    void AddBlock(const reson_hot *hot, const float *in, float *out, size_t size, int n_modes)
+    {
+      if (n_modes == 0) return;
+
+      LoadCoefs(hot);
+
+      for (size_t done = 0; done < size; done += CMSIS_BANK_BLOCK) {
+	size_t n = size - done < CMSIS_BANK_BLOCK ? size - done : CMSIS_BANK_BLOCK;
+	for (int i = 0; i < N; i++) {
+	  // Older CMSIS releases take a non-const source
+	  arm_biquad_cascade_df1_f32(&inst_[i], (float32_t *)in + done, tmp_, n);
+	  for (size_t j = 0; j < n; j++) {
+	    out[done + j] += tmp_[j] / n_modes;
+	  }
+	}
+      }
+    }
+
+    // Stereo, side also gets every mode weighted by its side gain / n_modes
+    void AddBlock(const reson_hot *hot, const float *gains, const float *in, float *out, float *side,
+		  size_t size, int n_modes)
+    {
+      if (n_modes == 0) return;
+
+      LoadCoefs(hot);
+      float norm = 1.0f / n_modes;
+      for (size_t done = 0; done < size; done += CMSIS_BANK_BLOCK) {
+	size_t n = size - done < CMSIS_BANK_BLOCK ? size - done : CMSIS_BANK_BLOCK;
+	for (int i = 0; i < N; i++) {
+	  arm_biquad_cascade_df1_f32(&inst_[i], (float32_t *)in + done, tmp_, n);
+	  float g = gains[i] * norm;
+	  for (size_t j = 0; j < n; j++) {
+	    out[done + j] += tmp_[j] * norm;
+	    side[done + j] += tmp_[j] * g;
+	  }
+	}
+      }
+    }
+
+  private:
+    void LoadCoefs(const reson_hot *hot)
+    {
+      for (int i = 0; i < N; i++) {
+	coefs_[i][0] = hot[i].b0;
+	coefs_[i][1] = 0;
+	coefs_[i][2] = -hot[i].b0;
+	coefs_[i][3] = -hot[i].a[0];
+	coefs_[i][4] = -hot[i].a[1];
+      }
+    }
+
+  private:
+    arm_biquad_casd_df1_inst_f32 inst_[N];
+    float32_t coefs_[N][5];
+    float32_t state_[N][4];
+    float32_t tmp_[CMSIS_BANK_BLOCK];
+};
+} // namespace daisysp
+#endif
+#endif
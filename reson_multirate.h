@@ -0,0 +1,372 @@
+#pragma once
+#ifndef DSY_RESON_MULTIRATE_H
+#define DSY_RESON_MULTIRATE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arm_math.h"
+#include "iir_reson.h"
+#ifdef __cplusplus
+
+// Rate tiers fs, fs/2 ... fs/2^(MR_TIERS-1)
+#define MR_TIERS 5
+// A mode moves down to a tier when its frequency is below this fraction of the tier's rate
+#define MR_PASS	 0.15f
+// and stays there until it goes above this one
+#define MR_KEEP	 0.18f
+// Halfband length, see HalfbandDecimate
+#define MR_HB_LEN 11
+// Interpolator history
+#define MR_Z_LEN 6
+// A decimate and interpolate round trip delays by this many samples of the upper tier's rate
+#define MR_ALIGN 10
+// of which the decimator's share
+#define MR_DEC	 (MR_ALIGN / 2)
+// Room for every tier's alignment delay, sum of MR_ALIGN * (2^(MR_TIERS - 1 - k) - 1)
+#define MR_ALIGN_TOTAL (MR_ALIGN * ((1 << MR_TIERS) - 1 - MR_TIERS))
+// The voice's lag, the deepest tier's round trip
+#define MR_LATENCY (MR_ALIGN * ((1 << (MR_TIERS - 1)) - 1))
+// A mode changing tier crossfades from its old tier to its new one over this many samples
+#define MR_FADE	 256
+// The old tier is dropped early if the mode goes above this fraction of its rate
+#define MR_FADE_LIMIT 0.4f
+// No crossfade
+#define MR_NONE	 0xff
+
+namespace daisysp
+{
+/*
+ * reson_multirate
+ *
+ * Runs each of a voice's modes at the lowest sample rate that still carries it.
+ * The input is decimated by 2 per tier, every tier's modes run on their own x[n] - x[n-2],
+ * and the tiers are summed bottom up through polyphase halfband interpolators.
+ * A mode at tier k (D = 2^k) uses r^D and wc*D, and b0 scaled by (1 - r^D) / (1 - r)
+ * so its peak gain, and so its level and decay time, match the full rate resonator.
+ *
+ * The remapped coefficients are written over the voice's own reson_hots,
+ * the voice calls MarkDirty whenever its iir_resons change them and Update before processing.
+ * Each tier's own modes are delayed to line up with what comes up from below as if the voice
+ * went down to the deepest tier, MR_ALIGN * (2^(MR_TIERS - 1 - k) - 1) of tier k's samples,
+ * so the voice as a whole always lags by 150 samples, wherever its modes are.
+ *
+ * A mode that changes tier (a bend, an LFO or pressure moving it across a boundary) keeps ringing:
+ * its state is restated at the new tier's rate and timing, and a copy carries on at the old tier
+ * while the two crossfade over MR_FADE samples, the way mode_cull fades modes.
+ */
+template <int N>
+class reson_multirate
+{
+  public:
+    void Init(float fs)
+    {
+      fs_ = fs;
+      enabled_ = false;
+      dirty_ = true;
+      t_ = 0;
+      deepest_ = 0;
+      n_fading_ = 0;
+      for (int i = 0; i < N; i++) {
+	tier_[i] = 0;
+	ghost_tier_[i] = MR_NONE;
+      }
+      for (int k = 0; k < MR_TIERS; k++) {
+	count_[k] = 0;
+	Reset(tiers_[k]);
+      }
+      Realign();
+    }
+
+    // Turning it off puts every mode back on its full rate coefficients
+    void SetEnabled(bool on, iir_reson *modes)
+    {
+      if (on == enabled_) return;
+      enabled_ = on;
+      dirty_ = true;
+      if (!on) {
+	n_fading_ = 0;
+	for (int i = 0; i < N; i++) {
+	  tier_[i] = 0;
+	  ghost_tier_[i] = MR_NONE;
+	  modes[i].refresh();
+	}
+      }
+    }
+
+    bool Enabled() const { return enabled_; }
+    void MarkDirty() { dirty_ = true; }
+    bool Dirty() const { return dirty_; }
+
+    // Modes settled at each tier, for benchmarks and debugging
+    int Count(int tier) const { return count_[tier]; }
+
+    // Modes crossfading between tiers
+    int Fading() const { return n_fading_; }
+
+    // Reassign tiers and remap coefficients
+    void Update(iir_reson *modes, reson_hot *hot, int n_modes)
+    {
+      dirty_ = false;
+      for (int k = 0; k < MR_TIERS; k++) {
+	count_[k] = 0;
+      }
+      int was_deepest = deepest_;
+      deepest_ = 0;
+      n_fading_ = 0;
+      fade_end_ = t_ + MR_FADE + MR_LATENCY;
+
+      for (int i = 0; i < n_modes; i++) {
+	float fc = modes[i].fc();
+	int k = 0;
+	while (k + 1 < MR_TIERS && fc < MR_PASS * fs_ / (2 << k)) k++;
+	if (tier_[i] > k && fc < MR_KEEP * fs_ / (1 << tier_[i])) k = tier_[i];
+
+	int g = ghost_tier_[i];
+	// The old tier keeps going until what it has in flight is out
+	if (g != MR_NONE && (t_ - fade_start_[i] >= MR_FADE + MR_LATENCY || fc >= MR_FADE_LIMIT * fs_ / (1 << g))) {
+	  g = MR_NONE;
+	}
+	if (k != tier_[i]) {
+	  // The old tier rings on as the ghost, replacing any ghost from an earlier move
+	  if (hot[i].yn[0] != 0 || hot[i].yn[1] != 0) {
+	    g = tier_[i];
+	    ghost_[i].yn[0] = hot[i].yn[0];
+	    ghost_[i].yn[1] = hot[i].yn[1];
+	    fade_start_[i] = t_;
+	  }
+	  Carry(modes[i], hot[i], tier_[i], k);
+	  tier_[i] = k;
+	}
+	ghost_tier_[i] = g;
+
+	if (k == 0) {
+	  modes[i].refresh();
+	} else {
+	  Remap(modes[i], hot[i], 1 << k);
+	}
+	if (k > deepest_) deepest_ = k;
+	if (g == MR_NONE) {
+	  idx_[k][count_[k]++] = i;
+	  continue;
+	}
+	Remap(modes[i], ghost_[i], 1 << g);
+	fading_[n_fading_++] = i;
+	if (g > deepest_) deepest_ = g;
+	if ((int32_t)(fade_start_[i] + MR_FADE + MR_LATENCY - fade_end_) < 0) {
+	  fade_end_ = fade_start_[i] + MR_FADE + MR_LATENCY;
+	}
+      }
+      for (int i = n_modes; i < N; i++) {
+	ghost_tier_[i] = MR_NONE;
+      }
+      // Tiers that have been idle start again from silence
+      if (deepest_ > was_deepest) {
+	Reset(tiers_[was_deepest], false);
+	for (int k = was_deepest + 1; k <= deepest_; k++) {
+	  Reset(tiers_[k]);
+	  for (int j = 0; j < tiers_[k].align_len; j++) {
+	    align_[tiers_[k].align_base + j] = 0;
+	  }
+	}
+      }
+    }
+
+    // x is the voice's filtered input, d its x[n] - x[n-2]
+    float Process(reson_hot *hot, float x, float d, int n_modes)
+    {
+      t_++;
+      // Tiers 0..ticking-1 take a sample this time
+      int ticking = 1;
+      while (ticking <= deepest_ && Ticks(ticking)) ticking++;
+
+      // Down: each tier takes a sample when the one above has two
+      float xin = x;
+      for (int k = 0; k < deepest_ && k < ticking; k++) {
+	tier_state &t = tiers_[k];
+	Push(t.dec, t.dec_pos, MR_HB_LEN, xin);
+	if (k + 1 < ticking) {
+	  xin = HalfbandDecimate(&t.dec[t.dec_pos]);
+	  tiers_[k + 1].x = xin;
+	}
+      }
+
+      // Up: sum each ticking tier's modes with what's interpolated from below
+      float norm = 1.0f / n_modes;
+      float out = 0;
+      for (int k = ticking - 1; k >= 0; k--) {
+	tier_state &t = tiers_[k];
+	float dk = k == 0 ? d : t.diff.Process(t.x);
+	float own = 0;
+	const uint8_t *idx = idx_[k];
+	for (int j = 0; j < count_[k]; j++) {
+	  own += reson_process(hot[idx[j]], dk);
+	}
+	// The fade is timed by the input each tier's outputs answer, so the tiers agree on it
+	uint32_t now = t_ - MR_DEC * ((1 << k) - 1);
+	for (int j = 0; j < n_fading_; j++) {
+	  int i = fading_[j];
+	  int32_t since = now - fade_start_[i];
+	  float w = since <= 0 ? 0 : (since >= MR_FADE ? 1 : since * (1.0f / MR_FADE));
+	  if (tier_[i] == k) own += w * reson_process(hot[i], dk);
+	  if (ghost_tier_[i] == k) own += (1 - w) * reson_process(ghost_[i], dk);
+	}
+	own *= norm;
+	float z = own;
+	if (k < MR_TIERS - 1) {
+	  float *align = &align_[t.align_base];
+	  z = align[t.align_pos];
+	  if (k < deepest_) {
+	    z += Interpolate(&tiers_[k + 1].z[tiers_[k + 1].z_pos], k + 1 < ticking);
+	  }
+	  align[t.align_pos] = own;
+	  if (++t.align_pos == t.align_len) t.align_pos = 0;
+	}
+	if (k == 0) {
+	  out = z;
+	} else {
+	  Push(t.z, t.z_pos, MR_Z_LEN, z);
+	}
+      }
+      // Settle the finished crossfades
+      if (n_fading_ > 0 && (int32_t)(t_ - fade_end_) >= 0) {
+	dirty_ = true;
+      }
+      return out;
+    }
+
+  private:
+    struct tier_state
+    {
+      // Histories are written twice, len apart, so buf[pos..pos+len-1] is always newest first
+      float dec[2 * MR_HB_LEN];	// this tier's input, feeding the next tier down
+      float z[2 * MR_Z_LEN];	// this tier's output including everything below
+      int dec_pos, z_pos;
+      int align_base, align_len, align_pos;	// this tier's own modes wait in align_ for the tiers below
+      reson_input diff;
+      float x;			// latest decimated input
+    };
+
+    // Every tier lines up with the deepest, so the delays never change while the voice plays
+    void Realign()
+    {
+      int base = 0;
+      for (int k = 0; k < MR_TIERS; k++) {
+	tier_state &t = tiers_[k];
+	t.align_base = base;
+	t.align_len = MR_ALIGN * ((1 << (MR_TIERS - 1 - k)) - 1);
+	t.align_pos = 0;
+	base += t.align_len;
+      }
+      for (int j = 0; j < MR_ALIGN_TOTAL; j++) {
+	align_[j] = 0;
+      }
+    }
+
+    // Histories only, the alignment delays are left as they are
+    static void Reset(tier_state &t, bool all = true)
+    {
+      for (int j = 0; j < 2 * MR_HB_LEN; j++) t.dec[j] = 0;
+      t.dec_pos = 0;
+      if (!all) return;
+      for (int j = 0; j < 2 * MR_Z_LEN; j++) t.z[j] = 0;
+      t.z_pos = 0;
+      t.diff.Reset();
+      t.x = 0;
+    }
+
+    /*
+     * A mode's last two outputs at tier from restated as its last two at tier to.
+     * Its ringing is taken as free, y(m) = r^m (c cos(wm) - s sin(wm)) over full rate samples,
+     * and each tier's last output is timed by its last tick less its decimation delay
+     */
+    void Carry(const iir_reson &m, reson_hot &h, int from, int to)
+    {
+      double r = m.r();
+      if (r <= 0) {
+	h.yn[0] = h.yn[1] = 0;
+	return;
+      }
+      int d_from = 1 << from, d_to = 1 << to;
+      double w = 2 * (double)PI * m.fc() / fs_;
+      double c = h.yn[0];
+      double sn = sin(w * d_from);
+      double s = fabs(sn) > 1e-9 ? (h.yn[1] * pow(r, d_from) - c * cos(w * d_from)) / sn : 0;
+      int since_from = (t_ & (d_from - 1)) + MR_DEC * (d_from - 1);
+      int since_to = (t_ & (d_to - 1)) + MR_DEC * (d_to - 1);
+      double m0 = since_from - since_to;
+      double m1 = m0 - d_to;
+      h.yn[0] = pow(r, m0) * (c * cos(w * m0) - s * sin(w * m0));
+      h.yn[1] = pow(r, m1) * (c * cos(w * m1) - s * sin(w * m1));
+    }
+
+    static void Push(float *buf, int &pos, int len, float v)
+    {
+      pos = pos == 0 ? len - 1 : pos - 1;
+      buf[pos] = v;
+      buf[pos + len] = v;
+    }
+
+    bool Ticks(int k) const
+    {
+      return (t_ & ((1u << k) - 1)) == 0;
+    }
+
+    /*
+     * 11 tap halfband, [3 0 -25 0 150 256 150 0 -25 0 3] / 256
+     * About 0.1 dB down at MR_PASS and its images over 50 dB down
+     * Decimating it is scaled by 1/2 for unity gain
+     */
+    static float HalfbandDecimate(const float *x)
+    {
+      return (3.0f / 512) * (x[0] + x[10])
+	     - (25.0f / 512) * (x[2] + x[8])
+	     + (150.0f / 512) * (x[4] + x[6])
+	     + 0.5f * x[5];
+    }
+
+    /*
+     * One output at twice the rate of z
+     * When z has just taken a sample, the point halfway between z[3] and z[2],
+     * otherwise z[2] itself (the centre tap)
+     */
+    static float Interpolate(const float *z, bool fresh)
+    {
+      if (!fresh) return z[2];
+      return (3.0f / 256) * (z[5] + z[0])
+	     - (25.0f / 256) * (z[4] + z[1])
+	     + (150.0f / 256) * (z[3] + z[2]);
+    }
+
+    void Remap(const iir_reson &m, reson_hot &h, int D)
+    {
+      float r = m.r();
+      float rd = powf(r, D);
+      float wc = 2 * PI * m.fc() * D / fs_;
+      h.a[0] = -2 * rd * cosf(wc);
+      h.a[1] = rd * rd;
+      float scale = r < 1 ? (1 - rd) / (1 - r) : D;
+      h.b0 = m.g() * r * scale;
+    }
+
+    float fs_ = 48000;
+    bool enabled_ = false;
+    bool dirty_ = true;
+    uint32_t t_ = 0;
+    int deepest_ = 0;
+
+    uint8_t tier_[N];
+    uint8_t idx_[MR_TIERS][N];
+    int count_[MR_TIERS];
+    // Crossfades: each moving mode's old tier (or MR_NONE), its state there and when it moved
+    reson_hot ghost_[N];
+    uint8_t ghost_tier_[N];
+    uint32_t fade_start_[N];
+    uint8_t fading_[N];
+    int n_fading_ = 0;
+    uint32_t fade_end_ = 0;
+    tier_state tiers_[MR_TIERS];
+    float align_[MR_ALIGN_TOTAL];
+};
+} // namespace daisysp
+#endif
+#endif
@@ -0,0 +1,224 @@
+#pragma once
+#ifndef DSY_RESON_PRECISION_H
+#define DSY_RESON_PRECISION_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "arm_math.h"
+#include "iir_reson.h"
+#ifdef __cplusplus
+
+// Modes above this pole angle always run in float, the delta form only helps low modes
+#define PREC_MAX_WC	  (PI / 10)
+// Estimated detuning from rounding a[0] that a float mode may have, in cents
+#define PREC_CENTS	  0.1f
+// Estimated rounding noise relative to the mode's own level, allowed in float and in error feedback
+#define PREC_NOISE_FLOAT  1e-3f
+#define PREC_NOISE_EF	  1.0f
+// Half a float's precision
+#define PREC_EPS	  5.9604645e-8f
+// PI is a float
+#define PREC_PI_D	  3.14159265358979323846
+
+namespace daisysp
+{
+/*
+ * reson_precision
+ *
+ * Runs each of a voice's modes only as precisely as its pole needs.
+ * A float a[0] = -2 r cos(wc) loses the pole angle as wc goes to 0, low modes with r near 1
+ * detune and their rounding noise swamps them. Each mode is classed by its pole:
+ *   FLOAT   the voice's own reson_hot, as in the plain loop
+ *   EF	     float with a[0] = -2 + e1 and a[1] = 1 - e2 kept as their small decay and angle
+ *	     parts, which hold the pole to full precision, and the sum's rounding error fed back
+ *   DOUBLE  double coefficients and state, for the few modes error feedback can't hold
+ * and each class runs in its own loop.
+ *
+ * Every mode's state stays in its reson_hot (DOUBLE modes write theirs back rounded),
+ * so the cache, the subnormal counts and at_rest see the voice the same either way.
+ * The voice calls MarkDirty whenever its coefficients change, Reload when it changes the
+ * state in its reson_hots, and Update before processing.
+ */
+template <int N>
+class reson_precision
+{
+  public:
+    enum { NONE = 0, FLOAT, EF, DOUBLE, CLASSES };
+
+    void Init(float fs)
+    {
+      fs_ = fs;
+      enabled_ = false;
+      dirty_ = reload_ = true;
+      for (int c = 0; c < CLASSES; c++) {
+	count_[c] = 0;
+      }
+      for (int i = 0; i < N; i++) {
+	cls_[i] = NONE;
+      }
+    }
+
+    void SetEnabled(bool on)
+    {
+      if (on != enabled_) {
+	enabled_ = on;
+	dirty_ = reload_ = true;
+	if (!on) {
+	  count_[EF] = count_[DOUBLE] = 0;
+	}
+      }
+    }
+
+    bool Enabled() const { return enabled_; }
+
+    // Some mode needs more than float, otherwise the voice runs its plain loop
+    bool Active() const { return enabled_ && count_[EF] + count_[DOUBLE] > 0; }
+
+    void MarkDirty() { dirty_ = true; }
+    bool Dirty() const { return enabled_ && dirty_; }
+    void Reload() { dirty_ = reload_ = true; }
+
+    // Modes in each class, for benchmarks and debugging
+    int Count(int cls) const { return count_[cls]; }
+
+    // Reclass the modes and work out the coefficients the EF and DOUBLE ones run on
+    void Update(const iir_reson *modes, reson_hot *hot, int n_modes)
+    {
+      dirty_ = false;
+      for (int c = 0; c < CLASSES; c++) {
+	count_[c] = 0;
+      }
+      for (int i = 0; i < N; i++) {
+	// Modes past n_modes are silent
+	uint8_t c = i < n_modes ? Classify(fs_, modes[i].fc(), modes[i].r()) : (uint8_t)NONE;
+	bool fresh = reload_ || c != cls_[i];
+	cls_[i] = c;
+	if (c == NONE) continue;
+	idx_[c][count_[c]++] = i;
+
+	double wc = 2 * PREC_PI_D * modes[i].fc() / fs_;
+	double r = modes[i].r();
+	if (c == EF) {
+	  // e1 y1 - e2 y2 = 2u (y1 - y2) + u^2 y2 + 4r sin^2(wc/2) y1 with u = 1 - r, without the
+	  // cancellation. Rounded as one float, e1's decay part would drown its angle part
+	  double s = sin(wc / 2);
+	  ef_[i][0] = 2 * (1 - r);
+	  ef_[i][1] = (1 - r) * (1 - r);
+	  ef_[i][2] = 4 * r * s * s;
+	  if (fresh) err_[i] = 0;
+	} else if (c == DOUBLE) {
+	  a_[i][0] = -2 * r * cos(wc);
+	  a_[i][1] = r * r;
+	  if (fresh) {
+	    y_[i][0] = hot[i].yn[0];
+	    y_[i][1] = hot[i].yn[1];
+	  }
+	}
+      }
+      reload_ = false;
+    }
+
+    // d is x[n] - x[n-2], scaled the same way as the voice's plain loop
+    float Process(reson_hot *hot, float d, int n_modes)
+    {
+      float out = 0;
+      for (int k = 0; k < count_[FLOAT]; k++) {
+	out += reson_process(hot[idx_[FLOAT][k]], d);
+      }
+      for (int k = 0; k < count_[EF]; k++) {
+	out += ProcessEF(hot, idx_[EF][k], d);
+      }
+      for (int k = 0; k < count_[DOUBLE]; k++) {
+	out += ProcessDouble(hot, idx_[DOUBLE][k], d);
+      }
+      return out / n_modes;
+    }
+
+    // Stereo, side also gets every mode weighted by its side gain
+    float Process(reson_hot *hot, const float *gains, float d, int n_modes, float &side)
+    {
+      float out = 0, s = 0;
+      for (int k = 0; k < count_[FLOAT]; k++) {
+	int i = idx_[FLOAT][k];
+	float v = reson_process(hot[i], d);
+	out += v;
+	s += v * gains[i];
+      }
+      for (int k = 0; k < count_[EF]; k++) {
+	int i = idx_[EF][k];
+	float v = ProcessEF(hot, i, d);
+	out += v;
+	s += v * gains[i];
+      }
+      for (int k = 0; k < count_[DOUBLE]; k++) {
+	int i = idx_[DOUBLE][k];
+	float v = ProcessDouble(hot, i, d);
+	out += v;
+	s += v * gains[i];
+      }
+      float norm = 1.0f / n_modes;
+      side = s * norm;
+      return out * norm;
+    }
+
+    /*
+     * The class a mode at fc with pole radius r needs.
+     * Rounding a[0] moves the pole angle by about eps / tan(wc), and the recursion's own
+     * rounding is amplified about 1 / ((1 - r) sin(wc)) times
+     */
+    static int Classify(float fs, float fc, float r)
+    {
+      float wc = 2 * PI * fc / fs;
+      if (wc <= 0 || wc >= PREC_MAX_WC) return FLOAT;
+      float decay = 1 - fabsf(r);
+      if (decay <= 0) return DOUBLE;
+      float noise = PREC_EPS / (decay * sinf(wc));
+      if (noise > PREC_NOISE_EF) return DOUBLE;
+      float cents = 1731.234f * PREC_EPS / (tanf(wc) * wc);
+      if (noise > PREC_NOISE_FLOAT || cents > PREC_CENTS) return EF;
+      return FLOAT;
+    }
+
+  private:
+    /*
+     * y = b0 d - a[0] y1 - a[1] y2 as (2 y1 - y2) + (b0 d - e1 y1 + e2 y2):
+     * the big part is exact-ish and what rounding the sum loses goes into the next sample
+     */
+    float ProcessEF(reson_hot *hot, int i, float d)
+    {
+      reson_hot &h = hot[i];
+      const float *e = ef_[i];
+      float t = h.b0 * d - e[0] * (h.yn[0] - h.yn[1]) - e[1] * h.yn[1] - e[2] * h.yn[0] + err_[i];
+      float s = 2 * h.yn[0] - h.yn[1];
+      float y = s + t;
+      err_[i] = t - (y - s);
+      h.yn[1] = h.yn[0];
+      h.yn[0] = y;
+      return y;
+    }
+
+    float ProcessDouble(reson_hot *hot, int i, float d)
+    {
+      reson_hot &h = hot[i];
+      double y = (double)h.b0 * d - a_[i][0] * y_[i][0] - a_[i][1] * y_[i][1];
+      y_[i][1] = y_[i][0];
+      y_[i][0] = y;
+      h.yn[1] = h.yn[0];
+      h.yn[0] = (float)y;
+      return (float)y;
+    }
+
+    float fs_;
+    bool enabled_ = false;
+    bool dirty_ = true, reload_ = true;
+
+    uint8_t cls_[N];
+    uint8_t idx_[CLASSES][N];
+    int count_[CLASSES] = {};
+
+    float ef_[N][3] = {}, err_[N] = {};
+    double a_[N][2] = {}, y_[N][2] = {};
+};
+} // namespace daisysp
+#endif
+#endif
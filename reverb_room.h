@@ -0,0 +1,545 @@
+#pragma once
+#ifndef DSY_REVERB_ROOM_H
+#define DSY_REVERB_ROOM_H
+
+#include "mode_set.h"
+
+#define REVERB_ROOM_MODES 1024
+
+#ifdef __cplusplus
+
+/*
+ * Generated by tools/fit_modes.py from a synthetic room, T60 2.20 s, seed 1 - don't edit
+ * 1024 modes 40 to 15992 Hz at 48000 Hz, T60 0.73 to 2.29 s
+ */
+
+// Fixed frequencies, negative as in mode_set
+const float reverb_room_freqs[REVERB_ROOM_MODES] = {
+  -40.0076432, -41.3722834, -41.9319538, -43.5459087, -44.2213573, -45.3915486, -46.7608055, -47.5893205,
+  -48.7932403, -49.5585406, -51.1650658, -52.1440529, -53.1311813, -54.5761057, -55.3825001, -56.6271644,
+  -57.553551, -58.8898942, -59.9068008, -61.1075072, -62.6138806, -63.4538844, -64.7723614, -66.3030951,
+  -67.4748555, -68.4954959, -69.5579014, -70.5659378, -71.6843945, -73.4791734, -74.3622318, -75.2871093,
+  -76.8815424, -78.2224917, -79.3343892, -80.7985945, -81.3866535, -82.999095, -84.1993683, -85.1566824,
+  -86.8570286, -88.2860492, -89.3609074, -90.3832451, -92.1125164, -93.1455982, -94.4398463, -95.9272753,
+  -96.7574489, -98.5936254, -99.8008976, -101.203179, -102.0545, -103.871772, -104.717495, -105.968739,
+  -107.93944, -109.296947, -110.667435, -111.699436, -112.904465, -114.056775, -115.963083, -117.409662,
+  -118.896989, -119.82899, -121.173209, -122.937556, -124.491167, -126.045573, -126.774774, -128.487924,
+  -130.279116, -131.312374, -132.903897, -133.863566, -135.889061, -137.570277, -138.960247, -140.489547,
+  -141.772119, -142.889574, -144.852217, -145.850946, -147.916773, -148.731401, -150.943851, -151.863504,
+  -153.586175, -155.068157, -156.957423, -158.029511, -159.786667, -160.981287, -162.788567, -164.511532,
+  -165.792005, -167.879648, -169.230944, -171.161308, -172.698826, -174.095701, -176.138493, -177.535072,
+  -179.342003, -180.519892, -182.363567, -183.670303, -186.124485, -187.03736, -188.721333, -190.213211,
+  -192.083069, -194.287498, -195.920236, -197.042774, -199.007876, -200.772379, -202.751056, -204.266626,
+  -206.142675, -208.155653, -209.791295, -211.170279, -213.026072, -214.714625, -216.219855, -218.107821,
+  -219.989826, -221.825305, -223.634106, -225.739493, -227.998951, -229.616446, -231.475952, -233.289279,
+  -234.964259, -237.186305, -238.801423, -240.465916, -241.871366, -244.229637, -245.814877, -247.629376,
+  -249.97274, -252.218464, -253.581596, -256.0713, -257.734223, -259.246192, -262.168994, -263.473585,
+  -265.324373, -267.967864, -269.097176, -271.829918, -273.181386, -275.445783, -277.275616, -280.053485,
+  -281.543268, -284.314065, -285.94224, -288.094715, -289.956091, -291.77351, -293.973285, -296.76196,
+  -297.934945, -301.052595, -302.886693, -304.510829, -307.015839, -308.830984, -310.991072, -313.318622,
+  -314.858812, -317.668816, -320.494899, -321.791821, -324.618895, -326.43371, -328.350843, -331.525462,
+  -332.57557, -335.219116, -338.432589, -339.702471, -342.792144, -344.752164, -347.333411, -349.403062,
+  -351.351899, -354.240064, -355.548952, -358.489418, -360.741992, -363.259716, -365.138347, -367.660021,
+  -370.544968, -372.700074, -375.702936, -377.858732, -380.670721, -382.928992, -385.193221, -387.193659,
+  -390.404763, -392.09762, -394.327561, -398.16744, -400.045806, -402.926829, -405.091045, -407.763154,
+  -409.432552, -412.231713, -415.562096, -417.988191, -419.942856, -423.79274, -425.15808, -428.347044,
+  -430.405478, -433.966506, -435.923014, -438.364701, -440.902381, -443.800645, -446.5297, -449.805287,
+  -452.390108, -455.959353, -458.704493, -461.204258, -463.767489, -466.839294, -469.790789, -471.052944,
+  -474.02529, -477.25928, -479.640641, -483.35212, -485.629474, -488.505834, -491.428439, -493.989802,
+  -498.016404, -500.777239, -503.629777, -505.559802, -509.21087, -512.630974, -514.662683, -518.060577,
+  -520.400873, -523.522243, -526.788487, -530.184998, -533.322506, -537.159241, -539.186111, -541.723477,
+  -546.317054, -548.000933, -551.17936, -555.952789, -558.707238, -561.080497, -563.860837, -567.531914,
+  -570.638959, -574.8838, -577.227919, -579.810228, -584.709114, -587.378627, -589.660927, -592.941263,
+  -596.942028, -599.51351, -603.920508, -607.2342, -609.413353, -614.350798, -617.695287, -621.357933,
+  -624.269749, -627.742537, -630.089123, -633.248817, -636.797957, -642.155478, -644.983549, -649.128777,
+  -651.389139, -655.787369, -657.868024, -661.645145, -665.460125, -669.641985, -673.26592, -676.761779,
+  -680.235985, -684.21913, -688.748566, -691.307725, -695.846607, -697.816929, -702.276673, -706.409623,
+  -710.300953, -713.233463, -717.356708, -722.409079, -725.544977, -729.230845, -731.877299, -735.705367,
+  -739.950149, -743.668984, -749.563297, -751.177997, -755.973612, -759.198143, -764.554856, -767.122078,
+  -771.174751, -775.218938, -779.716731, -784.509364, -789.139961, -791.906265, -796.045254, -801.50193,
+  -805.44471, -808.053623, -813.920809, -818.171532, -820.725987, -826.080158, -829.221759, -833.590674,
+  -838.500541, -842.859998, -847.052498, -851.534944, -855.018788, -860.85262, -863.912413, -869.977546,
+  -873.336488, -877.200491, -881.297401, -886.589504, -890.776102, -895.940192, -900.119185, -903.396059,
+  -910.122079, -912.549474, -919.274055, -923.844052, -928.783193, -932.707179, -935.960206, -941.429823,
+  -946.122904, -951.389287, -955.413787, -961.012625, -964.436772, -969.659978, -975.023354, -979.522246,
+  -983.48543, -990.825567, -994.915857, -1000.24971, -1003.77549, -1010.47564, -1015.0568, -1020.55451,
+  -1023.21518, -1029.0899, -1033.86476, -1039.63163, -1043.61277, -1048.2633, -1054.55295, -1060.21219,
+  -1064.59452, -1071.67526, -1075.07389, -1079.97655, -1086.85878, -1091.04042, -1095.72498, -1101.08727,
+  -1108.55189, -1113.97032, -1118.34086, -1122.55671, -1129.39666, -1133.2306, -1139.04748, -1145.26699,
+  -1150.3194, -1155.69161, -1163.33696, -1166.22851, -1173.32649, -1177.01178, -1182.83859, -1188.91154,
+  -1197.28412, -1202.0987, -1208.33515, -1211.26949, -1219.25255, -1224.22433, -1229.97775, -1236.86512,
+  -1241.33708, -1247.97018, -1253.00049, -1259.41964, -1265.90701, -1270.5559, -1277.00629, -1283.57867,
+  -1289.84415, -1297.14415, -1302.69436, -1308.54793, -1315.86399, -1319.56161, -1325.43177, -1332.76157,
+  -1338.06641, -1345.94484, -1352.3368, -1357.00045, -1365.60922, -1371.39898, -1377.31081, -1385.67972,
+  -1391.92409, -1395.95059, -1402.26287, -1411.76624, -1415.35425, -1424.3414, -1429.2069, -1436.06096,
+  -1443.52189, -1451.7424, -1454.7471, -1462.16037, -1471.23151, -1476.72283, -1483.13369, -1492.80237,
+  -1496.81418, -1505.62155, -1513.63523, -1519.7861, -1526.58384, -1533.6926, -1541.12054, -1545.94844,
+  -1554.60052, -1562.52226, -1570.08609, -1577.38757, -1584.63346, -1588.38983, -1596.91199, -1604.5974,
+  -1613.88909, -1619.18915, -1625.92279, -1632.27491, -1640.95846, -1650.6906, -1654.79086, -1663.01487,
+  -1671.28006, -1679.92592, -1686.81348, -1696.91223, -1701.50971, -1710.914, -1719.71743, -1728.25772,
+  -1735.85277, -1740.24581, -1751.27703, -1758.67305, -1765.43813, -1771.54157, -1780.26369, -1791.15569,
+  -1796.02542, -1805.27609, -1813.1636, -1823.78672, -1830.11327, -1837.03145, -1846.74203, -1854.85962,
+  -1865.19247, -1871.59685, -1881.92793, -1889.61545, -1899.91047, -1907.66684, -1914.56942, -1923.57649,
+  -1932.15094, -1942.91996, -1947.79847, -1958.04517, -1967.41287, -1975.71038, -1985.42598, -1993.78889,
+  -2002.2587, -2012.69129, -2019.75988, -2030.29853, -2040.03563, -2045.87483, -2056.08649, -2068.67699,
+  -2078.02276, -2087.43468, -2091.4311, -2105.14644, -2115.13348, -2124.35893, -2132.74775, -2142.00837,
+  -2151.78223, -2160.51176, -2171.34038, -2179.32043, -2187.38802, -2196.32471, -2210.83565, -2219.73076,
+  -2226.15213, -2239.83982, -2246.64447, -2258.5918, -2266.90389, -2276.07202, -2285.89931, -2295.36383,
+  -2305.52305, -2315.66907, -2326.01655, -2340.87213, -2349.2315, -2357.164, -2370.0266, -2380.57509,
+  -2390.76523, -2399.45197, -2411.45476, -2424.84298, -2432.3815, -2443.84258, -2457.32912, -2463.59773,
+  -2477.61644, -2486.90753, -2499.80588, -2507.94846, -2520.14772, -2530.03327, -2544.43228, -2555.89649,
+  -2565.17859, -2578.75705, -2588.34591, -2600.32979, -2612.13184, -2619.27282, -2635.63147, -2643.01488,
+  -2655.28979, -2664.66733, -2680.77153, -2689.05491, -2703.2583, -2711.70182, -2724.45646, -2736.55227,
+  -2747.40535, -2757.91068, -2775.21281, -2788.58498, -2795.43267, -2807.11468, -2820.66411, -2830.96235,
+  -2847.44317, -2857.71054, -2871.55268, -2886.57641, -2898.75584, -2911.77109, -2924.4862, -2934.52333,
+  -2946.55991, -2955.75235, -2969.04115, -2985.14098, -3000.62747, -3010.29823, -3019.95473, -3034.63945,
+  -3052.06504, -3060.48002, -3074.01783, -3087.9687, -3103.88384, -3119.09727, -3127.55535, -3144.12137,
+  -3157.10198, -3170.00545, -3184.76891, -3200.40579, -3209.24194, -3225.37344, -3235.91768, -3253.30949,
+  -3269.63113, -3285.43576, -3295.11609, -3307.74582, -3324.36645, -3336.85521, -3348.98345, -3366.87517,
+  -3383.7019, -3399.01348, -3414.34607, -3423.61264, -3437.25858, -3450.73616, -3468.40677, -3486.56775,
+  -3496.35848, -3516.85525, -3530.65271, -3541.11796, -3560.18293, -3577.12065, -3593.44677, -3601.69217,
+  -3623.18424, -3638.22576, -3648.79151, -3664.84148, -3686.71331, -3696.81728, -3711.89162, -3731.82236,
+  -3742.11877, -3761.42719, -3776.24877, -3794.13215, -3810.86535, -3827.44955, -3841.70697, -3862.52547,
+  -3878.4513, -3895.91629, -3907.63053, -3927.0832, -3940.77135, -3955.98859, -3976.56793, -3996.4456,
+  -4011.97039, -4023.69048, -4040.18369, -4062.93587, -4079.48368, -4098.43611, -4108.32799, -4133.24504,
+  -4146.2477, -4162.13704, -4180.5137, -4205.15165, -4222.55873, -4231.07103, -4251.47647, -4273.84769,
+  -4284.49858, -4302.63203, -4320.92991, -4348.25964, -4360.73685, -4379.00383, -4402.79386, -4416.08921,
+  -4439.45611, -4454.04681, -4472.04266, -4491.94118, -4508.40341, -4526.36565, -4554.61459, -4573.79384,
+  -4588.35869, -4610.35359, -4631.82603, -4645.81225, -4669.17111, -4689.35136, -4701.07447, -4721.58982,
+  -4748.79511, -4768.2498, -4782.04461, -4809.93713, -4829.86012, -4844.46215, -4864.93042, -4882.56401,
+  -4907.22811, -4923.6943, -4949.78641, -4971.6005, -4991.95161, -5006.49099, -5034.47526, -5057.27366,
+  -5070.7194, -5097.80682, -5122.08179, -5135.4979, -5166.37415, -5188.80511, -5207.16036, -5231.09866,
+  -5245.11962, -5272.30409, -5297.86868, -5308.3157, -5340.94076, -5355.46338, -5385.5043, -5405.9023,
+  -5430.69856, -5447.95786, -5471.43233, -5500.85531, -5512.07747, -5536.31267, -5570.84647, -5593.30545,
+  -5605.92488, -5641.01625, -5654.56507, -5687.10363, -5711.04482, -5722.27838, -5745.97822, -5774.55406,
+  -5807.43005, -5829.63576, -5848.05404, -5879.3781, -5895.79736, -5920.98521, -5943.35475, -5979.61662,
+  -6002.2147, -6022.10897, -6044.22461, -6080.05684, -6096.73089, -6119.29427, -6148.07065, -6178.21798,
+  -6204.74843, -6220.31659, -6259.2646, -6281.07298, -6297.60468, -6336.04043, -6364.53886, -6388.88439,
+  -6402.24612, -6436.30091, -6464.93865, -6496.65451, -6517.41297, -6537.58132, -6578.76062, -6606.40136,
+  -6626.17402, -6646.5471, -6687.21261, -6713.36627, -6745.09743, -6756.89387, -6792.17691, -6817.80428,
+  -6843.1101, -6882.2353, -6904.03494, -6927.479, -6957.85681, -6998.39798, -7023.93315, -7046.22141,
+  -7083.89448, -7103.28373, -7142.34762, -7171.62956, -7189.7548, -7228.61947, -7262.43978, -7293.10985,
+  -7322.3609, -7355.95943, -7384.06308, -7417.68687, -7439.03902, -7462.79113, -7496.41075, -7529.42977,
+  -7555.98251, -7588.49637, -7627.6478, -7654.15184, -7686.44137, -7726.95032, -7761.07828, -7793.31022,
+  -7816.01627, -7854.91487, -7890.16706, -7909.03765, -7942.69646, -7984.34843, -8009.75475, -8041.39391,
+  -8078.10195, -8104.41698, -8146.38828, -8172.1213, -8209.86817, -8243.20703, -8279.52283, -8309.50384,
+  -8350.92883, -8389.87748, -8417.23443, -8464.24956, -8497.74846, -8521.13657, -8550.6374, -8601.37232,
+  -8625.58268, -8663.11511, -8704.13648, -8749.06806, -8769.98137, -8809.79292, -8849.56406, -8887.25163,
+  -8913.49839, -8958.67896, -8994.44273, -9034.036, -9059.08855, -9096.64508, -9153.24119, -9187.42929,
+  -9225.39014, -9265.79382, -9304.53571, -9329.77785, -9376.49411, -9412.46441, -9449.28341, -9490.94666,
+  -9521.5409, -9573.48784, -9602.08984, -9635.43136, -9671.78199, -9726.57534, -9756.76705, -9814.35464,
+  -9836.25198, -9879.62185, -9936.53704, -9965.97475, -10016.8251, -10054.4974, -10079.3621, -10123.1781,
+  -10169.035, -10223.2007, -10251.3841, -10296.7432, -10339.4666, -10377.9318, -10432.3639, -10456.3642,
+  -10503.6943, -10562.3382, -10600.2411, -10641.0014, -10680.9233, -10718.4364, -10771.0418, -10829.315,
+  -10863.2658, -10907.3194, -10963.171, -11005.292, -11053.499, -11097.5711, -11135.2386, -11170.9462,
+  -11225.621, -11263.8857, -11322.8875, -11350.5129, -11406.1164, -11463.4768, -11499.5366, -11550.791,
+  -11583.8108, -11636.584, -11703.4326, -11742.7865, -11782.4304, -11835.0788, -11891.0487, -11940.0946,
+  -11990.1588, -12023.3615, -12071.0514, -12132.3431, -12178.6675, -12229.629, -12269.1334, -12322.4683,
+  -12386.0208, -12424.6986, -12487.7207, -12516.9861, -12596.0361, -12624.5631, -12684.5729, -12750.2476,
+  -12781.4762, -12832.9099, -12909.3064, -12959.4972, -13000.6188, -13038.708, -13109.4222, -13151.6257,
+  -13204.152, -13281.4162, -13325.4798, -13374.1792, -13416.292, -13481.2784, -13552.6516, -13589.3363,
+  -13645.5056, -13710.7489, -13754.8003, -13821.2581, -13884.8731, -13925.1411, -13988.3487, -14049.0034,
+  -14099.0084, -14151.7207, -14205.6855, -14279.3895, -14350.6947, -14376.9457, -14465.5053, -14527.9576,
+  -14572.2623, -14646.9248, -14697.2231, -14751.4212, -14808.6371, -14869.1311, -14937.631, -14982.1653,
+  -15060.9303, -15114.0559, -15182.4837, -15254.2894, -15290.0499, -15358.7415, -15416.5266, -15470.9606,
+  -15555.6165, -15619.2568, -15697.1068, -15745.7578, -15802.0143, -15885.9607, -15916.253, -15992.3015
+};
+
+const float reverb_room_res[REVERB_ROOM_MODES] = {
+  0.999937156, 0.999937001, 0.999936937, 0.999936753, 0.999936675, 0.999936541, 0.999936382, 0.999936345,
+  0.999936306, 0.99993628, 0.999936227, 0.999936195, 0.999936162, 0.999936114, 0.999936087, 0.999936046,
+  0.999936015, 0.999935971, 0.999935937, 0.999935896, 0.999935846, 0.999935818, 0.999935774, 0.999935722,
+  0.999935683, 0.999935648, 0.999935613, 0.999935557, 0.999935424, 0.99993521, 0.999935103, 0.999934992,
+  0.999934799, 0.999934635, 0.999934499, 0.999934319, 0.999934247, 0.999934047, 0.999933898, 0.999933778,
+  0.999933564, 0.999933383, 0.999933247, 0.999933116, 0.999932895, 0.999932761, 0.99993275, 0.999932894,
+  0.999932975, 0.999933151, 0.999933267, 0.999933401, 0.999933482, 0.999933654, 0.999933734, 0.999933852,
+  0.999934036, 0.999934163, 0.99993429, 0.999934386, 0.999934497, 0.999934603, 0.999934778, 0.999934887,
+  0.999934872, 0.999934863, 0.999934849, 0.999934831, 0.999934815, 0.9999348, 0.999934792, 0.999934775,
+  0.999934756, 0.999934746, 0.99993473, 0.99993472, 0.999934699, 0.999934682, 0.999934668, 0.999934652,
+  0.999934429, 0.999934212, 0.999933827, 0.99993363, 0.999933217, 0.999933053, 0.999932603, 0.999932414,
+  0.999932058, 0.999931748, 0.999931349, 0.999931121, 0.999930743, 0.999930484, 0.999930088, 0.999929664,
+  0.999929254, 0.999928577, 0.999928131, 0.999927484, 0.999926961, 0.999926479, 0.999925762, 0.999925264,
+  0.99992461, 0.999924177, 0.99992349, 0.999922995, 0.999922049, 0.999921691, 0.999921327, 0.999921104,
+  0.999920823, 0.99992049, 0.999920241, 0.999920069, 0.999919766, 0.999919493, 0.999919183, 0.999918945,
+  0.999918647, 0.999918326, 0.999918063, 0.999917881, 0.999917907, 0.999917931, 0.999917953, 0.999917979,
+  0.999918006, 0.999918032, 0.999918057, 0.999918087, 0.999918119, 0.999918142, 0.999918168, 0.999918193,
+  0.999918209, 0.999918209, 0.999918209, 0.999918209, 0.999918209, 0.999918209, 0.999918209, 0.999918209,
+  0.999918209, 0.999918209, 0.999918209, 0.999918209, 0.999918209, 0.999918097, 0.999917869, 0.999917767,
+  0.999917622, 0.999917413, 0.999917324, 0.999917107, 0.999916999, 0.999916817, 0.99991667, 0.999916446,
+  0.999916309, 0.999915931, 0.999915707, 0.99991541, 0.99991515, 0.999914896, 0.999914586, 0.999914189,
+  0.999914021, 0.999913572, 0.999913305, 0.999913068, 0.999912645, 0.999912333, 0.999911958, 0.999911551,
+  0.99991128, 0.99991078, 0.999910272, 0.999910037, 0.999909521, 0.999909186, 0.99990885, 0.99990854,
+  0.999908437, 0.999908177, 0.999907859, 0.999907732, 0.999907423, 0.999907226, 0.999906965, 0.999906755,
+  0.999906556, 0.999906535, 0.999906535, 0.999906535, 0.999906535, 0.999906535, 0.999906535, 0.999906535,
+  0.999906535, 0.999906535, 0.999906687, 0.99990715, 0.999907748, 0.999908222, 0.999908692, 0.999909104,
+  0.999909758, 0.999910098, 0.999910543, 0.999911299, 0.999911351, 0.999911351, 0.999911351, 0.999911351,
+  0.999911351, 0.999911351, 0.999911351, 0.999911351, 0.999911351, 0.999911336, 0.999911325, 0.9999113,
+  0.999911283, 0.999911255, 0.999911239, 0.99991122, 0.999911199, 0.999911176, 0.999911164, 0.999911164,
+  0.999911164, 0.999911164, 0.999911164, 0.999911164, 0.999911164, 0.999911164, 0.999911129, 0.999911087,
+  0.999910988, 0.999910879, 0.999910799, 0.999910674, 0.999910597, 0.9999105, 0.9999104, 0.999910358,
+  0.999910319, 0.999910293, 0.999910266, 0.999910248, 0.999910213, 0.99991018, 0.999910161, 0.999909678,
+  0.999909218, 0.999908596, 0.999907937, 0.999907242, 0.99990659, 0.99990578, 0.999905373, 0.999905373,
+  0.999905373, 0.999905373, 0.999905373, 0.999905373, 0.999905373, 0.999905373, 0.999905253, 0.999904929,
+  0.999904653, 0.999904273, 0.999904062, 0.999903828, 0.999903382, 0.999903147, 0.999902952, 0.999902671,
+  0.999902325, 0.999902102, 0.999901717, 0.999901426, 0.999901236, 0.99990118, 0.999901141, 0.999901099,
+  0.999901066, 0.999901026, 0.999900999, 0.999900967, 0.999900959, 0.999900948, 0.999900942, 0.999900934,
+  0.999900929, 0.99990092, 0.999900872, 0.999900762, 0.999900651, 0.999900529, 0.999900423, 0.99990032,
+  0.999900183, 0.999899808, 0.999899378, 0.999899134, 0.999898697, 0.999898506, 0.999898072, 0.999897683,
+  0.999897319, 0.999897043, 0.999896652, 0.999896169, 0.999895867, 0.999895739, 0.99989571, 0.999895667,
+  0.99989562, 0.999895578, 0.999895512, 0.999895507, 0.999895507, 0.999895507, 0.999895507, 0.999895507,
+  0.999895507, 0.99989542, 0.999895201, 0.999894966, 0.999894737, 0.999894601, 0.999894395, 0.999893657,
+  0.999893055, 0.999892653, 0.999891738, 0.999891066, 0.999890676, 0.999890047, 0.999889674, 0.999889152,
+  0.999888559, 0.999888028, 0.99988785, 0.999887756, 0.999887683, 0.99988756, 0.999887496, 0.999887397,
+  0.999887361, 0.999887319, 0.999887275, 0.999887217, 0.999887177, 0.999887289, 0.999887379, 0.99988745,
+  0.999887594, 0.999887646, 0.999887679, 0.999887679, 0.999887679, 0.999887679, 0.999887679, 0.999887595,
+  0.999887494, 0.99988738, 0.999887293, 0.999887175, 0.999887212, 0.999887268, 0.999887326, 0.999887375,
+  0.999887417, 0.999887608, 0.999887722, 0.999887871, 0.999887969, 0.999888081, 0.999888081, 0.999888081,
+  0.999888081, 0.999888081, 0.999888022, 0.99988789, 0.999887799, 0.999887693, 0.999887548, 0.999887784,
+  0.999887972, 0.999888276, 0.999888421, 0.999888556, 0.999888576, 0.999888589, 0.999888603, 0.999888618,
+  0.99988862, 0.99988862, 0.99988862, 0.99988862, 0.999888594, 0.999888571, 0.999888537, 0.9998885,
+  0.999888305, 0.999887798, 0.999887069, 0.999886791, 0.999886208, 0.999886114, 0.999885966, 0.999885811,
+  0.999885621, 0.999885554, 0.999885468, 0.999885428, 0.999885321, 0.999885292, 0.999885259, 0.999885219,
+  0.999885193, 0.999885088, 0.999885001, 0.999884889, 0.99988476, 0.999884427, 0.99988396, 0.999883481,
+  0.999883033, 0.999882605, 0.999882278, 0.999881932, 0.999881205, 0.999880661, 0.999879787, 0.999878678,
+  0.999878019, 0.999877382, 0.99987686, 0.999876476, 0.999876151, 0.999876032, 0.99987591, 0.999875657,
+  0.999875354, 0.999875158, 0.999874849, 0.999874673, 0.999874685, 0.999874717, 0.999874734, 0.999874736,
+  0.999874736, 0.999874736, 0.999874736, 0.999874736, 0.999874736, 0.999874736, 0.999874736, 0.999874736,
+  0.999874736, 0.999874849, 0.999875009, 0.999875132, 0.999875178, 0.999875118, 0.999875055, 0.999875014,
+  0.99987515, 0.999875298, 0.999875439, 0.999875635, 0.999875832, 0.999875934, 0.999876078, 0.999876078,
+  0.999876078, 0.999876042, 0.999875918, 0.9998758, 0.999875634, 0.99987527, 0.999875116, 0.999874806,
+  0.999874766, 0.999874766, 0.999874766, 0.999874766, 0.999874766, 0.999874766, 0.999874766, 0.999874766,
+  0.999874667, 0.99987437, 0.999873618, 0.999873149, 0.999872995, 0.999872855, 0.999872655, 0.999871818,
+  0.999871413, 0.999870687, 0.999870672, 0.999870652, 0.999870623, 0.999870549, 0.999870446, 0.99987025,
+  0.999869796, 0.999869512, 0.999868774, 0.999868116, 0.999867345, 0.999867304, 0.999867267, 0.99986715,
+  0.999866754, 0.999866254, 0.999866109, 0.999865973, 0.999865848, 0.99986556, 0.999865182, 0.999864823,
+  0.999864324, 0.999863704, 0.999863775, 0.999864401, 0.999864955, 0.999865184, 0.999865582, 0.999865601,
+  0.999865252, 0.999864916, 0.999864811, 0.99986445, 0.999864338, 0.999864338, 0.999864338, 0.999864323,
+  0.999864307, 0.99986402, 0.999863305, 0.999862773, 0.999862582, 0.999862389, 0.999861693, 0.999861054,
+  0.999860589, 0.999860559, 0.999860559, 0.999860457, 0.999860357, 0.999860172, 0.99985977, 0.999859381,
+  0.999859133, 0.999858914, 0.999858925, 0.999859214, 0.999859721, 0.999860369, 0.99986118, 0.99986118,
+  0.999861181, 0.999861284, 0.999861425, 0.999861528, 0.999861579, 0.999861799, 0.999862191, 0.999862296,
+  0.999862296, 0.999862223, 0.999861847, 0.999861605, 0.999860889, 0.999860304, 0.999859692, 0.99985922,
+  0.999858841, 0.999858266, 0.999857605, 0.99985677, 0.99985643, 0.999856258, 0.99985612, 0.99985612,
+  0.99985612, 0.99985612, 0.999855717, 0.999855339, 0.999854785, 0.999854499, 0.999854189, 0.99985404,
+  0.999854099, 0.999854359, 0.999854313, 0.999853982, 0.999853882, 0.99985372, 0.999853403, 0.999853097,
+  0.999852914, 0.999852883, 0.999852807, 0.999852741, 0.999852741, 0.999852725, 0.999852689, 0.999852675,
+  0.999852675, 0.999852675, 0.999852675, 0.999852675, 0.999852675, 0.999852675, 0.999852675, 0.999852675,
+  0.999852689, 0.999852713, 0.999852724, 0.999852662, 0.999852636, 0.999852629, 0.9998526, 0.999852545,
+  0.999852509, 0.99985249, 0.99985249, 0.999851865, 0.999851433, 0.99985135, 0.999851345, 0.999851283,
+  0.999851187, 0.999850956, 0.999850605, 0.999850165, 0.999849669, 0.999849557, 0.999849557, 0.999848926,
+  0.99984859, 0.99984859, 0.99984859, 0.999848586, 0.999848558, 0.999848502, 0.999848372, 0.999847944,
+  0.999847748, 0.999847453, 0.999847376, 0.999847295, 0.999846974, 0.999846794, 0.999846708, 0.999846708,
+  0.999846708, 0.999846708, 0.999846708, 0.999846684, 0.999846312, 0.999845833, 0.999844735, 0.999843278,
+  0.999843078, 0.999842766, 0.999842598, 0.999842598, 0.999842458, 0.999842363, 0.999842363, 0.999842363,
+  0.999842363, 0.999842231, 0.99984194, 0.999841583, 0.999841425, 0.999841425, 0.999841425, 0.999841425,
+  0.999841345, 0.999841118, 0.999840661, 0.999840037, 0.999839824, 0.999839824, 0.999839871, 0.999839989,
+  0.999839989, 0.999840085, 0.999840032, 0.999839568, 0.99983918, 0.999839103, 0.999838781, 0.99983844,
+  0.99983844, 0.999838241, 0.999838096, 0.999837634, 0.999837184, 0.999836764, 0.999836677, 0.999836534,
+  0.999836336, 0.999836323, 0.999836085, 0.99983602, 0.999836076, 0.999836221, 0.999836399, 0.999836157,
+  0.999836061, 0.999836014, 0.99983601, 0.999836013, 0.999836016, 0.999835958, 0.99983579, 0.999835231,
+  0.999834727, 0.99983434, 0.999833841, 0.999833495, 0.999833576, 0.999833417, 0.999833339, 0.99983312,
+  0.999832708, 0.999832788, 0.999832993, 0.999833726, 0.999832799, 0.999832788, 0.999832134, 0.999831974,
+  0.999831941, 0.999832341, 0.999832788, 0.999832685, 0.999831879, 0.999831706, 0.999831433, 0.999831366,
+  0.999831155, 0.999830949, 0.999830936, 0.999830871, 0.999830797, 0.999830797, 0.999830797, 0.999830797,
+  0.999830897, 0.999830938, 0.999831203, 0.999831529, 0.999831422, 0.999830938, 0.999830938, 0.999830585,
+  0.999830392, 0.999829979, 0.999829637, 0.999829006, 0.999828626, 0.999828494, 0.999828559, 0.999829088,
+  0.999829398, 0.999829031, 0.999828734, 0.999828431, 0.999828325, 0.999827995, 0.999827838, 0.999827505,
+  0.999827175, 0.999827175, 0.999827175, 0.999827554, 0.999827559, 0.999827559, 0.999827434, 0.999827175,
+  0.999827175, 0.999827175, 0.999826782, 0.99982654, 0.99982672, 0.999827424, 0.999827175, 0.999827077,
+  0.999827009, 0.999826879, 0.999826798, 0.99982637, 0.999825607, 0.999825091, 0.999824789, 0.999824726,
+  0.99982438, 0.999824477, 0.999823722, 0.999823398, 0.999822229, 0.999821856, 0.999821185, 0.99982107,
+  0.999821629, 0.999820906, 0.999820491, 0.999820491, 0.999821494, 0.999821734, 0.999821692, 0.99982091,
+  0.999820154, 0.999820129, 0.999820065, 0.999820488, 0.999821373, 0.999820685, 0.999819858, 0.99981987,
+  0.999820154, 0.999819338, 0.999820172, 0.999820409, 0.999820255, 0.999819761, 0.999818993, 0.999818212,
+  0.999818124, 0.999817931, 0.999817167, 0.999816914, 0.999816845, 0.999816783, 0.999815672, 0.999815672,
+  0.999815668, 0.999815664, 0.999815639, 0.999815446, 0.999814366, 0.999814354, 0.999814348, 0.99981433,
+  0.999814653, 0.999814489, 0.999814242, 0.99981423, 0.999814234, 0.999814305, 0.99981433, 0.999814291,
+  0.999814249, 0.999814034, 0.999813638, 0.999813601, 0.999813371, 0.999813406, 0.999813432, 0.999813372,
+  0.999813305, 0.999813305, 0.999813282, 0.999813091, 0.999812965, 0.999812647, 0.999812246, 0.999812238,
+  0.999812189, 0.999812133, 0.999811763, 0.999811299, 0.999811296, 0.999811349, 0.999811289, 0.99981107,
+  0.999811069, 0.999811069, 0.999811069, 0.99981079, 0.999811219, 0.999811129, 0.99981079, 0.999810603,
+  0.999810379, 0.999810083, 0.999809841, 0.999809362, 0.999808853, 0.999808424, 0.999808466, 0.999808961,
+  0.99980923, 0.999809491, 0.999809318, 0.99980862, 0.999808246, 0.999808198, 0.999808225, 0.999807386,
+  0.999806534, 0.999806513, 0.999806513, 0.999806582, 0.999806343, 0.999806218, 0.999805679, 0.999805509,
+  0.999805408, 0.999805269, 0.999805269, 0.999805259, 0.999804627, 0.99980473, 0.99980448, 0.999804367,
+  0.999804224, 0.999804288, 0.999805269, 0.999805425, 0.999804874, 0.999804627, 0.999804982, 0.999805269,
+  0.999804627, 0.999804538, 0.999805308, 0.99980556, 0.999805269, 0.999805299, 0.999805643, 0.999805444,
+  0.999805442, 0.99980541, 0.999804916, 0.999804954, 0.999804871, 0.999805537, 0.999805599, 0.999805763,
+  0.999805986, 0.999806685, 0.999805979, 0.999806139, 0.999806898, 0.999806293, 0.99980586, 0.999805587,
+  0.999804641, 0.999804962, 0.999805645, 0.999805856, 0.999805269, 0.999804754, 0.999804547, 0.999804391,
+  0.999804391, 0.999804121, 0.999803973, 0.99980406, 0.99980406, 0.999803946, 0.999803784, 0.999803587,
+  0.999803649, 0.999803907, 0.99980399, 0.999804173, 0.999803984, 0.999803928, 0.999803942, 0.999804092,
+  0.999804279, 0.999804195, 0.999804175, 0.999804039, 0.999804195, 0.999804195, 0.999804195, 0.999804509,
+  0.999805733, 0.999805734, 0.999804713, 0.99980574, 0.99980574, 0.99980574, 0.999805855, 0.999806491,
+  0.999806402, 0.999806365, 0.999805972, 0.999805985, 0.999805753, 0.999805938, 0.999805985, 0.999806274,
+  0.999805754, 0.999805552, 0.999804706, 0.999805615, 0.999805782, 0.99980559, 0.999805823, 0.999805793,
+  0.999805764, 0.999805477, 0.999804384, 0.99980466, 0.999804752, 0.999804812, 0.99980485, 0.999805768
+};
+
+const float reverb_room_gains_l[REVERB_ROOM_MODES] = {
+  -9.05647804, -1.57775653, 1.46550609, 0.439922845, -0.505472537, 0.460120312, 0.691457564, 1.18862184,
+  -1.55425793, -1.6623551, 0.828482449, -0.510697404, 1.0210974, -1.47455547, -1.421718, 0.913307609,
+  -0.531310255, 0.317349015, -1.05298378, -1.01391277, -1.43242309, -0.918482762, -1.37887374, -1.11474999,
+  -2.03155273, -2.28195562, -1.99823757, -2.35469189, 3.59488648, 1.82329187, 0.905442663, 0.663953209,
+  -0.732966542, 0.635107174, 1.2239501, -1.51620225, 0.993862897, -0.845194108, 0.97574748, 0.798980016,
+  -1.12999039, -1.6158913, 0.906208754, -1.45900753, 2.38820347, 1.99506683, 1.4494752, 1.19543649,
+  -0.704140805, 1.54014052, 1.72067561, 1.94063697, 1.57848138, -1.11228244, 0.603986149, 0.812234226,
+  1.06354743, 1.72904875, 1.34147154, 1.52176486, 1.92948307, 1.13249686, 2.01547084, 2.37675076,
+  2.55522969, -2.12624944, -2.0714379, -0.817605961, -0.438494658, -0.537756053, 0.929339394, 1.1592186,
+  1.64271046, 1.74500435, -2.41975279, -1.25070766, -1.49516149, -2.09732919, -1.9280107, 1.18369975,
+  -1.5823688, -1.89637142, -2.08303902, 1.82262251, 0.971872375, -1.47193076, 1.51256315, -0.662164398,
+  0.724587707, -0.893313811, -1.47818769, 1.01823793, -1.02036518, -1.14842276, 0.603068947, -0.273290063,
+  -0.536934381, 0.562242439, 0.957251167, 0.853046447, 1.33712312, -2.98313428, -2.16341871, -1.61051687,
+  0.744189796, -1.05700985, 1.02017777, -1.08352616, 0.696808305, 1.31240403, 1.65380828, -1.59495852,
+  1.2512476, -0.951570534, -1.13267466, -1.35270441, -2.9687439, 1.41623576, -2.93360691, -2.81797747,
+  -2.65112612, 2.99490541, 1.62475401, 1.36537355, 2.14337404, 1.59105662, 1.19197699, 1.42949057,
+  -0.686556881, -1.0861099, 0.805016612, 1.53835632, 2.06174435, 0.786905816, 1.15309267, -2.13912473,
+  -1.50527419, -0.81597559, -1.93854598, -0.9780376, -1.46489673, 2.01648555, 1.55734961, 1.21361051,
+  1.17384002, 1.40255044, -1.3063858, -1.42944714, 0.894233674, -1.09485764, 1.51954012, 3.03542127,
+  2.54431511, -1.67831715, -2.52763936, 2.702014, 2.18848056, 2.78624965, -1.24076486, -1.03580473,
+  -1.59274253, -2.04825077, 2.40509985, 1.33749077, 0.544534877, 1.45959879, -1.2047656, 0.778677178,
+  -0.399019237, -0.828591894, 0.6304953, 0.472018509, -0.912516536, -0.607056172, 1.63277872, -1.6476656,
+  1.62490981, -1.57771578, -0.681189831, 1.82253445, 1.02091376, -1.69676864, -2.16226237, 0.673513675,
+  2.29678793, -1.48432467, -0.700000518, 2.12101961, 2.04976649, 2.10465518, -1.78673868, 1.72515415,
+  -1.72495396, 0.693217251, 1.162786, -2.6701649, -2.42159124, -0.906895103, -2.25486406, -3.27688221,
+  -3.82712755, 2.44033621, -1.19207409, 1.2099046, 1.37441069, 1.50128392, 1.31606778, 1.77122127,
+  -1.51015556, 0.497293962, -1.2421208, 2.11283954, 2.14008461, 1.76142029, -0.656101292, -1.41952096,
+  0.479474579, -1.10040363, -1.49197979, -1.28850243, -1.2837311, 0.658102877, -2.40379177, -1.97509108,
+  -2.88974508, 2.27533172, -1.71557612, 1.60378369, -1.52586826, 1.57242868, 0.712968741, 2.01111141,
+  -1.54421957, -2.05540465, 2.4590946, 1.22186233, -1.22053145, -2.46577665, -1.34142719, 0.908159735,
+  -1.06768068, 1.78330912, 1.25705096, -1.53411843, -2.34533996, 2.74254438, -1.23383804, -1.18381039,
+  2.00297252, 1.76939951, 1.03898129, 0.837475466, 2.18356178, 1.35730841, 1.25229677, 2.20406947,
+  -1.9209564, -3.44926844, 3.91894272, 2.64188327, 1.74429505, 2.01938355, -1.58305114, 2.28876821,
+  2.38359317, 1.67976269, 3.12124691, -1.2959142, -1.16036737, -0.951357013, 2.86265462, -3.70198286,
+  -1.50408694, -2.54723904, -2.04032413, -1.958999, -3.68381526, 3.14432154, 1.36781691, -1.20746034,
+  1.99583436, 1.92140966, -3.8205928, -4.41770667, 4.16978206, 2.42702647, 2.26533907, -1.21438907,
+  1.80298653, 2.37995493, -0.459298868, 1.36849693, -2.81735317, 2.60126076, 3.10937913, -3.70131041,
+  -3.99556278, -1.43792713, 0.920659957, 1.18392418, -1.62734717, -0.687689066, 0.890588329, 2.09489018,
+  -3.00290984, -3.00565395, 1.69029754, 1.85814581, -1.44447688, 1.07001106, 1.5548446, 1.241846,
+  0.933137716, 2.34598749, -4.04936014, -2.53693586, -3.01436066, 2.23733859, 2.35677913, -2.19577156,
+  -1.68953164, -2.39711739, -1.6721901, -2.36189244, 2.31453987, -2.55866096, 3.13339822, 1.80864146,
+  2.33330695, 5.57166586, 3.18471562, 2.97636161, 2.81211616, -2.53302395, -3.01303687, 3.99617235,
+  -0.978981446, 1.93165473, -2.03521872, -2.61503058, -2.42313467, -0.600843708, 0.930028212, -2.93130939,
+  4.7617199, 2.86687895, -2.64385767, 1.81321637, 2.61669675, 0.972929859, 3.40306617, -3.32014702,
+  -1.61197415, -2.95246905, -3.10988732, 3.7808913, -2.46370196, -1.32027228, -1.77546491, -2.04259513,
+  -4.09278142, 2.59968303, 3.69503526, 2.18479269, 1.53458671, 2.70525847, -1.75973598, 2.12285181,
+  2.38418746, 2.97264486, -3.84993754, -4.32068572, -2.39262835, -3.6089708, 2.72603853, -1.73627183,
+  4.76114098, 3.77088507, 1.06423362, -1.70144169, -1.27402117, -1.8579076, 1.47534538, -1.26876062,
+  4.19302693, 5.28753498, -6.66255594, -4.91396354, -4.60903113, 3.64662188, 2.06127762, 1.27478821,
+  2.5784803, -1.24166911, -2.17364212, 1.85454838, 2.5298636, -3.31530295, -2.56662053, -2.69106361,
+  3.66149169, 1.92760855, 1.69084538, 2.4667535, -1.80948126, 2.35042812, 2.96007819, 3.01495479,
+  -2.48486342, -1.91845113, -1.35981489, -2.41304389, 3.2827125, -1.49263691, 2.61382402, -3.78733583,
+  -2.59253943, 3.44218398, 1.63617729, 2.86864462, 5.6498086, -2.77518762, -4.97157298, -2.30281374,
+  -1.84839865, 3.03811678, -2.73972542, 4.78215267, 3.51241988, 2.03759987, 2.60118958, 2.22649543,
+  -2.4299919, 3.55356168, -3.35986668, -3.1538474, -2.05752015, -2.60375356, -3.6449523, -2.49110313,
+  4.44266033, 2.05228048, -2.22981351, 3.17766554, -4.41994989, 1.28941734, -2.6804337, 3.27410932,
+  -4.84251212, 4.73258935, 6.98935969, -4.26511474, -4.2464728, -2.63439403, -3.01092784, -3.97227902,
+  4.44997188, 2.82856373, 1.9387903, -1.78035761, 2.37490177, -0.974313686, 1.93218978, 2.11850284,
+  -2.23045507, -4.61369909, 3.15974621, -2.11138134, -3.8836008, 2.91472563, -3.0726106, -3.52782554,
+  -3.24208506, 4.5537241, 3.68191246, 2.12542182, -2.73250479, 2.82649885, 3.44816534, -2.1405839,
+  2.89321896, -3.90257323, 2.38294243, -3.64514668, -4.45132408, -2.75816399, 2.99641116, -2.11916558,
+  2.85115608, 4.4204096, 5.19420283, 3.93430476, -4.98827895, 4.48274179, 3.64069858, 2.58937407,
+  -2.01249971, -1.25941493, 3.21354669, 1.73463529, 3.14185071, 2.34198086, -4.1645702, -2.30215835,
+  -4.13848229, 4.01718536, -2.98328683, 3.40831886, -2.29552756, -3.16856972, -2.40559911, 2.11094718,
+  2.44195878, -2.08521903, 4.83460272, 3.48640737, 2.90206793, 2.08348025, 2.0373456, -4.26418613,
+  -3.83718682, 5.13071143, 4.52799934, -3.46226556, 2.82022635, -4.90996855, 4.55788958, -1.99875093,
+  3.09922358, 3.28345719, 4.41837273, -1.39495502, -1.96143613, -3.29890792, -2.1114774, 3.51929813,
+  4.53921958, -2.3766796, 1.86412008, -2.25597741, -3.35204041, 3.69014251, 2.80444508, 2.37771658,
+  -3.70414863, 4.57673132, -4.02921096, -2.02721179, -2.27732309, -3.87336843, -4.76507473, 3.07570508,
+  5.69121526, -5.04279226, 4.35445302, -4.03908172, 2.91090403, -4.56916831, 6.30907865, 5.28105543,
+  3.75556017, -5.10944511, 4.63504297, -5.15439113, -3.45876533, -3.16768844, 3.91743809, 2.32647343,
+  3.28743787, 4.52028263, -6.54054234, -2.87616282, 3.94885429, -3.91770897, -3.24787375, -6.06394674,
+  -4.53523511, 3.09049763, 2.58406191, -4.15790232, -6.5955415, -5.13124137, -8.52869072, 8.99239073,
+  1.86798503, -2.54363611, 5.44948839, 3.38528421, -3.37537079, 4.80379366, 3.40090215, 3.54151513,
+  2.51740895, -3.98509563, 2.68989619, 4.12727223, 2.23785989, 2.84741607, -4.37212214, -3.49562738,
+  4.6116972, 3.57419385, -4.29628263, 3.57174367, 3.59582437, 1.94270826, -3.67867322, -5.2173661,
+  2.78826429, 5.01379053, 5.10013043, -3.89780799, 4.60760475, 3.79139159, -1.80596534, 3.00150098,
+  -5.01566189, 2.9003979, 4.85734092, -8.94610249, -6.40952144, 5.21242816, 2.79288236, 5.63151617,
+  2.76981772, -1.66629535, -6.04006135, 7.48751288, -4.6629786, 5.44345143, -3.77009577, 4.54836947,
+  4.49711959, 3.58056961, -3.48583949, 2.9240163, 4.46724422, -2.99772329, 2.46229831, 5.78508237,
+  -9.11954011, -5.70584625, 4.56764805, 3.67736735, 4.90509435, -5.3646542, 5.81882923, -2.88205829,
+  -2.92546422, 5.66521108, -3.50641211, 5.06965169, 4.24107485, 3.88815011, 7.90967478, -5.86772593,
+  -3.96712113, -6.03851369, -3.06941241, -3.88924469, -6.94989335, 4.67965037, -4.19742294, 5.90594764,
+  -5.74309696, -4.59796718, -3.94478224, 6.4150166, 3.82910308, -2.60048504, -3.43124394, 3.92075421,
+  3.53001464, 5.65824525, -5.14521795, 3.84935568, -3.73438712, -8.32327255, -6.06331875, -6.25399291,
+  6.08208688, -2.79557969, 6.85446617, -7.56146869, 3.63071153, -5.20056681, -4.30723621, -5.30933311,
+  -5.39456409, -3.92137389, -10.1251148, 7.57754604, 3.97775118, 2.11640602, -5.07728684, -3.57638198,
+  4.78763322, 6.288942, -7.97147778, -6.55555405, 3.09719843, -4.10244564, -6.54020658, 9.37252384,
+  3.26506997, 3.23770271, 5.06632402, -5.1611543, 6.81226442, 5.12720293, -4.32965809, 5.26703293,
+  7.80345859, -4.28861217, -4.51071966, -7.85676439, 3.9408797, -4.20705607, 6.52632272, 5.54646135,
+  -4.39589773, 4.06816639, -3.32334843, -4.17547037, 6.18895932, -3.35104469, -4.20631396, 4.79721346,
+  -6.5010794, 5.35826898, 5.11249102, 5.62354699, -4.48602729, 4.54770374, -7.05486774, -5.75632448,
+  -5.38824759, -4.46626005, 5.35511507, -5.4036949, -5.3403075, 4.41321691, 7.44536633, 6.61619885,
+  5.4589561, 3.5703094, 5.00917975, -7.3469225, -7.70085004, 5.04874127, -4.31882729, 3.59261589,
+  -6.06476756, 9.54716285, -5.50611073, -4.97873567, 3.94989603, -4.54312618, -6.53537478, -6.98401475,
+  4.29795067, -6.12775215, 8.8416134, -9.02920828, -9.28743341, 7.6221649, -4.327631, 4.82296771,
+  -6.23432017, -4.24392241, -5.71327677, -6.31732883, -6.51744454, -4.34348558, 6.20660031, -6.14320962,
+  -6.72576614, -5.77440247, 8.53229808, 6.66809242, -4.87989521, -5.97156879, -8.08381086, 5.9136415,
+  -5.19366834, -5.7669831, 6.80151419, -4.98087099, 7.03945497, 7.28730809, -11.0137357, -6.34536136,
+  6.27637139, -5.83241464, 9.52690865, 3.72860866, -4.52539438, -5.13769376, -3.36646927, 6.93103957,
+  5.81270064, 8.59214392, -5.4198237, 5.6872537, 7.12201374, -6.85783433, -7.72604702, 7.84364888,
+  -5.44202914, 6.87997225, -4.91476863, 7.85527935, 4.22362054, 3.70647389, -3.66567974, -4.17150106,
+  -5.85715774, -4.17820055, -4.8616318, -8.46629521, 9.30848657, -6.38013361, 8.13090476, -8.46853601,
+  4.28407968, -9.21816477, 5.03899098, -5.62503137, -4.11253671, -6.18836388, 5.64720542, 6.63843545,
+  -4.53074961, 6.35329445, 6.01636733, -7.5833146, -4.03234244, -8.11593675, -7.61053194, -7.9904592,
+  -7.18968144, -11.7552639, -11.6102748, -5.5784119, 5.52273175, -8.61939897, 8.24325951, -2.66274644,
+  -4.4373008, 7.29248361, 7.35092327, -5.43879629, -6.7440443, -8.05547398, -7.91502848, 11.6020732,
+  -6.05018874, 6.09447383, -6.15238362, 7.93432495, -4.82191731, -6.2623857, 10.2242715, -6.98444497,
+  11.7372214, 6.7809446, -6.18361702, 6.35813927, -5.25463565, -5.25060141, 7.72211813, -8.5863646,
+  -7.11181058, -9.95185513, -7.04714035, -6.82735855, -5.99379523, -7.38844203, 5.50751826, -9.83772284,
+  8.6733997, 6.17006825, -5.99897764, 9.32288002, -8.70677304, -10.3765926, -7.1986864, -4.98712417,
+  -7.65883053, 8.79262356, 6.15311295, 8.23246726, -9.15447443, -6.86437289, -4.21381742, -8.17186697,
+  -8.15493032, 7.76552527, 7.00812978, 6.23236379, -10.2129437, 6.72618972, -8.07530375, 8.56960562,
+  5.46412123, 8.41840222, -10.7978152, 8.50946662, 6.85364131, 4.42283794, -5.80148045, -13.0419908,
+  9.73766541, 10.5139737, 5.45845415, -9.36980229, -8.06032673, -7.29440509, 7.08822144, -5.11843262,
+  8.40620627, -8.23112145, -8.67496652, -6.27842156, 7.64540701, -6.41948106, 8.02557057, 9.20074477,
+  -5.6833576, -7.77018421, 7.95534301, 9.06370812, -8.49443118, 4.9426811, -9.91757589, 9.5775883,
+  6.89739733, 9.40638927, 7.98318425, -11.0442408, -10.1297925, -9.71995865, 7.76799688, -8.06498623,
+  9.86561347, 11.0379101, 5.98407872, -6.35806756, 11.2915023, -8.37437054, -8.03349595, -8.30037399,
+  8.59590188, 7.72207118, 9.0160556, -9.74008118, -12.0429635, -7.27286675, -10.6705391, -9.85524828,
+  9.55173268, -12.1030334, -7.00066334, 7.88490711, -8.3650816, -8.84816695, -8.37647347, 7.7740933,
+  6.72437432, 11.8964825, 11.7042399, 11.1032361, -4.33566657, -9.69702696, 9.50209101, -7.8507788,
+  -12.376066, -7.58521366, -11.0007679, -6.25814703, -13.8240342, 11.1567626, -10.8432542, -6.91771566,
+  10.2865086, 9.37137299, -9.00544537, -12.6903239, 11.7444037, -10.7606436, -7.26831798, -11.9594688,
+  8.76929608, 9.36930427, -8.68072957, 12.4699763, 7.77518663, 11.8355844, -13.4586036, 9.53792889,
+  -10.1197234, 7.9564646, 7.46763879, 10.5913298, 9.86149299, -10.2534173, 10.1582905, -10.2575683,
+  -13.1715999, 10.7104117, -12.8126292, 6.98955833, 10.9671647, -11.7366763, -8.60927546, -8.00780155,
+  -13.2399769, 10.2440838, -13.8479354, 9.15274946, 11.697247, -10.1972081, -11.1401107, 113.865473
+};
+
+const float reverb_room_gains_r[REVERB_ROOM_MODES] = {
+  -7.29286344, -0.835666208, 0.551673486, -0.51746273, -0.697581075, 1.12398239, 1.35413993, 1.47007128,
+  -0.921966592, -0.570420783, -2.58786694, -2.82460423, 3.08326105, 2.44990939, 2.03154184, -1.01620158,
+  1.12501622, 2.2764622, 2.2326949, -2.24339088, -0.812113802, -0.293598858, 0.9772885, 0.87487249,
+  0.716372571, 1.83105358, -1.32331247, -1.02208829, 0.596509096, 1.35061315, -1.37685929, -1.53355355,
+  -1.50544805, -1.12161154, -1.56657532, -2.10866605, 1.47500147, -0.875919002, 0.687058097, -0.479624221,
+  -0.736537651, -0.559141544, -0.690862723, 0.729601625, -0.722086641, 1.64740386, 1.6442945, -1.57123891,
+  -1.40327795, -2.18924909, 1.15233405, 0.199444159, -1.0554473, -2.16184124, 0.818431123, 1.26504419,
+  -0.683426311, 2.05809571, 1.33102978, -0.797339996, 1.05351829, 0.92851101, -1.41169182, -0.733598233,
+  -0.776776848, -0.974490175, 1.43466397, 1.13122955, -1.80417441, -1.07469701, -1.47941404, 3.10332433,
+  1.27008035, 1.25239369, 1.13682171, -0.547042547, 0.995595639, -0.773868906, -1.31036724, -1.17477233,
+  1.05104964, -0.689302892, -1.50797363, 1.41034086, 0.958337699, 1.31427072, -1.23660098, 1.83761033,
+  2.04743555, 2.42333078, -1.35742391, -1.09637451, 0.402038833, -0.656140531, 1.9373868, 1.49575886,
+  1.30106603, -0.556124392, 2.11651334, 1.9238072, -1.5214976, -1.01047759, 0.616038823, -1.24163045,
+  -0.632792054, -0.363486928, -0.763521937, 1.05990295, -1.82865386, 1.59852726, 0.911182095, -2.3348039,
+  2.20281043, 1.11501274, -0.598407847, 1.61597763, -1.63682237, 1.29381094, 0.98222712, -1.49802619,
+  0.752575315, -1.0182488, -2.19240904, -1.89240242, -1.29630906, 1.26209423, -0.907194257, -2.16891873,
+  2.32636624, 1.91864282, 2.09732062, 1.50047593, 2.54735073, -1.8406715, 1.20101499, -1.40279517,
+  1.55425471, 1.49776633, 1.40301103, -0.42639402, 0.934079103, 1.6795239, 2.07659619, -0.693452609,
+  1.66175905, -1.3971889, 0.820847765, 0.916916863, -1.71548972, 1.79269367, 1.76522246, -1.14137803,
+  1.72047475, 2.09330217, 1.76026128, 1.5729211, 0.934070307, 0.534584583, 1.64150638, 1.1476101,
+  2.06413499, 2.44519043, 4.04553912, -3.8288088, -0.9062052, -0.936220709, 2.76254374, 2.72165055,
+  -3.3418136, -2.82815348, -1.3815795, -1.85391677, 1.82515074, 1.41728084, 0.771071367, -1.2754729,
+  2.32713619, 2.99590066, -0.888976128, 1.47840843, 1.00102694, -0.810627876, 2.11996412, -0.983864967,
+  0.489737843, 1.49683483, -0.931755473, 2.86802934, -3.98394292, -1.61780252, 0.808601967, 0.979908335,
+  -1.50038811, 1.4971873, 3.00790515, -4.79769409, -1.49273029, -0.975147851, 1.02876762, 1.99773965,
+  -1.70866752, 1.45253956, -0.836608575, 0.886136051, 1.11592814, -1.75578486, -1.09842535, 1.10446884,
+  1.29517096, 2.88343193, -2.46711621, -0.864750484, -1.15573824, 2.33708422, -1.50218189, -2.57861854,
+  -1.45693486, -1.801019, -1.21465685, -2.00038104, 2.32721159, 1.0396921, -2.60567155, -2.01755634,
+  -1.91361904, -1.92976592, 1.71966066, -2.16269459, -1.62450583, -3.98456366, -3.42560797, 1.51424135,
+  -0.607585132, 1.28365786, -1.97666428, 2.30926006, 2.58928138, 1.41981524, -2.00860963, -1.93866604,
+  1.44800009, 1.44500039, 2.66068948, -3.26782313, -2.23111707, 3.12066578, 0.887248712, -1.578153,
+  1.51350626, 2.45969604, 3.12396668, -2.04080749, -2.54090678, -1.3476772, -1.50439021, -1.51883202,
+  -2.0386236, -2.16676579, -2.22921068, 1.81507993, -3.38749069, 3.67012109, 1.57985069, 3.35169124,
+  -4.66652565, -2.51809243, -2.84472911, -2.14422924, -1.47521307, -2.04610515, -3.79712903, 2.87513935,
+  -2.50178957, -2.30913615, -2.5017092, -3.30393882, 3.24281639, -1.89586675, -1.21233267, -1.17160451,
+  -1.04444733, -2.38521131, 1.65990393, 1.53255949, 2.48181879, -2.32308578, -2.16377028, -1.05767471,
+  -3.18552614, 3.42764145, -3.59882282, -1.57732701, -2.05613409, 2.06939917, 2.0896266, -2.4087272,
+  -2.33511907, -2.57393167, -3.40840426, 5.09883814, 3.37162964, -1.8884943, 1.08970326, -2.24883829,
+  2.99305897, 2.98576781, 2.03984311, -2.00515242, 1.53158909, 1.25051293, -2.78354292, 3.96102019,
+  1.08903843, 2.35247143, 3.08782398, -2.13564784, -2.27694022, 3.69952053, 2.81405956, 1.30292804,
+  -2.59907178, -3.69811386, 2.38623578, 1.11966118, -2.13469423, 3.11814135, 3.85078006, 3.51025293,
+  -1.67912248, 2.20133652, -1.95369363, 3.57993856, -1.25062113, 3.21115889, -2.49584128, 3.04261001,
+  2.68625846, -3.68765335, -2.2195816, 2.19806073, -1.53106561, 1.67328489, -2.23608252, 1.91122559,
+  1.30396025, -1.02466949, -2.92029596, 1.56102813, 2.60619506, 1.29436296, -2.01973741, 2.40594337,
+  -2.84417073, -2.52446103, 3.2744849, -3.36704014, -4.74052943, -1.99278402, 1.16640775, -1.94124311,
+  -3.77408452, 3.46366623, 1.85089641, 2.60373466, -1.9070382, -0.893772216, -1.88162352, 1.86923133,
+  1.3400378, -2.23498943, 1.87211669, -3.30884864, -1.51520275, -1.9627153, 2.54579568, 4.30933379,
+  -4.25439189, -3.17489658, -2.32799032, 0.884901469, -2.14679351, -1.67030811, -2.27006758, 1.9304373,
+  3.27007686, -1.83950675, -2.76124081, -3.13357256, -2.2672164, -1.69055126, -3.34935718, -1.51112024,
+  -3.6460562, -1.57789598, -2.73494443, -2.73512724, 2.43240372, 1.34459118, -2.14129508, -3.60434837,
+  4.37304681, 3.53284736, 2.89668042, 2.39700827, 2.21613864, -1.9246437, 2.15410821, -2.36970954,
+  -1.56064566, -4.88899999, -3.84364587, 2.57504232, -3.46187008, 3.60258755, -2.49308055, 1.68141691,
+  1.72102914, 2.90340192, -3.72990076, 4.8296357, -3.78213742, 2.51049127, 1.75480527, 2.03284518,
+  1.84221978, -0.942134547, 3.98280663, -2.05762419, 2.56813304, 2.02079289, 2.50453015, 4.75723812,
+  -1.71863349, -1.6669434, -1.66844294, 3.38862439, 3.54750997, 2.59010661, 2.11232421, 2.09992405,
+  1.67146231, 3.35059588, 2.13415269, -2.82309599, -2.37492194, 3.95430641, 7.98964609, -2.99246569,
+  -2.57635866, 3.00830943, -1.28792455, 1.57914398, -2.80216372, 2.59220299, 2.2039815, -3.15279129,
+  4.00323737, -3.52389836, 2.22164335, -2.90820562, -2.78287212, 3.21238681, -3.94388814, -1.55456166,
+  3.43023341, -2.57234877, 1.89222947, -2.53415744, -2.73308867, -1.7469252, 1.53920206, -3.29484559,
+  5.16733764, -3.33242343, -2.42994885, 2.54901848, -4.89803302, -7.70971435, 2.60748499, -4.39246163,
+  3.00057128, -3.10347558, 3.1548747, -2.59565795, 2.94921253, -1.87517458, 3.2229135, -3.78422388,
+  -3.3504649, -2.87992611, 5.22838134, 2.21225198, 3.66717065, 2.12109029, 2.55605308, 4.40976332,
+  -2.70525331, 1.70454852, 2.20867365, -2.72433238, 2.43191366, -2.83312792, 2.99771801, 3.42831948,
+  3.68953134, -5.76995387, 2.31901605, -3.38437194, 1.15185135, 3.87937904, -3.28356605, 6.35129847,
+  -3.50170944, 4.27046341, 3.30616287, -3.66568618, -2.25397565, 3.57557749, 4.58608539, -4.50279142,
+  -4.16488553, -1.79002682, -2.94669541, 2.52626238, 5.38781734, -4.41720921, 2.33428311, -4.03352804,
+  2.70231015, -2.57304303, 4.81559897, 4.32428457, 3.00515512, -4.78688959, -6.50137521, -4.96661767,
+  -3.67336165, 3.14747817, -2.49191575, -4.82674082, -5.26557382, -3.48596529, -4.49819291, 3.47948794,
+  5.5181027, 4.1879314, 4.14751897, 2.93188457, 4.05302741, 3.78156626, -5.40259946, 1.96537494,
+  5.00445978, 4.76264683, 6.79425947, -4.23899686, 4.9308505, -5.27215203, 2.02871548, 2.39802968,
+  -2.56939335, 2.3677057, -6.10413323, -5.15265151, 1.55187692, -6.70620639, -6.45554169, -4.58769452,
+  4.86528806, -3.01576356, -3.5594149, -4.03374972, 5.40526902, -4.2676949, -4.12477472, -3.56664098,
+  6.10006375, 5.75397869, -4.40792553, -3.83006204, 4.11220637, -4.83584449, -3.55242282, -4.27540581,
+  6.2555035, -5.94213114, 3.95838349, 3.43596717, 3.20177686, -3.91826662, -5.96208554, 2.81800052,
+  2.59771653, 5.48026095, -7.14074815, -4.48838651, -3.44586259, -3.04221345, 2.61082565, -3.51480494,
+  2.80996106, -3.65925067, -4.17893535, -2.70584785, -2.57851492, -7.84395549, -2.59602705, 5.43818167,
+  4.50259956, -2.75576047, -4.14911241, 5.89754143, 3.30031263, 4.09349306, -2.51095747, -2.57489702,
+  -3.66965302, -5.0961791, -9.81411702, 4.89654175, -4.63523155, -3.36820377, -4.5768104, -3.30450235,
+  2.16501626, -3.2379798, 2.04495067, -6.43841887, 4.3092034, -4.24370126, 3.13916373, 5.33452757,
+  -3.9694778, -4.10149597, -3.98561954, -6.14856716, 3.94294759, 4.53643383, 3.73025735, 4.8218739,
+  -6.23447933, -7.7271126, -4.57565645, 6.7080021, -3.16307937, -3.88015035, -3.92000479, -3.48569469,
+  2.5214984, 4.45185176, 5.03522017, -5.40256414, -3.27005877, -2.96350132, 5.20382097, -4.44558845,
+  -4.04692211, 5.56831435, -4.93243908, -3.59363117, -5.43107728, -4.39220209, -2.84755288, -5.74209358,
+  5.29216572, 5.14413492, -3.43010191, -4.37330634, 3.31305027, 3.50264728, 4.93314655, 5.21703733,
+  -3.76921097, -4.95499803, -5.78933924, -2.8473479, 3.77798283, -5.49683356, -5.44851538, -8.20923223,
+  -5.85528938, 6.07060868, -3.40286086, -6.37072895, -5.24052123, -4.69482732, -4.04621784, 4.82983379,
+  -4.28430111, -4.83963259, -5.53006218, -4.35538826, -3.52692604, -5.37065228, -5.09987143, 6.17334641,
+  3.54192445, -3.96047572, 4.97167014, 3.32513167, 5.24395633, -5.58648041, -6.70715209, -9.12257317,
+  -2.97689137, 4.62058103, -5.41525225, -6.78731845, 4.61413721, -6.08562986, -4.36128019, -4.31218005,
+  -6.56770008, -4.40342287, -9.08759183, -7.79898865, 4.20597259, 10.3374357, 2.80025872, -2.32981814,
+  4.52472652, 4.22642255, 5.28401153, 2.77236646, -5.32965332, 4.73778366, -5.42081437, 7.37200112,
+  5.22156203, -3.85649084, -5.80391046, -8.2620239, -9.75164809, -6.03381731, -5.04974123, 4.94562741,
+  4.64590208, -6.70933702, 4.41862202, 6.05126237, -5.81917599, 5.14821626, 7.12261111, -5.36870739,
+  8.103563, 6.56675856, 6.35036769, -8.53055329, -5.28791504, 3.75231851, 5.96139539, -5.9087871,
+  5.27109399, -7.41234177, -8.92202615, 8.37142822, -5.8927788, -6.6852244, 8.64335204, -7.8660779,
+  -4.48954265, 5.20481387, -5.27731212, -5.48429173, 2.71336, -4.30817029, 4.57003409, -5.430976,
+  -5.1513802, -7.94204674, -6.99416305, 8.22507651, 3.48472076, 6.28254149, -6.47542439, -8.47093865,
+  -6.27416004, -6.41614987, 10.1107977, 4.99784672, 7.22105732, -4.59882699, -6.26046312, 6.30244174,
+  -5.36122459, 6.17475154, 6.26266232, -4.90013686, -5.25243917, -8.93653371, -10.2328444, 8.80515948,
+  7.6774759, 6.85473201, 4.33136078, 6.40409592, 4.5352221, 8.57774528, -6.04176402, 4.16228123,
+  -6.78719722, -6.8316899, -5.47604003, -6.16561002, 6.96073925, 6.48897512, -4.73926771, 5.55365413,
+  -7.95301107, 4.57831918, -8.36407718, 7.71060451, 5.53719405, -8.8022399, 8.14918547, -10.8797434,
+  -7.58754601, -7.53421355, 7.04393114, 5.28094986, -12.9259569, -6.52363674, -4.35702913, -6.55641477,
+  -10.0278847, 9.10403375, -5.02406811, -5.44006622, -6.88980311, 9.90583576, 7.48839906, -3.5392611,
+  -4.82841814, -7.62109834, -6.74636273, -5.8807786, -4.73711258, 6.67787402, 7.74196443, 6.51053252,
+  6.96479109, -7.83688735, 9.0779334, -6.0375818, 7.89652282, 8.6339643, 7.02222657, -4.80111916,
+  5.59633906, -6.26182419, -2.87159495, 5.71722481, -6.39235917, 6.45569066, -6.8109491, -7.06748242,
+  -10.1127862, -8.54677075, 8.4421817, -7.35133713, 8.88910547, -7.45676208, -5.23306231, 6.6041461,
+  -7.07584661, 10.0711927, 9.06603441, 5.02520108, -7.41939575, 7.83340134, 10.954301, -6.87105916,
+  -5.99029902, -6.43637812, 9.03384416, 6.96227685, 4.87974812, 5.74960064, -7.4513134, 6.27318204,
+  8.7319333, -6.98567905, -7.56902854, 5.9332345, 7.56522421, -7.70475931, -6.54755201, -7.70531846,
+  9.14835032, -8.37622057, 10.8226185, -8.51262394, -6.94383552, -5.5534474, -10.2487079, 10.0583849,
+  8.75541771, 9.78689148, -10.4511698, 8.05450333, 8.17922508, 9.1707178, 8.49237003, -7.27608746,
+  -5.30952401, 7.80829817, 8.8604278, 7.99496622, -9.03216216, -8.53765777, -6.04379463, 8.41923192,
+  7.94737279, -8.06203412, 9.62066248, -8.84771522, 8.87900591, -6.14608653, -10.2757924, 14.8658501,
+  13.5699703, -10.3273447, 8.92125857, 7.94342799, 6.72678453, 6.02530082, 7.40377508, -11.4591393,
+  -5.10166721, 7.91119472, 7.35791371, 10.9026388, 9.54369003, -6.84286809, -10.1895056, 8.08862232,
+  -6.2141638, -10.103789, -8.88985529, -8.35057632, -8.86002179, -7.95794049, -8.72402554, -8.3653746,
+  -11.5691712, -8.84743642, -6.29244393, -7.78827233, 6.57481223, -10.7536035, 11.3120112, 12.1758595,
+  8.14168959, 6.63760714, -8.12392991, -9.19458062, -7.94481803, 9.77647346, -12.2784728, 8.94616946,
+  10.1975004, -10.3052075, -9.30136303, -9.7332443, 10.017361, -9.2064087, -11.8982394, 8.30562113,
+  7.20171199, -8.36949208, 11.6058368, 10.6067195, -6.7407398, 10.4379699, 11.1813362, 9.12765587,
+  8.57214825, -11.873797, 5.9293614, -8.6395682, 10.5227828, 7.76337974, 9.50313862, 7.92999776,
+  -9.81500912, -8.19802664, 7.16245794, 9.89469555, 5.64246682, 8.31397414, -10.6570241, -7.39459296,
+  11.2966865, 10.0944923, 10.8789173, -9.70144415, 7.14257611, -9.2875617, -10.5717144, 7.09893838,
+  -10.1135409, 8.7977994, -6.84777926, 7.49294351, 8.85046032, -8.38070101, -10.3648981, -9.06829616,
+  7.49747348, 10.7852259, 9.62577873, 9.31644165, 11.2167829, -13.3041413, 6.24112639, -8.15023444,
+  -10.5074057, 11.7909358, 7.40815553, -10.503678, 10.9854565, 8.62732995, -14.8916539, 113.319977
+};
+
+const stereo_mode_set reverb_room = {
+  REVERB_ROOM_MODES, reverb_room_freqs, reverb_room_res, reverb_room_gains_l, reverb_room_gains_r
+};
+#endif
+#endif
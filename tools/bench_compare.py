@@ -0,0 +1,63 @@
+#!/usr/bin/env python3
+"""
+Compare two runs of host/bench and flag regressions.
+
+    tools/bench_compare.py baseline.csv current.csv [--threshold 5] [--all]
+
+Rows are matched on name,fs,block,modes,voices. A row regresses when its ns
+per sample/call grows by more than the threshold (percent). Exits with status
+1 if anything regressed so it can gate a build.
+"""
+
+import argparse
+import csv
+import sys
+
+KEY = ("name", "fs", "block", "modes", "voices")
+
+
+def load(path):
+    with open(path) as f:
+        return {tuple(row[k] for k in KEY): row for row in csv.DictReader(f)}
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("baseline")
+    ap.add_argument("current")
+    ap.add_argument("--threshold", type=float, default=5.0, help="regression threshold in percent")
+    ap.add_argument("--all", action="store_true", help="print unchanged rows too")
+    args = ap.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+
+    regressions = 0
+    improvements = 0
+    print("%-32s %7s %5s %5s %6s %10s %10s %8s" % ("name", "fs", "block", "modes", "voices", "base ns", "cur ns", "change"))
+    for key in sorted(cur, key=lambda k: (k[0], float(k[1]), int(k[2]), int(k[3]), int(k[4]))):
+        if key not in base:
+            continue
+        b = float(base[key]["ns"])
+        c = float(cur[key]["ns"])
+        change = 100.0 * (c - b) / b if b > 0 else 0.0
+        if change > args.threshold:
+            flag = "REGRESSED"
+            regressions += 1
+        elif change < -args.threshold:
+            flag = "improved"
+            improvements += 1
+        elif args.all:
+            flag = ""
+        else:
+            continue
+        print("%-32s %7s %5s %5s %6s %10.3f %10.3f %+7.1f%% %s" % (key + (b, c, change, flag)))
+
+    missing = [k for k in base if k not in cur]
+    print("\n%d regressed, %d improved, %d compared, %d missing from current run"
+          % (regressions, improvements, len([k for k in cur if k in base]), len(missing)))
+    sys.exit(1 if regressions else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,264 @@
+#!/usr/bin/env python3
+"""
+Fit a bank of decaying modes to a room impulse response and write it as a
+stereo_mode_set header for modal_reverb.
+
+    tools/fit_modes.py ir.wav [--modes 1024] [--name reverb_room] > reverb_room.h
+    tools/fit_modes.py --synth 2.2 [--seed 1] > reverb_room.h
+
+The IR must be PCM at the rate the firmware runs at (48k by default, see --fs).
+Mono IRs give the same gains on both channels.
+--synth fits a synthetic stereo room instead: decorrelated noise per channel
+decaying with T60 falling from the given value at 100 Hz to a third of it at 10k.
+
+Mode frequencies are spread evenly on the ERB scale between --fmin and --fmax,
+jittered so the bank doesn't ring at regular spacings. Each mode decays with the
+IR's T60 at its frequency, read off per-band Schroeder curves. Both channels'
+amplitudes start from a least squares fit of the modes' impulse responses
+r^n cos(wn) to the IR, using their closed form inner products. A diffuse tail has
+far more detail than the modes can follow, so each amplitude is then scaled to
+carry the IR's energy over the stretch of spectrum its mode covers and only the
+fit's signs, which set the early phase and the stereo image, are kept.
+
+The gains written are scaled for the voice's 1/num_modes output normalisation and
+the resonator's 2 g r peak amplitude, so the bank's impulse response is the IR.
+Needs numpy.
+"""
+
+import argparse
+import sys
+import wave
+
+import numpy as np
+
+STFT_LEN = 2048
+STFT_HOP = 512
+# The part of each band's Schroeder curve the decay is read from, dB below its start
+EDC_FROM = -5.0
+EDC_TO = -35.0
+T60_MIN = 0.05
+T60_MAX = 14.0  # the longest RES_MAX allows at 48k
+
+
+def read_wav(path):
+    with wave.open(path, "rb") as w:
+        fs = w.getframerate()
+        ch = w.getnchannels()
+        width = w.getsampwidth()
+        raw = w.readframes(w.getnframes())
+    if width == 2:
+        x = np.frombuffer(raw, dtype="<i2").astype(np.float64) / 32768.0
+    elif width == 3:
+        b = np.frombuffer(raw, dtype=np.uint8).reshape(-1, 3).astype(np.int32)
+        v = b[:, 0] | (b[:, 1] << 8) | (b[:, 2] << 16)
+        v = np.where(v & 0x800000, v - (1 << 24), v)
+        x = v.astype(np.float64) / 8388608.0
+    elif width == 4:
+        x = np.frombuffer(raw, dtype="<i4").astype(np.float64) / 2147483648.0
+    else:
+        sys.exit("%s: unsupported sample width %d" % (path, width))
+    x = x.reshape(-1, ch).T
+    if ch == 1:
+        x = np.vstack([x, x])
+    return fs, x[:2]
+
+
+def synth_ir(fs, t60, seed):
+    rng = np.random.default_rng(seed)
+    n = int(fs * t60 * 1.2)
+    spec_len = 1 << int(np.ceil(np.log2(n)))
+    f = np.fft.rfftfreq(spec_len, 1.0 / fs)
+    # T60 from t60 at 100 Hz down to t60 / 3 at 10k, log in frequency
+    octs = np.clip(np.log2(np.maximum(f, 1) / 100.0) / np.log2(100.0), 0, 1)
+    t60_f = t60 / (3.0 ** octs)
+    t = np.arange(n) / fs
+    ir = np.zeros((2, n))
+    for c in range(2):
+        # White noise split into bands of 64 bins, each with its own decay
+        noise = rng.standard_normal(spec_len)
+        spec = np.fft.rfft(noise)
+        out = np.zeros(n)
+        for lo in range(0, len(f), 64):
+            band = np.zeros_like(spec)
+            band[lo:lo + 64] = spec[lo:lo + 64]
+            env = 10 ** (-3 * t / t60_f[min(lo + 32, len(f) - 1)])
+            out += np.fft.irfft(band, spec_len)[:n] * env
+        ir[c] = out
+    ir /= np.max(np.abs(ir))
+    return ir
+
+
+def trim_onset(ir, thresh_db=-40.0):
+    env = np.max(np.abs(ir), axis=0)
+    above = np.nonzero(env > np.max(env) * 10 ** (thresh_db / 20))[0]
+    return ir[:, above[0]:] if len(above) else ir
+
+
+def band_t60(ir, fs):
+    """T60 in seconds at each STFT bin frequency, from both channels' energy"""
+    frames = max(1, (ir.shape[1] - STFT_LEN) // STFT_HOP + 1)
+    win = np.hanning(STFT_LEN)
+    energy = np.zeros((frames, STFT_LEN // 2 + 1))
+    for c in range(2):
+        for k in range(frames):
+            seg = ir[c, k * STFT_HOP:k * STFT_HOP + STFT_LEN]
+            seg = np.pad(seg, (0, STFT_LEN - len(seg)))
+            energy[k] += np.abs(np.fft.rfft(seg * win)) ** 2
+    # Schroeder backward integration per band
+    edc = np.cumsum(energy[::-1], axis=0)[::-1]
+    edc_db = 10 * np.log10(edc / np.maximum(edc[0], 1e-30) + 1e-30)
+    t = np.arange(frames) * STFT_HOP / fs
+    t60 = np.full(edc.shape[1], np.nan)
+    for b in range(edc.shape[1]):
+        sel = (edc_db[:, b] <= EDC_FROM) & (edc_db[:, b] >= EDC_TO)
+        if np.count_nonzero(sel) < 3:
+            continue
+        slope = np.polyfit(t[sel], edc_db[sel, b], 1)[0]
+        if slope < 0:
+            t60[b] = -60.0 / slope
+    f = np.fft.rfftfreq(STFT_LEN, 1.0 / fs)
+    good = ~np.isnan(t60)
+    if not np.any(good):
+        sys.exit("couldn't read a decay from the IR, is it long enough?")
+    t60 = np.interp(f, f[good], t60[good])
+    # Smooth over about a third of an octave
+    out = np.empty_like(t60)
+    for b in range(len(f)):
+        lo = np.searchsorted(f, f[b] / 1.12)
+        hi = max(np.searchsorted(f, f[b] * 1.12), lo + 1)
+        out[b] = np.median(t60[lo:hi])
+    return f, np.clip(out, T60_MIN, T60_MAX)
+
+
+def erb_rate(f):
+    return 21.4 * np.log10(1 + 0.00437 * f)
+
+
+def erb_rate_inv(e):
+    return (10 ** (e / 21.4) - 1) / 0.00437
+
+
+def place_modes(n, fmin, fmax, seed):
+    rng = np.random.default_rng(seed)
+    e = np.linspace(erb_rate(fmin), erb_rate(fmax), n)
+    step = e[1] - e[0] if n > 1 else 0
+    e = e + rng.uniform(-0.3, 0.3, n) * step
+    return np.sort(erb_rate_inv(e))
+
+
+def fit_amplitudes(ir, w, r, chunk=4096):
+    """Least squares amplitudes of r^n cos(wn) for each channel of ir"""
+    m = len(w)
+    n_total = ir.shape[1]
+    c = np.zeros((2, m))
+    for start in range(0, n_total, chunk):
+        n = np.arange(start, min(start + chunk, n_total))
+        basis = (r[:, None] ** n[None, :]) * np.cos(w[:, None] * n[None, :])
+        c += ir[:, n] @ basis.T
+    # sum over n >= 0 of (ri rj)^n cos(wi n) cos(wj n)
+    rr = r[:, None] * r[None, :]
+    g = 0.5 * np.real(1 / (1 - rr * np.exp(1j * (w[:, None] - w[None, :])))
+                      + 1 / (1 - rr * np.exp(1j * (w[:, None] + w[None, :]))))
+    g += np.diag(np.diag(g)) * 1e-4
+    return np.linalg.solve(g, c.T).T, np.diag(g)
+
+
+def band_energy(ir, freqs, fs):
+    """Each channel's energy between the midpoints either side of each mode"""
+    spec = np.abs(np.fft.rfft(ir, axis=1)) ** 2
+    f = np.fft.rfftfreq(ir.shape[1], 1.0 / fs)
+    # Parseval for a real signal: every bin but DC and Nyquist stands for two
+    spec[:, 1:-1] *= 2
+    spec /= ir.shape[1]
+    edges = np.concatenate([[0], 0.5 * (freqs[1:] + freqs[:-1]), [fs / 2]])
+    cum = np.concatenate([np.zeros((2, 1)), np.cumsum(spec, axis=1)], axis=1)
+    idx = np.searchsorted(f, edges)
+    return cum[:, idx[1:]] - cum[:, idx[:-1]]
+
+
+def render(a, w, r, n_total, chunk=4096):
+    out = np.zeros((2, n_total))
+    for start in range(0, n_total, chunk):
+        n = np.arange(start, min(start + chunk, n_total))
+        basis = (r[:, None] ** n[None, :]) * np.cos(w[:, None] * n[None, :])
+        out[:, n] = a @ basis
+    return out
+
+
+def write_header(out, name, source, fs, freqs, res, gains, t60):
+    n = len(freqs)
+    guard = "DSY_%s_H" % name.upper()
+
+    def table(values):
+        rows = []
+        for i in range(0, n, 8):
+            rows.append("  " + ", ".join("%.9g" % v for v in values[i:i + 8]))
+        return ",\n".join(rows)
+
+    out.write("#pragma once\n#ifndef %s\n#define %s\n\n" % (guard, guard))
+    out.write('#include "mode_set.h"\n\n')
+    out.write("#define %s_MODES %d\n\n" % (name.upper(), n))
+    out.write("#ifdef __cplusplus\n\n")
+    out.write("/*\n * Generated by tools/fit_modes.py from %s - don't edit\n" % source)
+    out.write(" * %d modes %.0f to %.0f Hz at %d Hz, T60 %.2f to %.2f s\n */\n\n"
+              % (n, freqs[0], freqs[-1], fs, np.min(t60), np.max(t60)))
+    out.write("// Fixed frequencies, negative as in mode_set\n")
+    out.write("const float %s_freqs[%s_MODES] = {\n%s\n};\n\n" % (name, name.upper(), table(-freqs)))
+    out.write("const float %s_res[%s_MODES] = {\n%s\n};\n\n" % (name, name.upper(), table(res)))
+    out.write("const float %s_gains_l[%s_MODES] = {\n%s\n};\n\n" % (name, name.upper(), table(gains[0])))
+    out.write("const float %s_gains_r[%s_MODES] = {\n%s\n};\n\n" % (name, name.upper(), table(gains[1])))
+    out.write("const stereo_mode_set %s = {\n  %s_MODES, %s_freqs, %s_res, %s_gains_l, %s_gains_r\n};\n"
+              % (name, name.upper(), name, name, name, name))
+    out.write("#endif\n#endif\n")
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("ir", nargs="?", help="impulse response, PCM wav")
+    ap.add_argument("--synth", type=float, metavar="T60", help="fit a synthetic room with this low frequency T60 instead")
+    ap.add_argument("--seed", type=int, default=1)
+    ap.add_argument("--fs", type=int, default=48000, help="the firmware's sample rate")
+    ap.add_argument("--modes", type=int, default=1024)
+    ap.add_argument("--fmin", type=float, default=40.0)
+    ap.add_argument("--fmax", type=float, default=16000.0)
+    ap.add_argument("--length", type=float, default=4.0, help="seconds of the IR to fit, at most")
+    ap.add_argument("--name", default="reverb_room", help="prefix for the header's tables")
+    args = ap.parse_args()
+
+    if args.synth:
+        fs = args.fs
+        ir = synth_ir(fs, args.synth, args.seed)
+        source = "a synthetic room, T60 %.2f s, seed %d" % (args.synth, args.seed)
+    elif args.ir:
+        fs, ir = read_wav(args.ir)
+        if fs != args.fs:
+            sys.exit("%s is at %d Hz, resample it to %d first" % (args.ir, fs, args.fs))
+        source = args.ir.split("/")[-1]
+    else:
+        ap.error("give an IR or --synth")
+
+    ir = trim_onset(ir)[:, :int(args.length * fs)]
+    fmax = min(args.fmax, 0.45 * fs)
+
+    f, t60_f = band_t60(ir, fs)
+    freqs = place_modes(args.modes, args.fmin, fmax, args.seed)
+    t60 = np.interp(freqs, f, t60_f)
+    res = 10 ** (-3.0 / (t60 * fs))
+    w = 2 * np.pi * freqs / fs
+
+    amps, norm = fit_amplitudes(ir, w, res)
+    amps = np.where(amps < 0, -1.0, 1.0) * np.sqrt(band_energy(ir, freqs, fs) / norm)
+    # Mode impulse response is 2 g r r^n cos(wn) / num_modes
+    gains = amps * args.modes / (2 * res)
+
+    model = render(amps, w, res, ir.shape[1])
+    level = 10 * np.log10(np.sum(model ** 2, axis=1) / np.sum(ir ** 2, axis=1))
+    corr = np.sum(model[0] * model[1]) / np.sqrt(np.sum(model[0] ** 2) * np.sum(model[1] ** 2))
+    sys.stderr.write("%d modes, level %+.1f/%+.1f dB against the IR, L/R correlation %.2f, T60 %.2f to %.2f s\n"
+                     % (args.modes, level[0], level[1], corr, np.min(t60), np.max(t60)))
+
+    write_header(sys.stdout, args.name, source, fs, freqs, res, gains, t60)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""
+Turn a Scala scale (and optionally a keyboard mapping) into a tuning table for
+modal_engine::SetTuning: one frequency in Hz for each of the 128 MIDI notes.
+
+    tools/scl_to_tuning.py scale.scl [map.kbm] [--name tuning_scale] > tuning_scale.h
+    tools/scl_to_tuning.py scale.scl [map.kbm] --bin tuning.bin
+
+The header holds a const float table that lands in flash. --bin writes the same
+128 floats little endian (512 bytes) instead, for loading into memory at run time.
+
+Without a .kbm the mapping is Scala's default: the scale starts on note 60,
+every key is mapped in order and note 69 is 440 Hz. Keys a .kbm leaves unmapped
+(x) or outside its first..last range get 0 Hz, which the engine doesn't play.
+"""
+
+import argparse
+import struct
+import sys
+
+NOTES = 128
+
+
+def data_lines(path):
+    """Non-comment lines, Scala files comment with a leading !"""
+    with open(path) as f:
+        for line in f:
+            line = line.strip()
+            if line.startswith("!"):
+                continue
+            yield line
+
+
+def parse_pitch(text):
+    """A scale degree as a frequency ratio: cents if it has a dot, otherwise a ratio or an integer"""
+    word = text.split()[0]
+    if "." in word:
+        return 2 ** (float(word) / 1200)
+    if "/" in word:
+        num, den = word.split("/")
+        return int(num) / int(den)
+    return float(int(word))
+
+
+def read_scl(path):
+    lines = data_lines(path)
+    description = next(lines)
+    count = int(next(lines).split()[0])
+    ratios = []
+    for line in lines:
+        if not line:
+            continue
+        ratios.append(parse_pitch(line))
+        if len(ratios) == count:
+            break
+    if len(ratios) != count:
+        sys.exit("%s: expected %d pitches, found %d" % (path, count, len(ratios)))
+    # Degree 0 is the unison, the last pitch is the period
+    return description, [1.0] + ratios
+
+
+def read_kbm(path):
+    lines = [l for l in data_lines(path) if l]
+    size = int(lines[0].split()[0])
+    kbm = {
+        "size": size,
+        "first": int(lines[1].split()[0]),
+        "last": int(lines[2].split()[0]),
+        "middle": int(lines[3].split()[0]),
+        "ref_note": int(lines[4].split()[0]),
+        "ref_freq": float(lines[5].split()[0]),
+        "octave": int(lines[6].split()[0]),
+    }
+    mapping = []
+    for line in lines[7:7 + size]:
+        word = line.split()[0]
+        mapping.append(None if word.lower() == "x" else int(word))
+    # Missing entries at the end are unmapped
+    mapping += [None] * (size - len(mapping))
+    kbm["map"] = mapping
+    return kbm
+
+
+def default_kbm(degrees):
+    return {"size": 0, "first": 0, "last": NOTES - 1, "middle": 60,
+            "ref_note": 69, "ref_freq": 440.0, "octave": degrees, "map": []}
+
+
+def note_ratio(note, kbm, scale):
+    """note's pitch relative to the middle note, None if it is unmapped"""
+    degrees = len(scale) - 1
+    period = scale[-1]
+    steps = note - kbm["middle"]
+    if kbm["size"] == 0:
+        octaves, degree = divmod(steps, degrees)
+        return scale[degree] * period ** octaves
+    octaves, index = divmod(steps, kbm["size"])
+    degree = kbm["map"][index]
+    if degree is None:
+        return None
+    # The mapping repeats every size keys, moving by the scale's formal octave
+    octave_degree = kbm["octave"] or degrees
+    total = degree + octaves * octave_degree
+    o, d = divmod(total, degrees)
+    return scale[d] * period ** o
+
+
+def tuning(scale, kbm):
+    ref = note_ratio(kbm["ref_note"], kbm, scale)
+    if ref is None:
+        sys.exit("the reference note %d is unmapped" % kbm["ref_note"])
+    base = kbm["ref_freq"] / ref
+    freqs = []
+    for n in range(NOTES):
+        r = note_ratio(n, kbm, scale) if kbm["first"] <= n <= kbm["last"] else None
+        freqs.append(0.0 if r is None else base * r)
+    return freqs
+
+
+def write_header(out, name, source, description, freqs):
+    guard = "DSY_%s_H" % name.upper()
+    rows = []
+    for i in range(0, NOTES, 8):
+        rows.append("  " + ", ".join("%.9g" % f for f in freqs[i:i + 8]))
+    sounding = [f for f in freqs if f > 0]
+
+    out.write("#pragma once\n#ifndef %s\n#define %s\n\n" % (guard, guard))
+    out.write('#include "tuning.h"\n\n')
+    out.write("#ifdef __cplusplus\n\n")
+    out.write("/*\n * Generated by tools/scl_to_tuning.py from %s - don't edit\n" % source)
+    out.write(" * %s\n" % description.replace("*/", "* /"))
+    out.write(" * %d mapped notes, %.2f to %.2f Hz\n */\n\n" % (len(sounding), min(sounding), max(sounding)))
+    out.write("// Hz for each MIDI note, 0 for unmapped keys\n")
+    out.write("const float %s[TUNING_NOTES] = {\n%s\n};\n" % (name, ",\n".join(rows)))
+    out.write("#endif\n#endif\n")
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("scl", help="Scala scale")
+    ap.add_argument("kbm", nargs="?", help="Scala keyboard mapping")
+    ap.add_argument("--name", default="tuning_scale", help="name of the header's table")
+    ap.add_argument("--bin", metavar="FILE", help="write 128 little endian floats here instead of a header")
+    args = ap.parse_args()
+
+    description, scale = read_scl(args.scl)
+    kbm = read_kbm(args.kbm) if args.kbm else default_kbm(len(scale) - 1)
+    freqs = tuning(scale, kbm)
+    sounding = [f for f in freqs if f > 0]
+    if not sounding:
+        sys.exit("no notes are mapped")
+    sys.stderr.write("%s: %d degrees, %d mapped notes, %.2f to %.2f Hz\n"
+                     % (description, len(scale) - 1, len(sounding), min(sounding), max(sounding)))
+
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(struct.pack("<%df" % NOTES, *freqs))
+        return
+    source = args.scl.split("/")[-1]
+    if args.kbm:
+        source += " and " + args.kbm.split("/")[-1]
+    write_header(sys.stdout, args.name, source, description, freqs)
+
+
+if __name__ == "__main__":
+    main()
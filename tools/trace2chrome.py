@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""
+Convert a ModalResonators trace dump into Chrome/Perfetto trace JSON.
+
+Build with MODAL_TRACE defined, capture the USB serial output while pressing
+the encoder, then:
+
+    tools/trace2chrome.py capture.txt > trace.json
+
+and open trace.json in chrome://tracing or https://ui.perfetto.dev
+
+Event numbering must match trace_event/trace_param in trace_ring.h
+"""
+
+import json
+import sys
+
+CB_START, CB_END, NOTE_ON, PING, CC, PRESET, STEAL, RECALC, GOVERN = range(9)
+PARAMS = ["fc", "r", "g", "stiffness", "beta", "mgf", "ifc"]
+
+TID_AUDIO = 1
+TID_MIDI = 2
+TID_VOICE = 10  # + voice index
+
+
+def read_dump(lines):
+    """Yield (cycles_per_second, [(ts, type, a, b), ...]) for each dump in the capture"""
+    events = None
+    hz = None
+    for line in lines:
+        line = line.strip()
+        if line.startswith("TRACE_BEGIN"):
+            hz = int(line.split()[1])
+            events = []
+        elif line.startswith("TRACE_END"):
+            if events is not None:
+                yield hz, events
+            events = None
+        elif events is not None and line:
+            try:
+                events.append(tuple(int(f) for f in line.split(",")))
+            except ValueError:
+                pass  # garbage on the serial line
+
+
+def unwrap(events):
+    """The cycle counter is 32 bits and wraps every few seconds - make it monotonic"""
+    out = []
+    offset = 0
+    last = None
+    for ts, typ, a, b in events:
+        if last is not None and ts < last and (last - ts) > (1 << 31):
+            offset += 1 << 32
+        last = ts
+        out.append((ts + offset, typ, a, b))
+    return out
+
+
+def convert(hz, events):
+    events = unwrap(events)
+    if not events:
+        return []
+    t0 = events[0][0]
+    us = lambda ts: (ts - t0) * 1e6 / hz
+
+    trace = [
+        {"ph": "M", "pid": 1, "tid": TID_AUDIO, "name": "thread_name", "args": {"name": "audio callback"}},
+        {"ph": "M", "pid": 1, "tid": TID_MIDI, "name": "thread_name", "args": {"name": "midi / main loop"}},
+    ]
+    voices = set()
+    open_cb = False
+    flow_id = 0
+    pending = {}  # voice -> flow id of the note on waiting for its ping
+
+    for ts, typ, a, b in events:
+        t = us(ts)
+        if typ == CB_START:
+            if open_cb:  # lost the end event to an overwrite
+                trace.append({"ph": "E", "pid": 1, "tid": TID_AUDIO, "ts": t})
+            trace.append({"ph": "B", "pid": 1, "tid": TID_AUDIO, "ts": t, "name": "AudioCallback",
+                          "args": {"size": b}})
+            open_cb = True
+        elif typ == CB_END:
+            if open_cb:
+                trace.append({"ph": "E", "pid": 1, "tid": TID_AUDIO, "ts": t})
+            open_cb = False
+        elif typ == NOTE_ON:
+            flow_id += 1
+            pending[b] = flow_id
+            trace.append({"ph": "i", "s": "t", "pid": 1, "tid": TID_MIDI, "ts": t, "name": "note on",
+                          "args": {"note": a, "voice": b}})
+            trace.append({"ph": "s", "pid": 1, "tid": TID_MIDI, "ts": t, "id": flow_id,
+                          "name": "midi->audio", "cat": "latency"})
+        elif typ == PING:
+            voices.add(b)
+            trace.append({"ph": "i", "s": "t", "pid": 1, "tid": TID_VOICE + b, "ts": t, "name": "ping"})
+            if b in pending:
+                trace.append({"ph": "f", "bp": "e", "pid": 1, "tid": TID_VOICE + b, "ts": t,
+                              "id": pending.pop(b), "name": "midi->audio", "cat": "latency"})
+        elif typ == CC:
+            trace.append({"ph": "i", "s": "t", "pid": 1, "tid": TID_MIDI, "ts": t, "name": "CC %d" % a,
+                          "args": {"value": b}})
+        elif typ == PRESET:
+            trace.append({"ph": "i", "s": "p", "pid": 1, "tid": TID_MIDI, "ts": t, "name": "preset",
+                          "args": {"preset": a}})
+        elif typ == STEAL:
+            voices.add(b)
+            trace.append({"ph": "i", "s": "t", "pid": 1, "tid": TID_VOICE + b, "ts": t, "name": "steal",
+                          "args": {"note": a}})
+        elif typ == RECALC:
+            voices.add(b)
+            name = PARAMS[a] if a < len(PARAMS) else str(a)
+            trace.append({"ph": "i", "s": "t", "pid": 1, "tid": TID_VOICE + b, "ts": t,
+                          "name": "recalc " + name, "cat": "recalc"})
+            trace.append({"ph": "C", "pid": 1, "ts": t, "name": "recalcs", "args": {"voice %d" % b: 1}})
+        elif typ == GOVERN:
+            trace.append({"ph": "i", "s": "p", "pid": 1, "tid": TID_AUDIO, "ts": t, "name": "governor",
+                          "args": {"level": a, "load": b / 1000.0}})
+            trace.append({"ph": "C", "pid": 1, "ts": t, "name": "governor level", "args": {"level": a}})
+
+    if open_cb:
+        trace.append({"ph": "E", "pid": 1, "tid": TID_AUDIO, "ts": us(events[-1][0])})
+
+    for v in sorted(voices):
+        trace.append({"ph": "M", "pid": 1, "tid": TID_VOICE + v, "name": "thread_name",
+                      "args": {"name": "voice %d" % v}})
+    return trace
+
+
+def main():
+    src = open(sys.argv[1]) if len(sys.argv) > 1 else sys.stdin
+    dumps = list(read_dump(src))
+    if not dumps:
+        sys.exit("no TRACE_BEGIN/TRACE_END block found")
+    # Only the most recent dump is converted
+    hz, events = dumps[-1]
+    json.dump({"traceEvents": convert(hz, events), "displayTimeUnit": "ns"}, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
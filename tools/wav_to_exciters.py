@@ -0,0 +1,195 @@
+#!/usr/bin/env python3
+"""
+Pack short recorded transients into an exciter bank for the engine's SAMPLE mode,
+see exciter_bank.h.
+
+    tools/wav_to_exciters.py strike.wav bow.wav@220 breath.wav [--name exciter_blob] > exciter_blob.h
+    tools/wav_to_exciters.py strike.wav bow.wav@220 --bin exciters.bin
+    tools/wav_to_exciters.py --synth > exciter_blob.h
+
+file@Hz gives a transient's pitch as recorded, the engine moves pitched transients to
+each note. Without it a transient plays at its own rate for every note.
+WAVs are mixed to mono, trimmed of leading and trailing silence, resampled to the
+first file's rate and normalised to unit energy, about as loud through the resonators
+as a ping. Samples are stored as int16 with a gain per transient.
+
+The header holds the bank as a const array, the firmware attaches it where it lies
+(internal flash, or QSPI for programs run from there), --bin writes the same bytes
+for a host to memory-map or for loading into SDRAM. --synth makes a small demo bank
+of a strike, a bow and a breath from seeded noise instead of recordings.
+"""
+
+import argparse
+import array
+import math
+import random
+import struct
+import sys
+import wave
+
+MAGIC = 0x3142584d
+MAX_TRANSIENTS = 64
+# Leading and trailing samples below this, relative to the peak, are trimmed
+TRIM_FLOOR = 1e-3
+
+
+def read_wav(path):
+    """(rate, mono float samples) from a PCM WAV"""
+    with wave.open(path, "rb") as w:
+        rate = w.getframerate()
+        channels = w.getnchannels()
+        width = w.getsampwidth()
+        frames = w.readframes(w.getnframes())
+    if width == 1:
+        raw = [b - 128 for b in frames]
+        scale = 128.0
+    elif width == 2:
+        raw = array.array("h", frames)
+        scale = 32768.0
+    elif width == 3:
+        raw = [int.from_bytes(frames[i:i + 3], "little", signed=True) for i in range(0, len(frames), 3)]
+        scale = 8388608.0
+    elif width == 4:
+        raw = array.array("i", frames)
+        scale = 2147483648.0
+    else:
+        sys.exit("%s: unsupported sample width %d" % (path, width))
+    if sys.byteorder != "little" and isinstance(raw, array.array):
+        raw.byteswap()
+    mono = []
+    for i in range(0, len(raw) - channels + 1, channels):
+        mono.append(sum(raw[i:i + channels]) / (channels * scale))
+    return rate, mono
+
+
+def trim(x):
+    peak = max((abs(v) for v in x), default=0)
+    if peak == 0:
+        return []
+    floor = peak * TRIM_FLOOR
+    first = next(i for i, v in enumerate(x) if abs(v) >= floor)
+    last = len(x) - next(i for i, v in enumerate(reversed(x)) if abs(v) >= floor)
+    return x[first:last]
+
+
+def resample(x, src, dst):
+    """Linear interpolation, only for bringing files to one rate"""
+    if src == dst:
+        return x
+    n = int(len(x) * dst / src)
+    out = []
+    for i in range(n):
+        t = i * src / dst
+        j = int(t)
+        f = t - j
+        b = x[j + 1] if j + 1 < len(x) else 0.0
+        out.append(x[j] * (1 - f) + b * f)
+    return out
+
+
+def synth(rate):
+    """A strike, a bow and a breath onset, seeded so the demo bank is repeatable"""
+    rnd = random.Random(0x5EED)
+    strike = [rnd.uniform(-1, 1) * math.exp(-i / (0.002 * rate)) for i in range(int(0.01 * rate))]
+    # Stick-slip: a sawtooth at 220 Hz with noisy slips, swelling in
+    bow = []
+    phase = 0.0
+    for i in range(int(0.02 * rate)):
+        phase += 220.0 / rate
+        phase -= int(phase)
+        env = min(1.0, i / (0.01 * rate))
+        bow.append(env * ((2 * phase - 1) + 0.3 * rnd.uniform(-1, 1)))
+    # Breath: noise through a one pole lowpass under a slow swell and decay
+    breath = []
+    y = 0.0
+    n = int(0.03 * rate)
+    for i in range(n):
+        y += 0.2 * (rnd.uniform(-1, 1) - y)
+        breath.append(math.sin(math.pi * i / n) * y)
+    return [("strike", strike, 0.0), ("bow", bow, 220.0), ("breath", breath, 0.0)]
+
+
+def pack(rate, transients):
+    """The bank's bytes, see exciter_bank.h"""
+    entries = []
+    samples = array.array("h")
+    for name, x, root in transients:
+        energy = math.sqrt(sum(v * v for v in x))
+        if energy == 0:
+            sys.exit("%s is silent" % name)
+        x = [v / energy for v in x]
+        peak = max(abs(v) for v in x)
+        gain = peak / 32767
+        entries.append(struct.pack("<IIff", len(samples), len(x), root, gain))
+        samples.extend(int(round(v / gain)) for v in x)
+    if sys.byteorder != "little":
+        samples.byteswap()
+    head = struct.pack("<IIfI", MAGIC, len(transients), rate, 0)
+    blob = head + b"".join(entries) + samples.tobytes()
+    # Padded to whole words for the header's uint32_t array
+    return blob + b"\0" * (-len(blob) % 4)
+
+
+def write_header(out, name, rate, transients, blob):
+    guard = "DSY_%s_H" % name.upper()
+    words = struct.unpack("<%dI" % (len(blob) // 4), blob)
+    rows = []
+    for i in range(0, len(words), 8):
+        rows.append("  " + ", ".join("0x%08x" % w for w in words[i:i + 8]))
+
+    out.write("#pragma once\n#ifndef %s\n#define %s\n\n" % (guard, guard))
+    out.write('#include "exciter_bank.h"\n\n')
+    out.write("#ifdef __cplusplus\n\n")
+    out.write("// Where the bank is placed, define before including to move it\n")
+    out.write("#ifndef EXCITER_MEM_SECTION\n#define EXCITER_MEM_SECTION\n#endif\n\n")
+    out.write("/*\n * Generated by tools/wav_to_exciters.py - don't edit\n")
+    out.write(" * %d transients at %g Hz:\n" % (len(transients), rate))
+    for i, (tname, x, root) in enumerate(transients):
+        pitch = "%g Hz" % root if root > 0 else "unpitched"
+        out.write(" *   %d %s, %d samples, %s\n" % (i, tname.replace("*/", "* /"), len(x), pitch))
+    out.write(" */\n\n")
+    out.write("// An exciter bank, attach with exciter_bank::Attach(%s, sizeof(%s))\n" % (name, name))
+    out.write("const uint32_t %s[%d] EXCITER_MEM_SECTION = {\n%s\n};\n" % (name, len(words), ",\n".join(rows)))
+    out.write("#endif\n#endif\n")
+
+
+def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("wavs", nargs="*", help="transients, file.wav or file.wav@root_hz")
+    ap.add_argument("--name", default="exciter_blob", help="name of the header's array")
+    ap.add_argument("--bin", metavar="FILE", help="write the bank here instead of a header")
+    ap.add_argument("--synth", action="store_true", help="a demo bank instead of recordings")
+    ap.add_argument("--rate", type=float, default=48000, help="rate of the --synth bank")
+    args = ap.parse_args()
+
+    transients = []
+    rate = None
+    if args.synth:
+        rate = args.rate
+        transients = synth(rate)
+    for spec in args.wavs:
+        path, _, root = spec.partition("@")
+        src, x = read_wav(path)
+        if rate is None:
+            rate = src
+        x = trim(resample(x, src, rate))
+        if not x:
+            sys.exit("%s is silent" % path)
+        transients.append((path.split("/")[-1], x, float(root) if root else 0.0))
+    if not transients:
+        sys.exit("no transients, give some WAVs or --synth")
+    if len(transients) > MAX_TRANSIENTS:
+        sys.exit("at most %d transients" % MAX_TRANSIENTS)
+
+    blob = pack(rate, transients)
+    sys.stderr.write("%d transients, %d samples, %d bytes\n"
+                     % (len(transients), sum(len(x) for _, x, _ in transients), len(blob)))
+    if args.bin:
+        with open(args.bin, "wb") as f:
+            f.write(blob)
+        return
+    write_header(sys.stdout, args.name, rate, transients, blob)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,130 @@
+#pragma once
+#ifndef DSY_TRACE_RING_H
+#define DSY_TRACE_RING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <atomic>
+#ifdef __cplusplus
+
+#ifndef __arm__
+#include <chrono>
+#endif
+
+namespace daisysp
+{
+/** trace_ring
+ *
+ * Fixed size, lock-free event trace for post-mortem debugging of the engine.
+ * Each event is 8 bytes: a 32 bit cycle timestamp, an event type and two small arguments.
+ * Writers from the audio callback and the main loop reserve slots with a single atomic
+ * increment so recording costs a handful of cycles and never blocks.
+ * The ring overwrites itself - it always holds the last N events.
+ *
+ * N must be a power of 2.
+ *
+ * Use tools/trace2chrome.py to turn a dump into Chrome/Perfetto trace JSON.
+ */
+typedef enum {
+  TRACE_CB_START = 0,	// audio callback entry, b = block size
+  TRACE_CB_END,		// audio callback exit
+  TRACE_NOTE_ON,	// MIDI note on, a = note, b = voice
+  TRACE_PING,		// note excitation reaches the audio thread, b = voice
+  TRACE_CC,		// MIDI CC, a = control number, b = value
+  TRACE_PRESET,		// inharmonic preset load, a = preset
+  TRACE_STEAL,		// note on landed on a voice that was already sounding, b = voice
+  TRACE_RECALC,		// coefficient recompute, a = trace_param, b = voice
+  TRACE_GOVERN,		// the CPU governor stepped, a = level, b = load in thousandths
+  TRACE_LAST
+} trace_event;
+
+typedef enum {
+  TRACE_P_FC = 0, TRACE_P_R, TRACE_P_G, TRACE_P_STIFF, TRACE_P_BETA, TRACE_P_MGF, TRACE_P_IFC, TRACE_P_LAST
+} trace_param;
+
+typedef struct {
+  uint32_t ts;
+  uint8_t  type;
+  uint8_t  a;
+  uint16_t b;
+} trace_entry;
+
+template <size_t N>
+class trace_ring
+{
+  static_assert((N & (N - 1)) == 0, "trace_ring size must be a power of 2");
+
+  public:
+    trace_ring() {}
+    ~trace_ring() {}
+
+    void Init()
+    {
+#ifdef __arm__
+      // Enable the DWT cycle counter
+      CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+      DWT->CYCCNT = 0;
+      DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+      head_.store(0, std::memory_order_relaxed);
+      enabled_ = true;
+    }
+
+    inline void Record(uint8_t type, uint8_t a = 0, uint16_t b = 0)
+    {
+      if (!enabled_) return;
+      uint32_t idx = head_.fetch_add(1, std::memory_order_relaxed);
+      trace_entry &e = buf_[idx & (N - 1)];
+      e.ts = Cycles();
+      e.type = type;
+      e.a = a;
+      e.b = b;
+    }
+
+    // Stop recording so the ring can be read out without being overwritten
+    void Freeze() { enabled_ = false; }
+    void Thaw()   { enabled_ = true; }
+
+    // Number of valid entries
+    size_t Count()
+    {
+      uint32_t head = head_.load(std::memory_order_relaxed);
+      return head < N ? head : N;
+    }
+
+    // i = 0 is the oldest entry still in the ring
+    const trace_entry &At(size_t i)
+    {
+      uint32_t head = head_.load(std::memory_order_relaxed);
+      uint32_t first = head < N ? 0 : head - N;
+      return buf_[(first + i) & (N - 1)];
+    }
+
+    static inline uint32_t Cycles()
+    {
+#ifdef __arm__
+      return DWT->CYCCNT;
+#else
+      return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+	       std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+    }
+
+    // Timestamp units per second
+    static inline uint32_t CyclesPerSecond()
+    {
+#ifdef __arm__
+      return SystemCoreClock;
+#else
+      return 1000000000;
+#endif
+    }
+
+  private:
+    trace_entry buf_[N];
+    std::atomic<uint32_t> head_{0};
+    volatile bool enabled_ = false;
+};
+} // namespace daisysp
+#endif
+#endif
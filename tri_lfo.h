@@ -25,6 +25,7 @@ class tri_lfo
       depth_ = 0.f;
       range_ = 0.f;
       out_ = 0.f;
+      freq_ = 0.f;
       SetFreq(.3);
     }
 
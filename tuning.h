@@ -0,0 +1,128 @@
+#pragma once
+#ifndef DSY_TUNING_H
+#define DSY_TUNING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <atomic>
+#include "arm_math.h"
+#ifdef __cplusplus
+
+#define TUNING_NOTES	  128
+// Notes a pitch_table rebuilds per Service call
+#define PITCH_CHUNK	  16
+
+namespace daisysp
+{
+/*
+ * A note-on's worth of mode frequencies for one voice type, see the voices' save_pitch and load_pitch.
+ * key is what the mode frequencies depended on besides the fundamental (stiffness, beta, the
+ * mode set...) as the voice reports it with pitch_key. n_set modes get new frequencies,
+ * the voice is left with n_modes.
+ */
+template <int M>
+struct pitch_entry
+{
+  uint32_t key[3];
+  float fc;
+  int n_set, n_modes;
+  float mode_fc[M];
+  float cos_wc[M];
+};
+
+/*
+ * pitch_table
+ *
+ * Every MIDI note's pitch_entry for one voice type, so a note-on copies coefficients
+ * instead of running pow, sqrt and cos for every mode.
+ *
+ * The main loop fills it with Service, a chunk of notes at a time, from one voice of the type.
+ * Whenever that voice's pitch_key or the tuning moves the table starts again from the bottom.
+ * On the audio side Load takes an entry only if it was finished, is for the same frequency
+ * and matches the key of the voice being played, otherwise the voice computes its own.
+ * Entries are marked unfinished while they are written so a note-on in between skips them.
+ *
+ * V needs pitch_key, save_pitch and load_pitch.
+ */
+template <int M>
+class pitch_table
+{
+  public:
+    void Init()
+    {
+      for (int n = 0; n < TUNING_NOTES; n++) {
+	ready_[n].store(false);
+      }
+      next_ = 0;
+      memset(built_key_, 0, sizeof(built_key_));
+      built_freqs_ = nullptr;
+    }
+
+    // Audio side. True if voice has taken note's entry
+    template <typename V>
+    bool Load(V &voice, int note, float fc) const
+    {
+      uint32_t key[3];
+      voice.pitch_key(key);
+      const pitch_entry<M> *e = Find(note, fc, key);
+      if (!e) return false;
+      voice.load_pitch(*e);
+      return true;
+    }
+
+    // Audio side. note's entry if it's finished, for fc and made with key, otherwise null
+    const pitch_entry<M> *Find(int note, float fc, const uint32_t *key) const
+    {
+      if (!ready_[note].load(std::memory_order_acquire)) return nullptr;
+      const pitch_entry<M> &e = entries_[note];
+      if (e.fc != fc || memcmp(key, e.key, sizeof(e.key))) return nullptr;
+      return &e;
+    }
+
+    /*
+     * Main loop side. Fill up to budget notes of freqs from voice, true while there's work left
+     * freqs must stay valid, a new array starts the table again
+     */
+    template <typename V>
+    bool Service(const V &voice, const float *freqs, int budget = PITCH_CHUNK)
+    {
+      uint32_t key[3];
+      voice.pitch_key(key);
+      if (freqs != built_freqs_ || memcmp(key, built_key_, sizeof(key))) {
+	memcpy(built_key_, key, sizeof(key));
+	built_freqs_ = freqs;
+	next_ = 0;
+      }
+      for (int k = 0; k < budget && next_ < TUNING_NOTES; k++) {
+	pitch_entry<M> e;
+	voice.save_pitch(freqs[next_], e);
+	// The audio side moved something while the entry was worked out
+	voice.pitch_key(key);
+	if (memcmp(e.key, built_key_, sizeof(key)) || memcmp(key, built_key_, sizeof(key))) return true;
+	ready_[next_].store(false, std::memory_order_release);
+	entries_[next_] = e;
+	ready_[next_].store(true, std::memory_order_release);
+	next_++;
+      }
+      return next_ < TUNING_NOTES;
+    }
+
+  private:
+    pitch_entry<M> entries_[TUNING_NOTES];
+    std::atomic<bool> ready_[TUNING_NOTES];
+    int next_;
+    uint32_t built_key_[3];
+    const float *built_freqs_;
+};
+
+// A float's bits, for pitch keys
+inline uint32_t pitch_bits(float x)
+{
+  uint32_t u;
+  memcpy(&u, &x, sizeof(u));
+  return u;
+}
+} // namespace daisysp
+#endif
+#endif
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef DSY_TUNING_SCALE_H
+#define DSY_TUNING_SCALE_H
+
+#include "tuning.h"
+
+#ifdef __cplusplus
+
+/*
+ * Generated by tools/scl_to_tuning.py from ji_12.scl - don't edit
+ * 12 tone 5-limit just intonation, on C
+ * 128 mapped notes, 8.25 to 12672.00 Hz
+ */
+
+// Hz for each MIDI note, 0 for unmapped keys
+const float tuning_scale[TUNING_NOTES] = {
+  8.25, 8.8, 9.28125, 9.9, 10.3125, 11, 11.6015625, 12.375,
+  13.2, 13.75, 14.85, 15.46875, 16.5, 17.6, 18.5625, 19.8,
+  20.625, 22, 23.203125, 24.75, 26.4, 27.5, 29.7, 30.9375,
+  33, 35.2, 37.125, 39.6, 41.25, 44, 46.40625, 49.5,
+  52.8, 55, 59.4, 61.875, 66, 70.4, 74.25, 79.2,
+  82.5, 88, 92.8125, 99, 105.6, 110, 118.8, 123.75,
+  132, 140.8, 148.5, 158.4, 165, 176, 185.625, 198,
+  211.2, 220, 237.6, 247.5, 264, 281.6, 297, 316.8,
+  330, 352, 371.25, 396, 422.4, 440, 475.2, 495,
+  528, 563.2, 594, 633.6, 660, 704, 742.5, 792,
+  844.8, 880, 950.4, 990, 1056, 1126.4, 1188, 1267.2,
+  1320, 1408, 1485, 1584, 1689.6, 1760, 1900.8, 1980,
+  2112, 2252.8, 2376, 2534.4, 2640, 2816, 2970, 3168,
+  3379.2, 3520, 3801.6, 3960, 4224, 4505.6, 4752, 5068.8,
+  5280, 5632, 5940, 6336, 6758.4, 7040, 7603.2, 7920,
+  8448, 9011.2, 9504, 10137.6, 10560, 11264, 11880, 12672
+};
+#endif
+#endif
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef DSY_WAVESHAPER_H
+#define DSY_WAVESHAPER_H
+
+#include <math.h>
+#ifdef __cplusplus
+
+// For distortion models
+#define INV_ARCTAN_1 1.273239544735163f
+#define INV_TANH_1   1.313035285499331f
+
+#define SGN(x)		    (signbit(x) ? -1.0 : 1.0)
+
+namespace daisysp
+{
+typedef enum {NONE = 0, EXP_DIST, TANH, ARCTAN, LAST_OUTPUT} ui_output_mode;
+
+/*
+ * Output stage distortion models
+ * no effort made here to avoid aliasing due to harmonics introduced by waveshaping/clipping
+ */
+inline float waveshape(float in, ui_output_mode mode)
+{
+  float out = in;
+  switch(mode) {
+    case NONE:
+      break;
+    case EXP_DIST:
+      out = SGN(in) * (1 - expf(-fabsf(in))); // Holy distortion Batman - what's going on here?
+      break;
+    case TANH:
+      out = tanhf(in) * INV_TANH_1;
+      break;
+    case ARCTAN:
+      out = atanf(in) * INV_ARCTAN_1;
+      break;
+    default:
+      break;
+  }
+  return out;
+}
+} // namespace daisysp
+#endif
+#endif